@@ -0,0 +1,188 @@
+#include <rgbd/rgbd.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+
+// Compares writing a record through the IOCallbacks of libebml and the ones of librgbd.
+// Reports throughput, the number of IOCallback::write calls made by libebml,
+// and the number of write syscalls from /proc/self/io on Linux.
+namespace rgbd
+{
+constexpr int BENCHMARK_DURATION_SEC{20};
+constexpr int IMU_FRAME_RATE{100};
+constexpr size_t COLOR_FRAME_SIZE{40 * 1024};
+constexpr size_t DEPTH_FRAME_SIZE{20 * 1024};
+
+// Forwards calls to another IOCallback and counts them.
+class CountingIOCallback : public libebml::IOCallback
+{
+public:
+    CountingIOCallback(libebml::IOCallback& io_callback)
+        : io_callback_{io_callback}
+        , write_count_{0}
+        , seek_count_{0}
+    {
+    }
+    uint32_t read(void* buffer, size_t size) override
+    {
+        return io_callback_.read(buffer, size);
+    }
+    void setFilePointer(int64_t offset, libebml::seek_mode mode = libebml::seek_beginning) override
+    {
+        ++seek_count_;
+        io_callback_.setFilePointer(offset, mode);
+    }
+    size_t write(const void* buffer, size_t size) override
+    {
+        ++write_count_;
+        return io_callback_.write(buffer, size);
+    }
+    uint64_t getFilePointer() override
+    {
+        return io_callback_.getFilePointer();
+    }
+    void close() override
+    {
+        io_callback_.close();
+    }
+    uint64_t write_count() const noexcept
+    {
+        return write_count_;
+    }
+    uint64_t seek_count() const noexcept
+    {
+        return seek_count_;
+    }
+
+private:
+    libebml::IOCallback& io_callback_;
+    uint64_t write_count_;
+    uint64_t seek_count_;
+};
+
+// Returns -1 when not available.
+int64_t get_write_syscall_count()
+{
+#ifdef CMAKE_RGBD_OS_LINUX
+    std::ifstream proc_io{"/proc/self/io"};
+    string key;
+    int64_t value;
+    while (proc_io >> key >> value) {
+        if (key == "syscw:")
+            return value;
+    }
+#endif
+    return -1;
+}
+
+struct BenchmarkFrames
+{
+    vector<RecordVideoFrame> video_frames;
+    vector<RecordIMUFrame> imu_frames;
+};
+
+BenchmarkFrames create_benchmark_frames()
+{
+    std::mt19937 generator{0};
+    std::uniform_int_distribution<int> distribution{0, 255};
+    auto random_bytes{[&](size_t size) {
+        Bytes bytes(size);
+        for (auto& byte : bytes)
+            byte = gsl::narrow<uint8_t>(distribution(generator));
+        return bytes;
+    }};
+
+    BenchmarkFrames frames;
+    for (int i{0}; i < BENCHMARK_DURATION_SEC * VIDEO_FRAME_RATE; ++i) {
+        int64_t time_point_us{i * ONE_SECOND_US / VIDEO_FRAME_RATE};
+        frames.video_frames.emplace_back(time_point_us,
+                                         i % VIDEO_FRAME_RATE == 0,
+                                         random_bytes(COLOR_FRAME_SIZE),
+                                         random_bytes(DEPTH_FRAME_SIZE));
+    }
+    for (int i{0}; i < BENCHMARK_DURATION_SEC * IMU_FRAME_RATE; ++i) {
+        int64_t time_point_us{i * ONE_SECOND_US / IMU_FRAME_RATE};
+        frames.imu_frames.emplace_back(
+            time_point_us, glm::vec3{1.0f}, glm::vec3{2.0f}, glm::vec3{3.0f}, glm::vec3{4.0f});
+    }
+    return frames;
+}
+
+void write_frames(libebml::IOCallback& io_callback, const BenchmarkFrames& frames)
+{
+    RecordWriter writer{io_callback,
+                        AUDIO_SAMPLE_RATE,
+                        DepthCodecType::RVL,
+                        DEFAULT_DEPTH_UNIT,
+                        UndistortedCameraCalibration{640, 480, 640, 480, 0.5f, 0.5f, 0.5f, 0.5f},
+                        std::nullopt};
+    size_t imu_frame_index{0};
+    for (auto& video_frame : frames.video_frames) {
+        while (imu_frame_index < frames.imu_frames.size() &&
+               frames.imu_frames[imu_frame_index].time_point_us() <= video_frame.time_point_us()) {
+            writer.writeIMUFrame(frames.imu_frames[imu_frame_index]);
+            ++imu_frame_index;
+        }
+        writer.writeVideoFrame(video_frame);
+    }
+    writer.flush();
+}
+
+void run_benchmark(const string& name,
+                   const BenchmarkFrames& frames,
+                   const std::function<unique_ptr<libebml::IOCallback>()>& create_io_callback)
+{
+    auto io_callback{create_io_callback()};
+    CountingIOCallback counting_io_callback{*io_callback};
+
+    int64_t syscall_count_before{get_write_syscall_count()};
+    auto start{std::chrono::steady_clock::now()};
+    write_frames(counting_io_callback, frames);
+    // Destroying the IOCallback is part of writing since it may close the file.
+    io_callback.reset();
+    auto end{std::chrono::steady_clock::now()};
+    int64_t syscall_count_after{get_write_syscall_count()};
+
+    uint64_t byte_size{0};
+    for (auto& video_frame : frames.video_frames)
+        byte_size += video_frame.color_bytes().size() + video_frame.depth_bytes().size();
+    double seconds{std::chrono::duration<double>(end - start).count()};
+    string syscall_count{syscall_count_before < 0
+                             ? string{"n/a"}
+                             : std::to_string(syscall_count_after - syscall_count_before)};
+    spdlog::info("{}: {:.3f} s, {:.1f} MB/s, IOCallback writes: {}, seeks: {}, write syscalls: {}",
+                 name,
+                 seconds,
+                 byte_size / seconds / (1024.0 * 1024.0),
+                 counting_io_callback.write_count(),
+                 counting_io_callback.seek_count(),
+                 syscall_count);
+}
+
+void run()
+{
+    auto frames{create_benchmark_frames()};
+    auto file_path{
+        (std::filesystem::temp_directory_path() / "rgbd_record_write_benchmark.mkv").string()};
+
+    run_benchmark("StdIOCallback", frames, [&] {
+        return std::make_unique<StdIOCallback>(file_path.c_str(), MODE_CREATE);
+    });
+    run_benchmark("BufferedFileIOCallback", frames, [&] {
+        return std::make_unique<BufferedFileIOCallback>(file_path);
+    });
+    run_benchmark("MemIOCallback", frames, [] { return std::make_unique<MemIOCallback>(); });
+    run_benchmark(
+        "ChunkedMemIOCallback", frames, [] { return std::make_unique<ChunkedMemIOCallback>(); });
+
+    std::filesystem::remove(file_path);
+}
+} // namespace rgbd
+
+int main()
+{
+    rgbd::run();
+    return 0;
+}
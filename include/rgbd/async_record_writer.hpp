@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "record_writer.hpp"
+
+namespace rgbd
+{
+// What AsyncRecordWriter does with a new frame when its queue is full.
+enum class AsyncRecordWriterOverflowPolicy
+{
+    // Waits until the writer thread makes room, slowing down the caller.
+    Block = 0,
+    // Drops the oldest queued frame. When it is a video frame, the following video frames are
+    // also dropped until the next keyframe since they cannot be decoded without it.
+    DropOldest = 1,
+};
+
+struct AsyncRecordWriterStats
+{
+    size_t queue_size{0};
+    size_t peak_queue_size{0};
+    uint64_t written_frame_count{0};
+    uint64_t dropped_frame_count{0};
+    // Time from a write*Frame() call to the frame getting written by RecordWriter.
+    int64_t last_latency_us{0};
+    int64_t max_latency_us{0};
+};
+
+// Runs RecordWriter in a thread of its own, so slow writes to the IOCallback do not stall the
+// thread calling write*Frame() (e.g., a capture thread).
+// Frames are moved into a queue of at most max_queue_size frames. Copies of a RecordFrame share
+// their payloads, so queueing does not copy the frame data.
+// io_callback is used by the writer thread until flush() returns.
+class AsyncRecordWriter
+{
+public:
+    AsyncRecordWriter(IOCallback& io_callback,
+                      int sample_rate,
+                      DepthCodecType depth_codec_type,
+                      float depth_unit,
+                      const CameraCalibration& calibration,
+                      const optional<Bytes>& cover_png_bytes,
+                      size_t max_queue_size,
+                      AsyncRecordWriterOverflowPolicy overflow_policy,
+                      const RecordWriterClusterPolicy& cluster_policy = {});
+    // Frames not written before the destruction are discarded. Call flush() to keep them.
+    ~AsyncRecordWriter();
+    AsyncRecordWriter(const AsyncRecordWriter&) = delete;
+    AsyncRecordWriter& operator=(const AsyncRecordWriter&) = delete;
+    // Rethrows the exception if the writer thread failed to write.
+    void writeVideoFrame(RecordVideoFrame video_frame);
+    void writeAudioFrame(RecordAudioFrame audio_frame);
+    void writeIMUFrame(RecordIMUFrame imu_frame);
+    void writePoseFrame(RecordPoseFrame pose_frame);
+    void writeCalibrationFrame(RecordCalibrationFrame calibration_frame);
+    // Waits for the queued frames to get written, stops the writer thread,
+    // then flushes RecordWriter. No frame can be written after this.
+    void flush();
+    AsyncRecordWriterStats getStats();
+
+private:
+    struct QueuedFrame
+    {
+        unique_ptr<RecordFrame> frame;
+        std::chrono::steady_clock::time_point enqueue_time;
+    };
+
+    void enqueue(unique_ptr<RecordFrame> frame);
+    void runWriter();
+    void writeFrame(RecordFrame& frame);
+
+private:
+    RecordWriter record_writer_;
+    size_t max_queue_size_;
+    AsyncRecordWriterOverflowPolicy overflow_policy_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_variable_;
+    // Guarded by mutex_.
+    std::deque<QueuedFrame> queue_;
+    // Set when a video frame gets dropped, so the writer thread skips video frames depending on
+    // the dropped one.
+    bool skipping_until_keyframe_;
+    AsyncRecordWriterStats stats_;
+    std::exception_ptr writer_exception_;
+    bool stopping_;
+    bool flushed_;
+
+    std::thread writer_thread_;
+};
+} // namespace rgbd
@@ -11,8 +11,8 @@ public:
     vector<float> decode(span<const uint8_t> opus_frame);
 
 private:
-    AVCodecParserContextHandle codec_parser_context_;
     AVCodecContextHandle codec_context_;
+    AVPacketBuffer packet_buffer_;
     AVPacketHandle packet_;
 };
 } // namespace rgbd
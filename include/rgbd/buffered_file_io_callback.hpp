@@ -0,0 +1,76 @@
+#pragma once
+
+#pragma warning(push)
+#pragma warning(disable : 4245 4267 4828 6387 26495 26812)
+#include <ebml/IOCallback.h>
+#pragma warning(pop)
+
+#include "constants.hpp"
+
+namespace rgbd
+{
+// Writes to the file get flushed at multiples of this when written sequentially.
+constexpr size_t FILE_WRITE_ALIGNMENT{4096};
+constexpr size_t DEFAULT_FILE_WRITE_BUFFER_SIZE{4 * 1024 * 1024};
+
+// When BufferedFileIOCallback makes sure the written bytes reach the disk
+// (i.e., fdatasync on Linux).
+enum class FileSyncPolicy
+{
+    // Leaves it to the OS.
+    None = 0,
+    OnClose = 1,
+    // After every write of the buffer to the file.
+    OnFlush = 2
+};
+
+// Write-only IOCallback for the output of RecordWriter.
+// libebml renders each element with several small writes. This collects them in a large buffer
+// and writes the buffer at its file offset (i.e., pwrite), so both writes and seeks cost no
+// syscall until the buffer fills up or the file pointer moves away from the buffered bytes.
+class BufferedFileIOCallback : public libebml::IOCallback
+{
+public:
+    // preallocation_size reserves disk space up front (i.e., fallocate) to reduce fragmentation
+    // of long recordings. It is a hint and does not change the size of the file.
+    BufferedFileIOCallback(const string& file_path,
+                           size_t buffer_size = DEFAULT_FILE_WRITE_BUFFER_SIZE,
+                           FileSyncPolicy sync_policy = FileSyncPolicy::None,
+                           uint64_t preallocation_size = 0);
+    ~BufferedFileIOCallback();
+    BufferedFileIOCallback(const BufferedFileIOCallback&) = delete;
+    BufferedFileIOCallback& operator=(const BufferedFileIOCallback&) = delete;
+    uint32_t read(void* buffer, size_t size) override;
+    void setFilePointer(int64_t offset, libebml::seek_mode mode = libebml::seek_beginning) override;
+    size_t write(const void* buffer, size_t size) override;
+    uint64_t getFilePointer() override;
+    void close() override;
+    // Writes the buffered bytes to the file.
+    void flush();
+    // Number of writes to the file, which is the number of write syscalls on POSIX.
+    uint64_t file_write_count() const noexcept
+    {
+        return file_write_count_;
+    }
+
+private:
+    void writeToFile(const uint8_t* data, size_t size, uint64_t offset);
+    void sync();
+
+private:
+    Bytes buffer_;
+    size_t buffer_used_;
+    // Offset in the file of the first byte of buffer_.
+    uint64_t buffer_offset_;
+    uint64_t position_;
+    uint64_t file_size_;
+    FileSyncPolicy sync_policy_;
+    uint64_t file_write_count_;
+    bool closed_;
+#ifdef CMAKE_RGBD_OS_WINDOWS
+    void* file_handle_;
+#else
+    int fd_;
+#endif
+};
+} // namespace rgbd
@@ -24,4 +24,10 @@ template <class T> T read_from_bytes(span<const uint8_t> bytes, int& cursor)
     cursor += sizeof(T);
     return t;
 }
+
+template <class T> void write_to_bytes(span<uint8_t> bytes, int& cursor, const T& t)
+{
+    memcpy(&bytes[cursor], &t, sizeof(T));
+    cursor += sizeof(T);
+}
 } // namespace rgbd
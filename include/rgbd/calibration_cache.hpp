@@ -0,0 +1,27 @@
+#pragma once
+
+#include "camera_calibration.hpp"
+
+namespace rgbd
+{
+// Per-pixel tables of calibrations, computed across threads and memoized for the process.
+// Computing them takes seconds for KinectCameraCalibration, which unprojects each pixel
+// iteratively, so opening another file from the same device should not pay that again.
+// Tables are keyed by the JSON of the calibrations, so equal calibrations share them.
+// Only the most recently used tables stay memoized, bounding the memory of the cache.
+// Thread-safe.
+namespace calibration_cache
+{
+// The direction of each pixel of a width x height frame.
+shared_ptr<const vector<glm::vec3>>
+get_directions(const CameraCalibration& calibration, int width, int height);
+// For each pixel of a from_width x from_height frame of from_calibration,
+// the uv of to_calibration looking toward the same direction.
+shared_ptr<const vector<glm::vec2>> get_uvs(const CameraCalibration& from_calibration,
+                                            int from_width,
+                                            int from_height,
+                                            const CameraCalibration& to_calibration);
+// Drops all memoized tables. Tables still in use stay alive until released.
+void clear() noexcept;
+} // namespace calibration_cache
+} // namespace rgbd
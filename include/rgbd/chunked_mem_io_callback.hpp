@@ -0,0 +1,39 @@
+#pragma once
+
+#pragma warning(push)
+#pragma warning(disable : 4245 4267 4828 6387 26495 26812)
+#include <ebml/IOCallback.h>
+#pragma warning(pop)
+
+#include "constants.hpp"
+
+namespace rgbd
+{
+constexpr size_t DEFAULT_MEMORY_CHUNK_SIZE{1024 * 1024};
+
+// In-memory IOCallback that grows by adding fixed-size chunks.
+// Unlike libebml::MemIOCallback, which reallocates and copies its whole buffer as it grows,
+// written bytes never move, so the cost of writing stays linear in the size of the output.
+class ChunkedMemIOCallback : public libebml::IOCallback
+{
+public:
+    ChunkedMemIOCallback(size_t chunk_size = DEFAULT_MEMORY_CHUNK_SIZE);
+    uint32_t read(void* buffer, size_t size) override;
+    void setFilePointer(int64_t offset, libebml::seek_mode mode = libebml::seek_beginning) override;
+    size_t write(const void* buffer, size_t size) override;
+    uint64_t getFilePointer() override;
+    void close() override;
+    uint64_t size() const noexcept
+    {
+        return size_;
+    }
+    // Copies the written bytes into a contiguous buffer.
+    Bytes toBytes() const;
+
+private:
+    size_t chunk_size_;
+    vector<unique_ptr<uint8_t[]>> chunks_;
+    uint64_t position_;
+    uint64_t size_;
+};
+} // namespace rgbd
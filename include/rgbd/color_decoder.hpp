@@ -1,18 +1,33 @@
 #pragma once
 
-#include "yuv_frame.hpp"
+#include "yuv_frame_pool.hpp"
 
 namespace rgbd
 {
+struct ColorDecoderOptions
+{
+    // The number of threads libavcodec uses for slice threading. Frame threading is not used
+    // since it delays output by a frame per thread while decode() returns the frame of its input.
+    int thread_count{1};
+};
+
 class ColorDecoder
 {
 public:
-    ColorDecoder(ColorCodecType type);
+    ColorDecoder(ColorCodecType type, const ColorDecoderOptions& options = ColorDecoderOptions{});
     unique_ptr<YuvFrame> decode(span<const uint8_t> vp8_frame);
+    // Same as above, but takes the output frame from pool. Release the frame back to pool
+    // when done with it to avoid allocations in the next calls.
+    unique_ptr<YuvFrame> decode(span<const uint8_t> vp8_frame, YuvFramePool& pool);
+    // Overwrites yuv_frame, reusing the memory of its channels.
+    void decodeInto(span<const uint8_t> vp8_frame, YuvFrame& yuv_frame);
+
+private:
+    AVFrameHandle decodeToAVFrame(span<const uint8_t> vp8_frame);
 
 private:
-    AVCodecParserContextHandle codec_parser_context_;
     AVCodecContextHandle codec_context_;
+    AVPacketBuffer packet_buffer_;
     AVPacketHandle packet_;
 };
 } // namespace rgbd
@@ -4,11 +4,60 @@
 
 namespace rgbd
 {
+enum class ColorRateControlMode : int32_t
+{
+    // Constant bitrate, for live streaming.
+    CBR = 0,
+    // Variable bitrate averaging target_bitrate_kbps.
+    VBR = 1,
+    // Constant quality at cq_level, with target_bitrate_kbps as the upper bound.
+    CQ = 2
+};
+
+struct ColorEncoderOptions
+{
+    ColorRateControlMode rate_control_mode{ColorRateControlMode::CBR};
+    // The number of threads libvpx uses.
+    int thread_count{4};
+    // libvpx's deadline: "realtime", "good", or "best".
+    string deadline{"realtime"};
+    // libvpx's cpu-used. Higher values trade quality for speed.
+    int cpu_used{4};
+    // When 0, the bitrate gets picked from the resolution.
+    int target_bitrate_kbps{0};
+    // The quality level (0-63, lower is better) for ColorRateControlMode::CQ.
+    int cq_level{10};
+    // The maximum number of frames between keyframes.
+    // When 0, keyframes happen only when requested in encode(). Otherwise, libvpx also places
+    // keyframes on its own, which ColorEncoder::last_keyframe() reports.
+    int keyframe_interval{0};
+};
+
 class ColorEncoder
 {
 public:
-    ColorEncoder(ColorCodecType type, int width, int height);
-    Bytes encode(const YuvFrame& yuv_image, bool keyframe);
+    ColorEncoder(ColorCodecType type,
+                 int width,
+                 int height,
+                 const ColorEncoderOptions& options = ColorEncoderOptions{});
+    // When time_point_us is given, libvpx derives the frame rate from it.
+    // Otherwise, frames are assumed to be VIDEO_FRAME_RATE apart.
+    // Throws when time_point_us is not after the time point of the previous frame.
+    Bytes encode(const YuvFrame& yuv_image,
+                 bool keyframe,
+                 optional<int64_t> time_point_us = std::nullopt);
+    // Encodes I420 planes in caller-owned memory, where each stride is the number of bytes
+    // between the starts of two rows. This skips building a YuvFrame.
+    // y_data should hold height rows of width bytes, and u_data and v_data should each hold
+    // height / 2 rows of width / 2 bytes. Throws when a stride is shorter than its row.
+    Bytes encodePlanes(const uint8_t* y_data,
+                       int y_stride,
+                       const uint8_t* u_data,
+                       int u_stride,
+                       const uint8_t* v_data,
+                       int v_stride,
+                       bool keyframe,
+                       optional<int64_t> time_point_us = std::nullopt);
     AVCodecContextHandle& codec_context()
     {
         return codec_context_;
@@ -17,6 +66,12 @@ public:
     {
         return next_pts_;
     }
+    // Whether the frame last returned by encode() or encodePlanes() is a keyframe,
+    // including ones not requested by the caller.
+    bool last_keyframe() const noexcept
+    {
+        return last_keyframe_;
+    }
 
 private:
     static vector<AVPacketHandle> encodeVideoFrame(AVCodecContext* codec_context, AVFrame* frame);
@@ -25,5 +80,7 @@ private:
     AVCodecContextHandle codec_context_;
     AVFrameHandle frame_;
     int64_t next_pts_;
+    int64_t last_pts_;
+    bool last_keyframe_;
 };
 } // namespace rgbd
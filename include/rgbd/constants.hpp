@@ -57,7 +57,8 @@ enum class ColorCodecType : int32_t
 enum class DepthCodecType : int32_t
 {
     RVL = 0,
-    TDC1 = 1
+    TDC1 = 1,
+    RVL_MT = 2
 };
 
 constexpr int VIDEO_FRAME_RATE{30};
@@ -100,6 +101,7 @@ constexpr int DEFAULT_AUDIO_RING_BUFFER_SIZE{AUDIO_SAMPLE_RATE * AUDIO_INPUT_CHA
 /////////////////////// FILE CONSTANTS //////////////////////
 /////////////////////////////////////////////////////////////
 constexpr int64_t ONE_SECOND_NS{1000 * 1000 * 1000}; // in ns
+constexpr int64_t ONE_SECOND_US{1000 * 1000};        // in us
 constexpr int64_t ONE_MICROSECOND_NS{1000};          // in ns
 constexpr int MATROSKA_TIMESCALE_NS{ONE_MICROSECOND_NS};
 } // namespace rgbd
\ No newline at end of file
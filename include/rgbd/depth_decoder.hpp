@@ -8,14 +8,21 @@ class DepthDecoderImpl
 {
 public:
     virtual ~DepthDecoderImpl() {}
-    virtual unique_ptr<Int32Frame> decode(span<const uint8_t> bytes) noexcept = 0;
+    virtual unique_ptr<Int32Frame> decode(span<const uint8_t> bytes) = 0;
+    // Decodes into output, which should have width * height elements,
+    // without allocating memory except for the first frame.
+    virtual void decodeInto(span<const uint8_t> bytes, span<int32_t> output) = 0;
 };
 
 class DepthDecoder
 {
 public:
     DepthDecoder(DepthCodecType depth_codec_type);
-    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes) noexcept;
+    // Throws when the codec detects invalid bytes (e.g., a truncated RVL-MT header).
+    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes);
+    void decodeInto(span<const uint8_t> bytes, span<int32_t> output);
+    // Decodes the frames in order, each into its own bytes_list.size()-th slice of output.
+    void decodeBatchInto(const vector<span<const uint8_t>>& bytes_list, span<int32_t> output);
 
 private:
     unique_ptr<DepthDecoderImpl> impl_;
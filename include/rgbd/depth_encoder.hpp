@@ -9,7 +9,11 @@ class DepthEncoderImpl
 public:
     virtual ~DepthEncoderImpl() {}
     virtual DepthCodecType getCodecType() noexcept = 0;
-    virtual Bytes encode(const int32_t* depth_values, bool keyframe) noexcept = 0;
+    virtual size_t getMaxEncodedSize() noexcept = 0;
+    // Writes into output, which should have at least getMaxEncodedSize() bytes,
+    // and returns the number of written bytes.
+    virtual size_t
+    encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output) noexcept = 0;
 };
 
 class DepthEncoder
@@ -17,9 +21,36 @@ class DepthEncoder
 public:
     DepthEncoder(DepthCodecType type, int width, int height);
     DepthCodecType getCodecType() noexcept;
+    int width() const noexcept
+    {
+        return width_;
+    }
+    int height() const noexcept
+    {
+        return height_;
+    }
     Bytes encode(const int32_t* depth_values, bool keyframe) noexcept;
+    size_t getMaxEncodedSize() noexcept;
+    // Encodes into a caller-owned buffer and returns the number of written bytes.
+    // Throws when output is smaller than getMaxEncodedSize().
+    size_t encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output);
+    // Same as above, but grows output when it is too small. Reusing output across frames
+    // avoids allocating memory per frame. Bytes after the returned size are left unspecified.
+    size_t encodeInto(const int32_t* depth_values, bool keyframe, Bytes& output) noexcept;
+    // Encodes keyframes.size() frames of width * height values stored back to back
+    // in depth_values.
+    vector<Bytes> encodeBatch(const int32_t* depth_values, const vector<bool>& keyframes) noexcept;
+    // Writes the encoded frames back to back into output, which should have at least
+    // keyframes.size() * getMaxEncodedSize() bytes, and the size of each frame into
+    // encoded_sizes. Returns the total number of written bytes.
+    size_t encodeBatchInto(const int32_t* depth_values,
+                           const vector<bool>& keyframes,
+                           span<uint8_t> output,
+                           span<size_t> encoded_sizes);
 
 private:
     unique_ptr<DepthEncoderImpl> impl_;
+    int width_;
+    int height_;
 };
 } // namespace rgbd
@@ -23,12 +23,13 @@ public:
     }
     const vector<glm::vec3>& directions() const noexcept
     {
-        return directions_;
+        return *directions_;
     }
 
 private:
     int width_;
     int height_;
-    vector<glm::vec3> directions_;
+    // Shared with calibration_cache and other tables of the same calibration.
+    shared_ptr<const vector<glm::vec3>> directions_;
 };
 } // namespace rgbd
@@ -2,6 +2,7 @@
 
 #include "constants.hpp"
 
+class AVBufferRef;
 class AVCodec;
 class AVCodecContext;
 class AVCodecParserContext;
@@ -81,4 +82,19 @@ public:
 private:
     std::unique_ptr<AVCodecParserContext, std::function<void(AVCodecParserContext*)>> unique_ptr_;
 };
+
+// A grow-only buffer for sending a whole compressed frame (e.g., a Matroska block) to a decoder
+// as a single packet, without a parser. Packets reference this buffer, so the decoder does not
+// copy their data again.
+class AVPacketBuffer
+{
+public:
+    AVPacketBuffer();
+    // Copies data into the buffer followed by the zeroed padding that FFmpeg requires,
+    // then makes packet reference it.
+    void fillPacket(span<const uint8_t> data, AVPacket* packet);
+
+private:
+    unique_ptr<AVBufferRef, std::function<void(AVBufferRef*)>> unique_ptr_;
+};
 } // namespace rgbd
@@ -6,21 +6,57 @@
 
 namespace rgbd
 {
+enum class FrameMapperSamplingMode : int32_t
+{
+    // Takes the closest source pixel.
+    Nearest = 0,
+    // Blends the four closest source pixels. Only for color, since blending depth values
+    // across object boundaries creates points floating between the objects.
+    Bilinear = 1
+};
+
 class FrameMapper
 {
 public:
+    // The index of destination pixels without a source pixel.
+    static constexpr int32_t INVALID_INDEX{-1};
+    // Bilinear weights are fixed-point numbers with this many fractional bits.
+    static constexpr int BILINEAR_WEIGHT_BITS{8};
+
+    // For each destination pixel, the index of the top-left source pixel of the four to blend,
+    // and how far the destination pixel is toward the right and bottom ones.
+    struct BilinearSample
+    {
+        int32_t index;
+        uint16_t x_weight;
+        uint16_t y_weight;
+    };
+
     FrameMapper(const rgbd::CameraCalibration& src_calibration,
-                const rgbd::CameraCalibration& dst_calibration);
+                const rgbd::CameraCalibration& dst_calibration,
+                FrameMapperSamplingMode sampling_mode = FrameMapperSamplingMode::Nearest);
+    // These throw when the frame to map is not of the size in src_calibration.
     unique_ptr<YuvFrame> mapColorFrame(const YuvFrame& yuv_frame);
     unique_ptr<Int32Frame> mapDepthFrame(const Int32Frame& depth_frame);
+    // Same as above, but write into frames of the destination size,
+    // so mapping a stream of frames can reuse them.
+    void mapColorFrameInto(const YuvFrame& yuv_frame, YuvFrame& mapped_yuv_frame);
+    void mapDepthFrameInto(const Int32Frame& depth_frame, Int32Frame& mapped_depth_frame);
 
 private:
+    FrameMapperSamplingMode sampling_mode_;
+    int src_color_width_;
+    int src_color_height_;
+    int src_depth_width_;
+    int src_depth_height_;
     int dst_color_width_;
     int dst_color_height_;
     int dst_depth_width_;
     int dst_depth_height_;
-    vector<optional<int>> y_index_map_;
-    vector<optional<int>> uv_index_map_;
-    vector<optional<int>> depth_index_map_;
+    vector<int32_t> y_index_map_;
+    vector<int32_t> uv_index_map_;
+    vector<int32_t> depth_index_map_;
+    vector<BilinearSample> y_bilinear_map_;
+    vector<BilinearSample> uv_bilinear_map_;
 };
 }
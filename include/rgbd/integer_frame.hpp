@@ -20,6 +20,13 @@ public:
     {
         Expects(values.size() == (width * height));
     }
+    IntegerFrame(int width, int height, vector<T>&& values)
+        : width_{width}
+        , height_{height}
+        , values_(std::move(values))
+    {
+        Expects(values_.size() == (width * height));
+    }
     unique_ptr<IntegerFrame> getDownsampled(int downsampling_factor) const
     {
         int downsampled_width{width_ / downsampling_factor};
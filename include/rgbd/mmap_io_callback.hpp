@@ -0,0 +1,67 @@
+#pragma once
+
+#pragma warning(push)
+#pragma warning(disable : 4245 4267 4828 6387 26495 26812)
+#include <ebml/IOCallback.h>
+#pragma warning(pop)
+
+#include "constants.hpp"
+
+namespace rgbd
+{
+// Hints for the kernel on how the mapped pages will be accessed (i.e., madvise).
+enum class MmapAdvice
+{
+    Normal = 0,
+    Sequential = 1,
+    Random = 2
+};
+
+// Read-only memory mapping of a whole file.
+class MmapFile
+{
+public:
+    MmapFile(const string& file_path);
+    ~MmapFile();
+    MmapFile(const MmapFile&) = delete;
+    MmapFile& operator=(const MmapFile&) = delete;
+    void advise(MmapAdvice advice) const noexcept;
+    const uint8_t* data() const noexcept
+    {
+        return data_;
+    }
+    size_t size() const noexcept
+    {
+        return size_;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#ifdef CMAKE_RGBD_OS_WINDOWS
+    void* file_handle_;
+    void* mapping_handle_;
+#endif
+};
+
+// Read-only IOCallback on top of MmapFile.
+// Reads are memcpy from the mapping, so there is no syscall per read or seek.
+class MmapIOCallback : public libebml::IOCallback
+{
+public:
+    MmapIOCallback(shared_ptr<const MmapFile> file);
+    uint32_t read(void* buffer, size_t size) override;
+    void setFilePointer(int64_t offset, libebml::seek_mode mode = libebml::seek_beginning) override;
+    size_t write(const void* buffer, size_t size) override;
+    uint64_t getFilePointer() override;
+    void close() override;
+    const shared_ptr<const MmapFile>& file() const noexcept
+    {
+        return file_;
+    }
+
+private:
+    shared_ptr<const MmapFile> file_;
+    uint64_t position_;
+};
+} // namespace rgbd
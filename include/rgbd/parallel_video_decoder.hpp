@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "color_decoder.hpp"
+#include "depth_decoder.hpp"
+#include "record.hpp"
+#include "video_frame.hpp"
+
+namespace rgbd
+{
+// Decodes RecordVideoFrames into VideoFrames using multiple threads.
+// Since each GOP starts with a keyframe, GOPs are decoded independently by workers, each with its
+// own ColorDecoder and DepthDecoder. Decoded frames are returned by next() in the order of the
+// input frames. Workers stay at most max_buffered_gops GOPs ahead of the caller of next(), which
+// bounds the memory used for decoded frames.
+class ParallelVideoDecoder
+{
+public:
+    ParallelVideoDecoder(ColorCodecType color_codec_type,
+                         DepthCodecType depth_codec_type,
+                         const vector<RecordVideoFrame>& video_frames,
+                         int thread_count,
+                         int max_buffered_gops);
+    ~ParallelVideoDecoder();
+    ParallelVideoDecoder(const ParallelVideoDecoder&) = delete;
+    ParallelVideoDecoder& operator=(const ParallelVideoDecoder&) = delete;
+    // Returns nullptr after returning all frames.
+    // Rethrows the exception if a worker failed to decode.
+    unique_ptr<VideoFrame> next();
+
+private:
+    void runWorker();
+
+private:
+    ColorCodecType color_codec_type_;
+    DepthCodecType depth_codec_type_;
+    // Copies of RecordVideoFrame share their payloads, so this does not copy the frame data.
+    vector<RecordVideoFrame> video_frames_;
+    // Index of the first frame of each GOP. The end of the last GOP is video_frames_.size().
+    vector<size_t> gop_starts_;
+    int max_buffered_gops_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_variable_;
+    // Guarded by mutex_.
+    size_t next_gop_to_decode_;
+    size_t next_gop_to_deliver_;
+    std::map<size_t, std::deque<unique_ptr<VideoFrame>>> decoded_gops_;
+    std::exception_ptr worker_exception_;
+    bool stopping_;
+
+    vector<std::thread> workers_;
+};
+} // namespace rgbd
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <functional>
+#include "direction_table.hpp"
+#include "integer_frame.hpp"
+#include "yuv_frame.hpp"
+
+namespace rgbd
+{
+// Unprojects depth frames into points by scaling the directions of a DirectionTable.
+// Outputs are in the structure-of-arrays layout (all x, then all y, then all z),
+// with one point per depth pixel, so pixels without depth become the origin.
+class PointCloudBuilder
+{
+public:
+    // Splits frames into thread_count bands of rows that run on ThreadPool::shared().
+    PointCloudBuilder(const DirectionTable& direction_table, float depth_unit, int thread_count);
+    // Also precomputes where each depth pixel samples from color frames of the given size,
+    // for buildColors().
+    PointCloudBuilder(const DirectionTable& direction_table,
+                      float depth_unit,
+                      int color_width,
+                      int color_height,
+                      int thread_count);
+    int width() const noexcept
+    {
+        return width_;
+    }
+    int height() const noexcept
+    {
+        return height_;
+    }
+    size_t point_count() const noexcept
+    {
+        return direction_xs_.size();
+    }
+    // Writes the positions into positions, which should have point_count() * 3 elements.
+    void buildPositions(const Int32Frame& depth_frame, span<float> positions) const;
+    // Writes the RGB colors of the points into colors, which should have
+    // point_count() * 3 elements, as all r, then all g, then all b.
+    void buildColors(const YuvFrame& yuv_frame, span<uint8_t> colors) const;
+
+private:
+    void forEachBand(const std::function<void(size_t, size_t)>& function) const;
+
+private:
+    int width_;
+    int height_;
+    int thread_count_;
+    // Directions multiplied by depth_unit, so a position is only one multiplication away.
+    vector<float> direction_xs_;
+    vector<float> direction_ys_;
+    vector<float> direction_zs_;
+    int color_width_;
+    int color_height_;
+    vector<int32_t> y_index_map_;
+    vector<int32_t> uv_index_map_;
+};
+} // namespace rgbd
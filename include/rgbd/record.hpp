@@ -16,6 +16,7 @@
 #include <matroska/KaxBlockData.h>
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxContexts.h>
+#include <matroska/KaxCues.h>
 #include <matroska/KaxCuesData.h>
 #include <matroska/KaxInfoData.h>
 #include <matroska/KaxSeekHead.h>
@@ -73,6 +74,9 @@ struct RecordTracks
     RecordColorVideoTrack color_track;
     RecordDepthVideoTrack depth_track;
     RecordAudioTrack audio_track;
+    // Track with blocks of IMU samples. Files written before the IMU track have one track for
+    // each of acceleration, rotation_rate, magnetic_field, and gravity instead.
+    optional<int> imu_track_number;
     optional<int> acceleration_track_number;
     optional<int> rotation_rate_track_number;
     optional<int> magnetic_field_track_number;
@@ -98,6 +102,43 @@ enum class RecordFrameType
     Calibration = 4,
 };
 
+// Payload of a frame. Either owns a copy of its bytes or views bytes kept alive by owner
+// (e.g., the input buffer of RecordParser). Copies of a payload share the same memory.
+class RecordPayload
+{
+public:
+    RecordPayload()
+        : bytes_{}
+        , owner_{}
+    {
+    }
+    RecordPayload(const Bytes& bytes)
+        : RecordPayload{Bytes{bytes}}
+    {
+    }
+    RecordPayload(Bytes&& bytes)
+        : bytes_{}
+        , owner_{}
+    {
+        auto owned_bytes{std::make_shared<const Bytes>(std::move(bytes))};
+        bytes_ = span<const uint8_t>{*owned_bytes};
+        owner_ = std::move(owned_bytes);
+    }
+    RecordPayload(span<const uint8_t> bytes, shared_ptr<const void> owner)
+        : bytes_{bytes}
+        , owner_{std::move(owner)}
+    {
+    }
+    span<const uint8_t> bytes() const noexcept
+    {
+        return bytes_;
+    }
+
+private:
+    span<const uint8_t> bytes_;
+    shared_ptr<const void> owner_;
+};
+
 class RecordFrame
 {
 public:
@@ -114,8 +155,18 @@ public:
                      const Bytes& depth_bytes)
         : time_point_us_{time_point_us}
         , keyframe_{keyframe}
-        , color_bytes_{color_bytes}
-        , depth_bytes_{depth_bytes}
+        , color_payload_{color_bytes}
+        , depth_payload_{depth_bytes}
+    {
+    }
+    RecordVideoFrame(int64_t time_point_us,
+                     bool keyframe,
+                     const RecordPayload& color_payload,
+                     const RecordPayload& depth_payload)
+        : time_point_us_{time_point_us}
+        , keyframe_{keyframe}
+        , color_payload_{color_payload}
+        , depth_payload_{depth_payload}
     {
     }
     RecordFrameType getType()
@@ -130,20 +181,28 @@ public:
     {
         return keyframe_;
     }
-    const Bytes& color_bytes() const noexcept
+    span<const uint8_t> color_bytes() const noexcept
     {
-        return color_bytes_;
+        return color_payload_.bytes();
     }
-    const Bytes& depth_bytes() const noexcept
+    span<const uint8_t> depth_bytes() const noexcept
     {
-        return depth_bytes_;
+        return depth_payload_.bytes();
+    }
+    const RecordPayload& color_payload() const noexcept
+    {
+        return color_payload_;
+    }
+    const RecordPayload& depth_payload() const noexcept
+    {
+        return depth_payload_;
     }
 
 private:
     int64_t time_point_us_;
     bool keyframe_;
-    Bytes color_bytes_;
-    Bytes depth_bytes_;
+    RecordPayload color_payload_;
+    RecordPayload depth_payload_;
 };
 
 class RecordAudioFrame : public RecordFrame
@@ -152,7 +211,13 @@ public:
     RecordAudioFrame(int64_t time_point_us,
                      const Bytes& bytes)
         : time_point_us_{time_point_us}
-        , bytes_{bytes}
+        , payload_{bytes}
+    {
+    }
+    RecordAudioFrame(int64_t time_point_us,
+                     const RecordPayload& payload)
+        : time_point_us_{time_point_us}
+        , payload_{payload}
     {
     }
     RecordFrameType getType()
@@ -163,14 +228,18 @@ public:
     {
         return time_point_us_;
     }
-    const Bytes& bytes() const noexcept
+    span<const uint8_t> bytes() const noexcept
     {
-        return bytes_;
+        return payload_.bytes();
+    }
+    const RecordPayload& payload() const noexcept
+    {
+        return payload_;
     }
 
 private:
     int64_t time_point_us_;
-    Bytes bytes_;
+    RecordPayload payload_;
 };
 
 class RecordIMUFrame : public RecordFrame
@@ -221,6 +290,67 @@ private:
     glm::vec3 gravity_;
 };
 
+// Components of a glm::vec3 per sample, each in its own contiguous array.
+struct RecordVec3Array
+{
+    vector<float> x;
+    vector<float> y;
+    vector<float> z;
+};
+
+// IMU samples in a structure-of-arrays layout, which is also how the IMU track stores the samples
+// of a block. Lets samples of a whole record get processed without going through RecordIMUFrames.
+struct RecordIMUSamples
+{
+    vector<int64_t> time_points_us;
+    RecordVec3Array acceleration;
+    RecordVec3Array rotation_rate;
+    RecordVec3Array magnetic_field;
+    RecordVec3Array gravity;
+
+    size_t size() const noexcept
+    {
+        return time_points_us.size();
+    }
+    bool empty() const noexcept
+    {
+        return time_points_us.empty();
+    }
+    void clear() noexcept
+    {
+        time_points_us.clear();
+        for (auto array : {&acceleration, &rotation_rate, &magnetic_field, &gravity}) {
+            array->x.clear();
+            array->y.clear();
+            array->z.clear();
+        }
+    }
+    void append(const RecordIMUFrame& imu_frame)
+    {
+        auto append_vec3{[](RecordVec3Array& array, const glm::vec3& v) {
+            array.x.push_back(v.x);
+            array.y.push_back(v.y);
+            array.z.push_back(v.z);
+        }};
+        time_points_us.push_back(imu_frame.time_point_us());
+        append_vec3(acceleration, imu_frame.acceleration());
+        append_vec3(rotation_rate, imu_frame.rotation_rate());
+        append_vec3(magnetic_field, imu_frame.magnetic_field());
+        append_vec3(gravity, imu_frame.gravity());
+    }
+    RecordIMUFrame getFrame(size_t index) const
+    {
+        auto get_vec3{[index](const RecordVec3Array& array) {
+            return glm::vec3{array.x[index], array.y[index], array.z[index]};
+        }};
+        return RecordIMUFrame{time_points_us[index],
+                              get_vec3(acceleration),
+                              get_vec3(rotation_rate),
+                              get_vec3(magnetic_field),
+                              get_vec3(gravity)};
+    }
+};
+
 class RecordPoseFrame : public RecordFrame
 {
 public:
@@ -1,10 +1,15 @@
 #pragma once
 
+#include <array>
+#include <deque>
 #include "record_writer.hpp"
 
 namespace rgbd
 {
 // RecordBuilder is to make using RecordWriter easier.
+// By default, frames are kept in memory until buildToBytes() or buildToPath().
+// After startStreaming(), frames are written while being added instead, and only frames within
+// the reordering window are kept in memory.
 class RecordBuilder
 {
 public:
@@ -14,6 +19,7 @@ public:
     void setDepthUnit(float depth_unit);
     void setCalibration(const CameraCalibration& calibration);
     void setCoverPNGBytes(const optional<Bytes>& cover_png_bytes);
+    void setClusterPolicy(const RecordWriterClusterPolicy& cluster_policy);
     void addVideoFrame(const RecordVideoFrame& video_frame);
     void addAudioFrame(const RecordAudioFrame& audio_frame);
     void addIMUFrame(const RecordIMUFrame& imu_frame);
@@ -21,9 +27,29 @@ public:
     void addCalibrationFrame(const RecordCalibrationFrame& calibration_frame);
     Bytes buildToBytes();
     void buildToPath(const std::string& path);
+    // Starts writing frames to io_callback as they get added. Set other properties before this.
+    // Frames are allowed to arrive out of order by up to reorder_window_us; a frame older than
+    // the frames already written gets dropped.
+    void startStreaming(IOCallback& io_callback, int64_t reorder_window_us);
+    void startStreamingToPath(const std::string& path, int64_t reorder_window_us);
+    // Writes the frames left in the reordering window and flushes the record.
+    void finishStreaming();
 
 private:
+    struct PendingFrame
+    {
+        int64_t time_point_us;
+        unique_ptr<RecordFrame> frame;
+    };
+
     void _build(IOCallback& io_callback);
+    // Throws when already streaming or when no calibration is set.
+    void checkStreamingStart() const;
+    void addStreamingFrame(int64_t time_point_us, unique_ptr<RecordFrame> frame);
+    // Writes frames older than the reordering window, or all frames when flushing,
+    // in the order of their time points.
+    void writePendingFrames(bool flushing);
+    void writeStreamingFrame(RecordFrame& frame);
 
 private:
     int sample_rate_;
@@ -31,10 +57,21 @@ private:
     float depth_unit_;
     unique_ptr<CameraCalibration> calibration_;
     optional<Bytes> cover_png_bytes_;
+    RecordWriterClusterPolicy cluster_policy_;
     vector<RecordVideoFrame> video_frames_;
     vector<RecordAudioFrame> audio_frames_;
     vector<RecordIMUFrame> imu_frames_;
     vector<RecordPoseFrame> pose_frames_;
     vector<RecordCalibrationFrame> calibration_frames_;
+
+    // Used only while streaming.
+    unique_ptr<IOCallback> streaming_io_callback_owner_;
+    unique_ptr<RecordWriter> streaming_writer_;
+    int64_t reorder_window_us_;
+    // A queue per RecordFrameType, indexed by the type and sorted by time point.
+    std::array<std::deque<PendingFrame>, 5> pending_frames_;
+    optional<int64_t> latest_time_point_us_;
+    optional<int64_t> last_written_time_point_us_;
+    optional<int64_t> initial_video_time_point_us_;
 };
 }
\ No newline at end of file
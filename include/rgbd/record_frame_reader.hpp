@@ -0,0 +1,43 @@
+#pragma once
+
+#include "record_parser.hpp"
+
+namespace rgbd
+{
+// Pull-based alternative to RecordParser::parse(true).
+// Each call to next() reads at most a single cluster and returns one of its frames, so memory
+// usage stays bounded by the size of a cluster instead of the size of the whole file.
+class RecordFrameReader
+{
+public:
+    RecordFrameReader(const void* ptr, size_t size);
+    RecordFrameReader(const string& file_path,
+                      RecordFileAccess file_access = RecordFileAccess::Read);
+    // Returns nullptr when there are no more frames.
+    unique_ptr<RecordFrame> next();
+    // Rewinds the reader to the first cluster.
+    void reset();
+    // Moves the reader to the last keyframe at or before time_point_us using Cues,
+    // and returns the time point of that keyframe, or of the first frame when there is none.
+    int64_t seekToTimePoint(int64_t time_point_us);
+    const RecordOffsets& offsets() const noexcept
+    {
+        return *parser_->file_offsets_;
+    }
+    const RecordInfo& info() const noexcept
+    {
+        return *parser_->file_info_;
+    }
+    const RecordTracks& tracks() const noexcept
+    {
+        return *parser_->file_tracks_;
+    }
+    const RecordAttachments& attachments() const noexcept
+    {
+        return *parser_->file_attachments_;
+    }
+
+private:
+    unique_ptr<RecordParser> parser_;
+};
+} // namespace rgbd
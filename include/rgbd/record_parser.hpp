@@ -1,26 +1,68 @@
 #pragma once
 
+#include <deque>
 #include "record.hpp"
 #include "ios_camera_calibration.hpp"
 #include "kinect_camera_calibration.hpp"
+#include "mmap_io_callback.hpp"
 
 namespace rgbd
 {
+// An entry of the in-memory index built from Cues.
+// Each entry points to a cluster with a keyframe of the color track.
+struct RecordCuePoint
+{
+    int64_t time_point_us;
+    int64_t cluster_offset;
+};
+
+// How RecordParser reads a file.
+// An enum instead of a bool so that a call with a string literal and a bool cannot pick the
+// constructor taking a pointer and a size.
+enum class RecordFileAccess
+{
+    // Reads through StdIOCallback.
+    Read = 0,
+    // Reads through MmapIOCallback, and parsed frames view into the mapping.
+    MemoryMap = 1
+};
 
 class RecordParser
 {
+    friend class RecordFrameReader;
+
 public:
+    // Frames parsed from ptr copy their payloads, so the memory of ptr only needs to be alive
+    // while the parser is in use.
     RecordParser(const void* ptr, size_t size);
-    RecordParser(const string& file_path);
+    // Frames parsed from ptr view into it without copying their payloads, and keep owner,
+    // which should keep the memory of ptr alive, so they can outlive the parser.
+    RecordParser(const void* ptr, size_t size, shared_ptr<const void> owner);
+    // With RecordFileAccess::MemoryMap, parsed frames view into the mapping like the above
+    // constructor with owner.
+    RecordParser(const string& file_path, RecordFileAccess file_access = RecordFileAccess::Read);
 
 private:
+    RecordParser(const string& file_path, shared_ptr<const MmapFile> mmap_file);
     void parseExceptClusters();
     optional<const RecordInfo> parseInfo(unique_ptr<libmatroska::KaxInfo>& kax_info);
     optional<const RecordOffsets> parseOffsets(unique_ptr<libmatroska::KaxSegment>& segment);
     optional<const RecordTracks> parseTracks(unique_ptr<libmatroska::KaxTracks>& tracks);
     optional<const RecordAttachments>
     parseAttachments(unique_ptr<libmatroska::KaxAttachments>& attachments);
-    RecordFrame* parseCluster(unique_ptr<libmatroska::KaxCluster>& cluster);
+    vector<RecordCuePoint> parseCues(unique_ptr<libmatroska::KaxCues>& cues);
+    vector<RecordCuePoint> scanCuePoints();
+    RecordPayload readPayload(libmatroska::KaxSimpleBlock& simple_block);
+    void readCluster(unique_ptr<libmatroska::KaxCluster>& cluster);
+    int64_t getTimePointUs(int64_t global_timecode);
+    // Returns the frames of a cluster in the order their last blocks appear in the cluster,
+    // except that IMU samples from the IMU track go in between them by their time points.
+    vector<unique_ptr<RecordFrame>> parseCluster(unique_ptr<libmatroska::KaxCluster>& cluster);
+    // Parses the cluster at the cursor into pending_frames_ and moves the cursor to the next
+    // cluster. Returns false when the cursor reaches the end of the file.
+    bool parseNextCluster();
+    unique_ptr<libmatroska::KaxCluster> findFirstCluster();
+    unique_ptr<libmatroska::KaxCluster> findNextCluster();
     void parseAllClusters(vector<RecordVideoFrame>& video_frames,
                           vector<RecordAudioFrame>& audio_frames,
                           vector<RecordIMUFrame>& imu_frames,
@@ -29,14 +71,38 @@ private:
 
 public:
     unique_ptr<Record> parse(bool with_frames);
+    // Returns the next frame, parsing the cluster at the cursor when the frames of the
+    // previously parsed cluster are used up. Returns nullptr at the end of the file.
+    unique_ptr<RecordFrame> parseNextFrame();
+    // Returns all IMU samples of the record, reading blocks of the IMU track straight into
+    // the arrays. Files with the legacy layout of four tracks are also supported.
+    RecordIMUSamples parseIMUSamples();
+    void seekToFirstCluster();
+    // Moves the cursor to the last keyframe at or before time_point_us and returns its time
+    // point. Frames from there to time_point_us are needed for decoding the frame at
+    // time_point_us. Before the first keyframe, moves the cursor to the first frame and
+    // returns its time point instead, or 0 without frames.
+    int64_t seekToTimePoint(int64_t time_point_us);
+    const vector<RecordCuePoint>& getCuePoints();
 
 private:
     unique_ptr<libebml::IOCallback> input_;
+    // Set only when frames can view into the input.
+    const uint8_t* input_data_;
+    size_t input_size_;
+    shared_ptr<const void> input_owner_;
+    // Set only when the input is a memory-mapped file.
+    shared_ptr<const MmapFile> mmap_file_;
     EbmlStream stream_;
     unique_ptr<libmatroska::KaxSegment> kax_segment_;
     optional<RecordOffsets> file_offsets_;
     optional<RecordInfo> file_info_;
     optional<RecordTracks> file_tracks_;
     optional<RecordAttachments> file_attachments_;
+    optional<int64_t> cues_offset_;
+    optional<vector<RecordCuePoint>> cue_points_;
+    optional<int64_t> next_cluster_offset_;
+    // Frames of the last parsed cluster not yet returned by parseNextFrame().
+    std::deque<unique_ptr<RecordFrame>> pending_frames_;
 };
 } // namespace rgbd
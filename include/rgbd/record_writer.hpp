@@ -38,6 +38,7 @@ struct RecordWriterTracks
     libmatroska::KaxTrackEntry* color_track{nullptr};
     libmatroska::KaxTrackEntry* depth_track{nullptr};
     libmatroska::KaxTrackEntry* audio_track{nullptr};
+    libmatroska::KaxTrackEntry* imu_track{nullptr};
     libmatroska::KaxTrackEntry* acceleration_track{nullptr};
     libmatroska::KaxTrackEntry* rotation_rate_track{nullptr};
     libmatroska::KaxTrackEntry* magnetic_field_track{nullptr};
@@ -47,6 +48,26 @@ struct RecordWriterTracks
     libmatroska::KaxTrackEntry* calibration_track{nullptr};
 };
 
+// Decides which frames share a cluster and how many IMU samples share a block.
+// Blocks of all tracks get interleaved into a cluster until one of the limits is reached.
+struct RecordWriterClusterPolicy
+{
+    // Relative timecodes of blocks are int16 in microseconds,
+    // so a cluster cannot be longer than 32767 us regardless of this value.
+    // Zero or below puts every frame into its own cluster, as RecordWriter used to do.
+    int64_t max_duration_us{32767};
+    size_t max_size_bytes{4 * 1024 * 1024};
+    // Starting clusters at video keyframes keeps Cues pointing at clusters
+    // that begin with a keyframe.
+    bool cluster_at_keyframes{true};
+    // IMU samples get packed into a block of the IMU track until there are this many of them
+    // or the cluster ends. Zero or below writes the legacy layout of four blocks per sample,
+    // one for each of acceleration, rotation_rate, magnetic_field, and gravity.
+    // Since a block does not outlast its cluster, max_duration_us bounds the size of blocks too,
+    // e.g., to 13 samples at 400 Hz; this limit only matters above about 500 Hz.
+    int imu_samples_per_block{16};
+};
+
 class RecordWriter
 {
 public:
@@ -55,14 +76,28 @@ public:
                  DepthCodecType depth_codec_type,
                  float depth_unit,
                  const CameraCalibration& calibration,
-                 const optional<Bytes>& cover_png_bytes);
+                 const optional<Bytes>& cover_png_bytes,
+                 const RecordWriterClusterPolicy& cluster_policy = RecordWriterClusterPolicy{});
     void writeVideoFrame(const RecordVideoFrame& video_frame);
     void writeAudioFrame(const RecordAudioFrame& audio_frame);
     void writeIMUFrame(const RecordIMUFrame& imu_frame);
     void writePoseFrame(const RecordPoseFrame& pose_frame);
     void writeCalibrationFrame(const RecordCalibrationFrame& calibration_frame);
+    // Renders the last cluster, then Cues and the rest of the header.
     void flush();
 
+private:
+    // Renders the current cluster when the frame to be added does not belong to it,
+    // then starts a new cluster if there is none.
+    void prepareCluster(uint64_t timecode, bool video_keyframe, size_t size);
+    libmatroska::KaxBlockBlob* addBlock(libmatroska::KaxTrackEntry& track,
+                                        uint64_t timecode,
+                                        span<const uint8_t> bytes,
+                                        const libmatroska::KaxBlockBlob* past_block_blob = nullptr);
+    // Adds pending_imu_samples_ to the current cluster as a block of the IMU track.
+    void writeIMUBlock();
+    void renderCluster();
+
 private:
     IOCallback& io_callback_;
     libmatroska::KaxSegment segment_;
@@ -72,5 +107,12 @@ private:
     libmatroska::KaxBlockBlob* past_color_block_blob_;
     libmatroska::KaxBlockBlob* past_depth_block_blob_;
     int64_t last_timecode_;
+    RecordWriterClusterPolicy cluster_policy_;
+    // Owned by segment_. nullptr when there is no cluster waiting to be rendered.
+    libmatroska::KaxCluster* cluster_;
+    uint64_t cluster_timecode_;
+    size_t cluster_size_;
+    // IMU samples not yet in a block. All of them belong to the current cluster.
+    RecordIMUSamples pending_imu_samples_;
 };
 } // namespace rgbd
@@ -1,11 +1,15 @@
 #pragma once
 
+#include <rgbd/async_record_writer.hpp>
 #include <rgbd/audio_decoder.hpp>
 #include <rgbd/audio_encoder.hpp>
 #include <rgbd/audio_frame.hpp>
+#include <rgbd/buffered_file_io_callback.hpp>
 #include <rgbd/byte_utils.hpp>
+#include <rgbd/calibration_cache.hpp>
 #include <rgbd/camera_calibration.hpp>
 #include <rgbd/capi_containers.hpp>
+#include <rgbd/chunked_mem_io_callback.hpp>
 #include <rgbd/color_decoder.hpp>
 #include <rgbd/color_encoder.hpp>
 #include <rgbd/constants.hpp>
@@ -20,17 +24,25 @@
 #include <rgbd/kinect_calibration_utils.hpp>
 #include <rgbd/kinect_camera_calibration.hpp>
 #include <rgbd/math_utils.hpp>
+#include <rgbd/mmap_io_callback.hpp>
+#include <rgbd/parallel_video_decoder.hpp>
 #include <rgbd/plane.hpp>
+#include <rgbd/point_cloud_builder.hpp>
 #include <rgbd/png_utils.hpp>
 #include <rgbd/record.hpp>
 #include <rgbd/record_builder.hpp>
+#include <rgbd/record_frame_reader.hpp>
 #include <rgbd/record_parser.hpp>
 #include <rgbd/record_writer.hpp>
 #include <rgbd/rvl.hpp>
+#include <rgbd/rvl_mt_decoder.hpp>
+#include <rgbd/rvl_mt_encoder.hpp>
 #include <rgbd/tdc1_decoder.hpp>
 #include <rgbd/tdc1_encoder.hpp>
+#include <rgbd/thread_pool.hpp>
 #include <rgbd/time.hpp>
 #include <rgbd/undistorted_camera_calibration.hpp>
 #include <rgbd/video_folder.hpp>
 #include <rgbd/video_frame.hpp>
 #include <rgbd/yuv_frame.hpp>
+#include <rgbd/yuv_frame_pool.hpp>
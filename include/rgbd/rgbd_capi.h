@@ -33,16 +33,33 @@ extern "C"
         RGBD_COLOR_CODEC_TYPE_VP8 = 0
     } rgbdColorCodecType;
 
+    typedef enum
+    {
+        RGBD_COLOR_RATE_CONTROL_MODE_CBR = 0,
+        RGBD_COLOR_RATE_CONTROL_MODE_VBR = 1,
+        RGBD_COLOR_RATE_CONTROL_MODE_CQ = 2
+    } rgbdColorRateControlMode;
+
+    typedef enum
+    {
+        RGBD_FRAME_MAPPER_SAMPLING_MODE_NEAREST = 0,
+        RGBD_FRAME_MAPPER_SAMPLING_MODE_BILINEAR = 1
+    } rgbdFrameMapperSamplingMode;
+
     typedef enum
     {
         RGBD_DEPTH_CODEC_TYPE_RVL = 0,
-        RGBD_DEPTH_CODEC_TYPE_TDC1 = 1
+        RGBD_DEPTH_CODEC_TYPE_TDC1 = 1,
+        RGBD_DEPTH_CODEC_TYPE_RVL_MT = 2
     } rgbdDepthCodecType;
 
     typedef enum
     {
         RGBD_RECORD_FRAME_TYPE_VIDEO = 0,
-        RGBD_RECORD_FRAME_TYPE_AUDIO = 1
+        RGBD_RECORD_FRAME_TYPE_AUDIO = 1,
+        RGBD_RECORD_FRAME_TYPE_IMU = 2,
+        RGBD_RECORD_FRAME_TYPE_POSE = 3,
+        RGBD_RECORD_FRAME_TYPE_CALIBRATION = 4
     } rgbdRecordFrameType;
     //////// END ENUMS ////////
 
@@ -142,24 +159,87 @@ extern "C"
 
     //////// START COLOR DECODER ////////
     RGBD_INTERFACE_EXPORT void* rgbd_color_decoder_ctor(rgbdColorCodecType type);
+    RGBD_INTERFACE_EXPORT void* rgbd_color_decoder_ctor_with_options(rgbdColorCodecType type,
+                                                                     void* options_ptr);
     RGBD_INTERFACE_EXPORT void rgbd_color_decoder_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void*
     rgbd_color_decoder_decode(void* ptr, const uint8_t* vp8_frame_data, size_t vp8_frame_size);
     //////// END COLOR DECODER ////////
 
+    //////// START COLOR DECODER OPTIONS ////////
+    RGBD_INTERFACE_EXPORT void* rgbd_color_decoder_options_ctor();
+    RGBD_INTERFACE_EXPORT void rgbd_color_decoder_options_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT int rgbd_color_decoder_options_get_thread_count(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_color_decoder_options_set_thread_count(void* ptr,
+                                                                           int thread_count);
+    //////// END COLOR DECODER OPTIONS ////////
+
     //////// START COLOR ENCODER ////////
     RGBD_INTERFACE_EXPORT void*
     rgbd_color_encoder_ctor(rgbdColorCodecType type, int width, int height);
+    RGBD_INTERFACE_EXPORT void* rgbd_color_encoder_ctor_with_options(rgbdColorCodecType type,
+                                                                     int width,
+                                                                     int height,
+                                                                     void* options_ptr);
     RGBD_INTERFACE_EXPORT void rgbd_color_encoder_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void*
     rgbd_color_encoder_encode(void* ptr, void* yuv_frame_ptr, bool keyframe);
-    //////// START COLOR ENCODER ////////
+    RGBD_INTERFACE_EXPORT void* rgbd_color_encoder_encode_with_time_point_us(
+        void* ptr, void* yuv_frame_ptr, bool keyframe, int64_t time_point_us);
+    RGBD_INTERFACE_EXPORT void* rgbd_color_encoder_encode_planes(void* ptr,
+                                                                 const uint8_t* y_data,
+                                                                 int y_stride,
+                                                                 const uint8_t* u_data,
+                                                                 int u_stride,
+                                                                 const uint8_t* v_data,
+                                                                 int v_stride,
+                                                                 bool keyframe);
+    RGBD_INTERFACE_EXPORT bool rgbd_color_encoder_get_last_keyframe(void* ptr);
+    //////// END COLOR ENCODER ////////
+
+    //////// START COLOR ENCODER OPTIONS ////////
+    RGBD_INTERFACE_EXPORT void* rgbd_color_encoder_options_ctor();
+    RGBD_INTERFACE_EXPORT void rgbd_color_encoder_options_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT rgbdColorRateControlMode
+    rgbd_color_encoder_options_get_rate_control_mode(void* ptr);
+    RGBD_INTERFACE_EXPORT void
+    rgbd_color_encoder_options_set_rate_control_mode(void* ptr,
+                                                     rgbdColorRateControlMode rate_control_mode);
+    RGBD_INTERFACE_EXPORT int rgbd_color_encoder_options_get_thread_count(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_color_encoder_options_set_thread_count(void* ptr,
+                                                                           int thread_count);
+    RGBD_INTERFACE_EXPORT void* rgbd_color_encoder_options_get_deadline(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_color_encoder_options_set_deadline(void* ptr,
+                                                                       const char* deadline);
+    RGBD_INTERFACE_EXPORT int rgbd_color_encoder_options_get_cpu_used(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_color_encoder_options_set_cpu_used(void* ptr, int cpu_used);
+    RGBD_INTERFACE_EXPORT int rgbd_color_encoder_options_get_target_bitrate_kbps(void* ptr);
+    RGBD_INTERFACE_EXPORT void
+    rgbd_color_encoder_options_set_target_bitrate_kbps(void* ptr, int target_bitrate_kbps);
+    RGBD_INTERFACE_EXPORT int rgbd_color_encoder_options_get_cq_level(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_color_encoder_options_set_cq_level(void* ptr, int cq_level);
+    RGBD_INTERFACE_EXPORT int rgbd_color_encoder_options_get_keyframe_interval(void* ptr);
+    RGBD_INTERFACE_EXPORT void
+    rgbd_color_encoder_options_set_keyframe_interval(void* ptr, int keyframe_interval);
+    //////// END COLOR ENCODER OPTIONS ////////
 
     //////// START DEPTH DECODER ////////
     RGBD_INTERFACE_EXPORT void* rgbd_depth_decoder_ctor(rgbdDepthCodecType depth_codec_type);
     RGBD_INTERFACE_EXPORT void rgbd_depth_decoder_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void*
     rgbd_depth_decoder_decode(void* ptr, const uint8_t* depth_bytes_data, size_t depth_bytes_size);
+    RGBD_INTERFACE_EXPORT int rgbd_depth_decoder_decode_into(void* ptr,
+                                                             const uint8_t* depth_bytes_data,
+                                                             size_t depth_bytes_size,
+                                                             int32_t* output,
+                                                             size_t output_size);
+    RGBD_INTERFACE_EXPORT int
+    rgbd_depth_decoder_decode_batch_into(void* ptr,
+                                         const uint8_t* depth_bytes_data,
+                                         const size_t* depth_bytes_sizes,
+                                         size_t frame_count,
+                                         int32_t* output,
+                                         size_t output_size);
     //////// END DEPTH DECODER ////////
 
     //////// START DEPTH ENCODER ////////
@@ -168,9 +248,24 @@ extern "C"
     RGBD_INTERFACE_EXPORT void rgbd_depth_encoder_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void*
     rgbd_depth_encoder_encode(void* ptr, const int32_t* depth_values, bool keyframe);
+    RGBD_INTERFACE_EXPORT size_t rgbd_depth_encoder_get_max_encoded_size(void* ptr);
+    RGBD_INTERFACE_EXPORT int64_t rgbd_depth_encoder_encode_into(void* ptr,
+                                                                 const int32_t* depth_values,
+                                                                 bool keyframe,
+                                                                 uint8_t* output,
+                                                                 size_t output_size);
+    RGBD_INTERFACE_EXPORT int64_t
+    rgbd_depth_encoder_encode_batch_into(void* ptr,
+                                         const int32_t* depth_values,
+                                         const bool* keyframes,
+                                         size_t frame_count,
+                                         uint8_t* output,
+                                         size_t output_size,
+                                         size_t* encoded_sizes);
     //////// END DEPTH DECODER ////////
 
     //////// START DIRECTION TABLE ////////
+    RGBD_INTERFACE_EXPORT void* rgbd_direction_table_ctor(void* calibration_ptr);
     RGBD_INTERFACE_EXPORT void rgbd_direction_table_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT int rgbd_direction_table_get_width(void* ptr);
     RGBD_INTERFACE_EXPORT int rgbd_direction_table_get_height(void* ptr);
@@ -222,11 +317,40 @@ extern "C"
     //////// START FRAME MAPPER ////////
     RGBD_INTERFACE_EXPORT void* rgbd_frame_mapper_ctor(void* src_calibration,
                                                        void* dst_calibration);
+    RGBD_INTERFACE_EXPORT void*
+    rgbd_frame_mapper_ctor_with_sampling_mode(void* src_calibration,
+                                              void* dst_calibration,
+                                              rgbdFrameMapperSamplingMode sampling_mode);
     RGBD_INTERFACE_EXPORT void rgbd_frame_mapper_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void* rgbd_frame_mapper_map_color_frame(void* ptr, void* color_frame);
     RGBD_INTERFACE_EXPORT void* rgbd_frame_mapper_map_depth_frame(void* ptr, void* depth_frame);
+    RGBD_INTERFACE_EXPORT int
+    rgbd_frame_mapper_map_color_frame_into(void* ptr, void* color_frame, void* mapped_color_frame);
+    RGBD_INTERFACE_EXPORT int
+    rgbd_frame_mapper_map_depth_frame_into(void* ptr, void* depth_frame, void* mapped_depth_frame);
     //////// END FRAME MAPPER ////////
 
+    //////// START POINT CLOUD BUILDER ////////
+    RGBD_INTERFACE_EXPORT void*
+    rgbd_point_cloud_builder_ctor(void* direction_table_ptr, float depth_unit, int thread_count);
+    RGBD_INTERFACE_EXPORT void*
+    rgbd_point_cloud_builder_ctor_with_color_size(void* direction_table_ptr,
+                                                  float depth_unit,
+                                                  int color_width,
+                                                  int color_height,
+                                                  int thread_count);
+    RGBD_INTERFACE_EXPORT void rgbd_point_cloud_builder_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT size_t rgbd_point_cloud_builder_get_point_count(void* ptr);
+    RGBD_INTERFACE_EXPORT int rgbd_point_cloud_builder_build_positions(void* ptr,
+                                                                       void* depth_frame_ptr,
+                                                                       float* positions,
+                                                                       size_t positions_size);
+    RGBD_INTERFACE_EXPORT int rgbd_point_cloud_builder_build_colors(void* ptr,
+                                                                    void* yuv_frame_ptr,
+                                                                    uint8_t* colors,
+                                                                    size_t colors_size);
+    //////// END POINT CLOUD BUILDER ////////
+
     //////// START KINECT CAMERA CALIBRATION ////////
     RGBD_INTERFACE_EXPORT void*
     rgbd_kinect_camera_calibration_ctor(int color_width,
@@ -328,6 +452,16 @@ extern "C"
                                                                      uint8_t* v_channel);
     //////// END MATH UTILS ////////
 
+    //////// START PARALLEL VIDEO DECODER ////////
+    RGBD_INTERFACE_EXPORT void* rgbd_parallel_video_decoder_ctor(rgbdColorCodecType color_codec_type,
+                                                                 rgbdDepthCodecType depth_codec_type,
+                                                                 void* record_ptr,
+                                                                 int thread_count,
+                                                                 int max_buffered_gops);
+    RGBD_INTERFACE_EXPORT void rgbd_parallel_video_decoder_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_parallel_video_decoder_next(void* ptr);
+    //////// END PARALLEL VIDEO DECODER ////////
+
     //////// START RECORD BUILDER ////////
     RGBD_INTERFACE_EXPORT void* rgbd_record_builder_ctor();
     RGBD_INTERFACE_EXPORT void rgbd_record_builder_dtor(void* ptr);
@@ -351,6 +485,9 @@ extern "C"
     rgbd_record_builder_add_calibration_frame(void* ptr, void* calibration_frame_ptr);
     RGBD_INTERFACE_EXPORT void* rgbd_record_builder_build_to_bytes(void* ptr);
     RGBD_INTERFACE_EXPORT void rgbd_record_builder_build_to_path(void* ptr, const char* path);
+    RGBD_INTERFACE_EXPORT int rgbd_record_builder_start_streaming_to_path(
+        void* ptr, const char* path, int64_t reorder_window_us);
+    RGBD_INTERFACE_EXPORT int rgbd_record_builder_finish_streaming(void* ptr);
     //////// END RECORD BUILDER ////////
 
     //////// START RECORD CALIBRATION FRAME ////////
@@ -377,6 +514,22 @@ extern "C"
     RGBD_INTERFACE_EXPORT rgbdRecordFrameType rgbd_record_frame_get_type(void* ptr);
     //////// END RECORD FRAME ////////
 
+    //////// START RECORD FRAME READER ////////
+    RGBD_INTERFACE_EXPORT int rgbd_record_frame_reader_ctor_from_data(void** reader_ptr_ref,
+                                                                      const void* data_ptr,
+                                                                      size_t data_size);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_ctor_from_path(const char* file_path);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_ctor_from_mmap(const char* file_path);
+    RGBD_INTERFACE_EXPORT void rgbd_record_frame_reader_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_get_info(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_get_tracks(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_get_attachments(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_frame_reader_next(void* ptr);
+    RGBD_INTERFACE_EXPORT void rgbd_record_frame_reader_reset(void* ptr);
+    RGBD_INTERFACE_EXPORT int64_t rgbd_record_frame_reader_seek_to_time_point(void* ptr,
+                                                                              int64_t time_point_us);
+    //////// END RECORD FRAME READER ////////
+
     //////// START RECORD IMU FRAME ////////
     RGBD_INTERFACE_EXPORT void* rgbd_record_imu_frame_ctor(int64_t time_point_us,
                                                            float acceleration_x,
@@ -420,6 +573,25 @@ extern "C"
     RGBD_INTERFACE_EXPORT float rgbd_record_imu_frame_get_gravity_z(void* ptr);
     //////// END RECORD IMU FRAME ////////
 
+    //////// START RECORD IMU SAMPLES ////////
+    // The arrays have rgbd_record_imu_samples_get_size() elements and live as long as ptr.
+    RGBD_INTERFACE_EXPORT void rgbd_record_imu_samples_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT size_t rgbd_record_imu_samples_get_size(void* ptr);
+    RGBD_INTERFACE_EXPORT const int64_t* rgbd_record_imu_samples_get_time_points_us(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_acceleration_xs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_acceleration_ys(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_acceleration_zs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_rotation_rate_xs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_rotation_rate_ys(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_rotation_rate_zs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_magnetic_field_xs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_magnetic_field_ys(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_magnetic_field_zs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_gravity_xs(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_gravity_ys(void* ptr);
+    RGBD_INTERFACE_EXPORT const float* rgbd_record_imu_samples_get_gravity_zs(void* ptr);
+    //////// END RECORD IMU SAMPLES ////////
+
     //////// START RECORD INFO ////////
     RGBD_INTERFACE_EXPORT void rgbd_record_info_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT uint64_t rgbd_record_info_get_timecode_scale_ns(void* ptr);
@@ -431,9 +603,14 @@ extern "C"
     RGBD_INTERFACE_EXPORT int
     rgbd_record_parser_ctor_from_data(void** parser_ptr_ref, const void* data_ptr, size_t data_size);
     RGBD_INTERFACE_EXPORT void* rgbd_record_parser_ctor_from_path(const char* file_path);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_parser_ctor_from_mmap(const char* file_path);
     RGBD_INTERFACE_EXPORT void rgbd_record_parser_dtor(void* ptr);
     RGBD_INTERFACE_EXPORT void*
     rgbd_record_parser_parse(void* ptr, bool with_frames);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_parser_parse_next_frame(void* ptr);
+    RGBD_INTERFACE_EXPORT int64_t rgbd_record_parser_seek_to_time_point(void* ptr,
+                                                                        int64_t time_point_us);
+    RGBD_INTERFACE_EXPORT void* rgbd_record_parser_parse_imu_samples(void* ptr);
     //////// END RECORD PARSER ////////
 
     //////// START RECORD POSE FRAME ////////
@@ -513,6 +690,14 @@ extern "C"
     RGBD_INTERFACE_EXPORT float rgbd_undistorted_camera_calibration_get_cy(void* ptr);
     //////// END UNDISTORTED CAMERA CALIBRATION ////////
 
+    //////// START VIDEO FRAME ////////
+    RGBD_INTERFACE_EXPORT void rgbd_video_frame_dtor(void* ptr);
+    RGBD_INTERFACE_EXPORT int64_t rgbd_video_frame_get_time_point_us(void* ptr);
+    RGBD_INTERFACE_EXPORT bool rgbd_video_frame_get_keyframe(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_video_frame_get_yuv_frame(void* ptr);
+    RGBD_INTERFACE_EXPORT void* rgbd_video_frame_get_depth_frame(void* ptr);
+    //////// END VIDEO FRAME ////////
+
     //////// START YUV FRAME ////////
     RGBD_INTERFACE_EXPORT void* rgbd_yuv_frame_ctor(int width,
                                                     int height,
@@ -4,6 +4,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "constants.hpp"
 
 // This algorithm is from
@@ -95,22 +101,276 @@ void DecompressRVL(char* input, T* output, int64_t numPixels)
 
 namespace rvl
 {
+// Reimplementation of wilson::EncodeVLE/DecodeVLE that produces and consumes the exact same
+// bitstream, but handles a whole value per step instead of a nibble per step.
+// Nibbles of a value are assembled or extracted with lookup tables, and the end of a value
+// inside a word is found by counting leading zeros of its continuation bits, which removes the
+// data-dependent branch per nibble of the original code.
+
+// Maps two nibbles of the stream (the earlier one in the upper half of the byte) into
+// their 6 bits of payload.
+extern const std::array<uint8_t, 256> NIBBLE_PAIR_TO_BITS;
+// Inverse of NIBBLE_PAIR_TO_BITS without continuation bits.
+extern const std::array<uint8_t, 64> BITS_TO_NIBBLE_PAIR;
+
+inline int count_leading_zeros(uint32_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return 31 - static_cast<int>(index);
+#else
+    return __builtin_clz(value);
+#endif
+}
+
+inline int count_leading_zeros(uint64_t value) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    const uint32_t high{static_cast<uint32_t>(value >> 32)};
+    if (high)
+        return count_leading_zeros(high);
+    return 32 + count_leading_zeros(static_cast<uint32_t>(value));
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+class NibbleWriter
+{
+public:
+    NibbleWriter(char* output) noexcept
+        : begin_{reinterpret_cast<uint32_t*>(output)}
+        , cursor_{reinterpret_cast<uint32_t*>(output)}
+        , pending_bits_{0}
+        , pending_nibble_count_{0}
+    {
+    }
+
+    void write(uint64_t value) noexcept
+    {
+        // Small values dominate depth images, so they skip the lookups.
+        if (value < 8) {
+            append(static_cast<uint32_t>(value), 1);
+            return;
+        }
+        if (value < 64) {
+            append(static_cast<uint32_t>(((value & 0x7) << 4) | 0x80 | (value >> 3)), 2);
+            return;
+        }
+        int nibble_count{value ? (64 - count_leading_zeros(value) + 2) / 3 : 1};
+        // Values longer than 8 nibbles only show up with large deltas of int32_t/int64_t.
+        while (nibble_count > 8) {
+            append(spread(value & 0xffffff) | 0x88888888u, 8);
+            value >>= 24;
+            nibble_count -= 8;
+        }
+        const uint32_t continuation_bits{(0x88888888u >> (32 - 4 * nibble_count)) & ~0x8u};
+        append((spread(value) >> (32 - 4 * nibble_count)) | continuation_bits, nibble_count);
+    }
+
+    // Flushes the last few nibbles and returns the number of written bytes.
+    size_t finish() noexcept
+    {
+        if (pending_nibble_count_) {
+            *cursor_++ = static_cast<uint32_t>(pending_bits_ << (4 * (8 - pending_nibble_count_)));
+            pending_bits_ = 0;
+            pending_nibble_count_ = 0;
+        }
+        return (cursor_ - begin_) * sizeof(uint32_t);
+    }
+
+private:
+    // Places up to 24 bits of value as 3-bit chunks into the nibbles of a word,
+    // the least significant chunk going into the most significant nibble.
+    static uint32_t spread(uint64_t value) noexcept
+    {
+        return (static_cast<uint32_t>(BITS_TO_NIBBLE_PAIR[value & 0x3f]) << 24) |
+               (static_cast<uint32_t>(BITS_TO_NIBBLE_PAIR[(value >> 6) & 0x3f]) << 16) |
+               (static_cast<uint32_t>(BITS_TO_NIBBLE_PAIR[(value >> 12) & 0x3f]) << 8) |
+               static_cast<uint32_t>(BITS_TO_NIBBLE_PAIR[(value >> 18) & 0x3f]);
+    }
+
+    void append(uint32_t nibbles, int nibble_count) noexcept
+    {
+        // pending_nibble_count_ < 8 and nibble_count <= 8, so this never overflows.
+        pending_bits_ = (pending_bits_ << (4 * nibble_count)) | nibbles;
+        pending_nibble_count_ += nibble_count;
+        if (pending_nibble_count_ >= 8) {
+            pending_nibble_count_ -= 8;
+            *cursor_++ = static_cast<uint32_t>(pending_bits_ >> (4 * pending_nibble_count_));
+            pending_bits_ &= (uint64_t{1} << (4 * pending_nibble_count_)) - 1;
+        }
+    }
+
+private:
+    uint32_t* begin_;
+    uint32_t* cursor_;
+    uint64_t pending_bits_;
+    int pending_nibble_count_;
+};
+
+class NibbleReader
+{
+public:
+    NibbleReader(const uint8_t* input) noexcept
+        : cursor_{reinterpret_cast<const uint32_t*>(input)}
+        , word_{0}
+        , nibble_count_{0}
+    {
+    }
+
+    int64_t read() noexcept
+    {
+        // Small values dominate depth images, so they skip the lookups.
+        if (nibble_count_ && !(word_ & 0x80000000u)) {
+            const int64_t value{word_ >> 28};
+            word_ <<= 4;
+            --nibble_count_;
+            return value;
+        }
+
+        int64_t value{0};
+        int shift{0};
+        for (;;) {
+            // Words are only loaded when needed, same as wilson::DecodeVLE,
+            // so this never reads past the end of the stream.
+            if (!nibble_count_) {
+                word_ = *cursor_++;
+                nibble_count_ = 8;
+            }
+            const uint32_t valid_bits{~0u << (32 - 4 * nibble_count_)};
+            const uint32_t stop_bits{~word_ & 0x88888888u & valid_bits};
+            if (stop_bits) {
+                const int nibble_count{count_leading_zeros(stop_bits) / 4 + 1};
+                if (nibble_count == 8) {
+                    value |= gather(word_) << shift;
+                    word_ = 0;
+                } else {
+                    value |= gather(word_ & ~(~0u >> (4 * nibble_count))) << shift;
+                    word_ <<= 4 * nibble_count;
+                }
+                nibble_count_ -= nibble_count;
+                return value;
+            }
+            value |= gather(word_ & valid_bits) << shift;
+            shift += 3 * nibble_count_;
+            nibble_count_ = 0;
+        }
+    }
+
+private:
+    // Inverse of NibbleWriter::spread() that ignores continuation bits.
+    static int64_t gather(uint32_t nibbles) noexcept
+    {
+        return static_cast<int64_t>(NIBBLE_PAIR_TO_BITS[nibbles >> 24]) |
+               (static_cast<int64_t>(NIBBLE_PAIR_TO_BITS[(nibbles >> 16) & 0xff]) << 6) |
+               (static_cast<int64_t>(NIBBLE_PAIR_TO_BITS[(nibbles >> 8) & 0xff]) << 12) |
+               (static_cast<int64_t>(NIBBLE_PAIR_TO_BITS[nibbles & 0xff]) << 18);
+    }
+
+private:
+    const uint32_t* cursor_;
+    uint32_t word_;
+    int nibble_count_;
+};
+
+// Upper bound of the compressed size.
+// Theoretically, if all input are non-zero and has a number that makes them
+// the longest in VLE encoding, it would be 24 bits for int16_t values
+// (since 16 bits can be turned into 6 3-bit chunks with a bit in front of each
+// chunk)
+// For int32_t, it would be 44 bits.
+// For int64_t, it would be 88 bits.
+// They all become less than 1.5 times longer than they originally were.
+// So multiplying 3 and dividing 2 below.
+// Two more words cover the counts of runs and the last few nibbles of tiny inputs.
+template <class T>
+size_t compress_bound(const size_t num_pixels) noexcept
+{
+    return num_pixels * 3 / 2 * sizeof(T) + 2 * sizeof(uint32_t);
+}
+
+// Compresses value_at(0), ..., value_at(count - 1) without materializing them.
+// value_at gets called up to twice per index while scanning runs of zeros and nonzeros,
+// so it should be cheap and free of side effects.
+// Bit-exact with wilson::CompressRVL.
+template <class T, class ValueAt>
+size_t compress_generated(const int64_t count, ValueAt value_at, char* output) noexcept
+{
+    NibbleWriter writer{output};
+    // Deltas wrap around in the promoted type of T, same as in wilson::CompressRVL.
+    using Delta = decltype(T{} - T{});
+    T previous{0};
+    int64_t cursor{0};
+    while (cursor != count) {
+        const int64_t zeros_begin{cursor};
+        while ((cursor != count) && !value_at(cursor))
+            ++cursor;
+        writer.write(static_cast<uint64_t>(cursor - zeros_begin));
+
+        const int64_t nonzeros_begin{cursor};
+        while ((cursor != count) && value_at(cursor))
+            ++cursor;
+        writer.write(static_cast<uint64_t>(cursor - nonzeros_begin));
+
+        for (int64_t i{nonzeros_begin}; i != cursor; ++i) {
+            const T current{value_at(i)};
+            const int64_t delta{
+                static_cast<Delta>(static_cast<int64_t>(current) - static_cast<int64_t>(previous))};
+            writer.write(static_cast<uint64_t>((delta << 1) ^ (delta >> 63)));
+            previous = current;
+        }
+    }
+    return writer.finish();
+}
+
+template <class T>
+size_t compress_to(const span<const T> input, char* output) noexcept
+{
+    const T* values{input.data()};
+    return compress_generated<T>(
+        gsl::narrow<int64_t>(input.size()), [values](int64_t i) { return values[i]; }, output);
+}
+
+// Bit-exact with wilson::DecompressRVL.
+// When ADD is true, decompressed values get added to output instead of overwriting it.
+template <class T, bool ADD = false>
+void decompress_to(const uint8_t* input, T* output, int64_t num_pixels) noexcept
+{
+    NibbleReader reader{input};
+    T previous{0};
+    while (num_pixels > 0) {
+        const int64_t zeros{reader.read()};
+        num_pixels -= zeros;
+        // Adding zeros is a no-op.
+        if (!ADD)
+            std::fill_n(output, zeros, T{0});
+        output += zeros;
+
+        int64_t nonzeros{reader.read()};
+        num_pixels -= nonzeros;
+        while (nonzeros) {
+            const int64_t positive{reader.read()};
+            const int64_t delta{(positive >> 1) ^ -(positive & 1)};
+            const T current{static_cast<T>(previous + delta)};
+            if (ADD) {
+                *output++ += current;
+            } else {
+                *output++ = current;
+            }
+            previous = current;
+            --nonzeros;
+        }
+    }
+}
+
 // Type T has to be signed, not unsigned, to work with TRVL.
 template <class T>
 Bytes compress(const span<const T> input) noexcept
 {
-    // Theoretically, if all input are non-zero and has a number that makes them
-    // the longest in VLE encoding, it would be 24 bits for int16_t values
-    // (since 16 bits can be turned into 6 3-bit chunks with a bit in front of each
-    // chunk)
-    // For int32_t, it would be 44 bits.
-    // For int64_t, it would be 88 bits.
-    // They all become less than 1.5 times longer than they originally were.
-    // So multiplying 3 and dividing 2 below.
-    Bytes output(gsl::narrow<size_t>(input.size() * 3 / 2 * sizeof(T)));
-    size_t size{wilson::CompressRVL(const_cast<T*>(input.data()),
-                                    reinterpret_cast<char*>(output.data()),
-                                    gsl::narrow<int64_t>(input.size()))};
+    Bytes output(gsl::narrow<size_t>(compress_bound<T>(input.size())));
+    size_t size{compress_to(input, reinterpret_cast<char*>(output.data()))};
     output.resize(size);
     output.shrink_to_fit();
     return output;
@@ -120,9 +380,23 @@ template <class T>
 vector<T> decompress(const span<const uint8_t> input, const int64_t num_pixels) noexcept
 {
     vector<T> output(num_pixels);
-    wilson::DecompressRVL(
-        reinterpret_cast<char*>(const_cast<uint8_t*>(input.data())), output.data(), num_pixels);
+    decompress_to(input.data(), output.data(), num_pixels);
     return output;
 }
+
+// Same as decompress(), but writes into output, which should have num_pixels elements.
+template <class T>
+void decompress_into(const span<const uint8_t> input, span<T> output) noexcept
+{
+    decompress_to(input.data(), output.data(), gsl::narrow<int64_t>(output.size()));
+}
+
+// Same as decompress_into(), but adds the decompressed values to output instead of overwriting.
+// This lets temporal codecs apply diffs without a temporary buffer.
+template <class T>
+void decompress_and_add(const span<const uint8_t> input, span<T> output) noexcept
+{
+    decompress_to<T, true>(input.data(), output.data(), gsl::narrow<int64_t>(output.size()));
+}
 } // namespace rvl
 } // namespace rgbd
@@ -8,6 +8,7 @@ class RVLDecoder : public DepthDecoderImpl
 {
 public:
     RVLDecoder() noexcept;
-    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes) noexcept;
+    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes);
+    void decodeInto(span<const uint8_t> bytes, span<int32_t> output);
 };
 }
\ No newline at end of file
@@ -9,7 +9,8 @@ class RVLEncoder : public DepthEncoderImpl
 public:
     RVLEncoder(int width, int height) noexcept;
     DepthCodecType getCodecType() noexcept;
-    Bytes encode(const int32_t* depth_values, bool keyframe) noexcept;
+    size_t getMaxEncodedSize() noexcept;
+    size_t encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output) noexcept;
 
 private:
     const int width_;
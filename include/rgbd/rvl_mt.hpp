@@ -0,0 +1,35 @@
+/**
+ * Copyright (c) 2020-2021, Hanseul Jun.
+ */
+
+#pragma once
+
+#include "thread_pool.hpp"
+
+// RVL-MT splits a depth frame into horizontal bands that get compressed with RVL independently,
+// so bands can be encoded and decoded on separate threads.
+// Layout: width (int32), height (int32), band count (int32), RVL byte size of each band
+// (int32 x band count), then the RVL bytes of the bands concatenated in order.
+namespace rgbd
+{
+namespace rvl_mt
+{
+constexpr int DEFAULT_BAND_COUNT{4};
+
+inline size_t get_header_size(int band_count) noexcept
+{
+    return sizeof(int32_t) * (3 + static_cast<size_t>(band_count));
+}
+
+inline int get_band_begin_row(int height, int band_count, int band_index) noexcept
+{
+    return gsl::narrow<int>(static_cast<int64_t>(height) * band_index / band_count);
+}
+
+// Runs function for each band on the threads of ThreadPool::shared().
+inline void for_each_band(int band_count, const std::function<void(int)>& function)
+{
+    ThreadPool::shared().forEach(band_count, function);
+}
+} // namespace rvl_mt
+} // namespace rgbd
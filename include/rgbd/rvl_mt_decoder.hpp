@@ -0,0 +1,21 @@
+#pragma once
+
+#include "depth_decoder.hpp"
+
+namespace rgbd
+{
+class RVLMTDecoder : public DepthDecoderImpl
+{
+public:
+    RVLMTDecoder() noexcept;
+    // Throws when the header of bytes is truncated or inconsistent.
+    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes);
+    void decodeInto(span<const uint8_t> bytes, span<int32_t> output);
+
+private:
+    // The offsets and sizes of the bands of the last frame,
+    // kept so decodeInto() does not allocate memory after the first frame.
+    vector<size_t> band_offsets_;
+    vector<size_t> band_sizes_;
+};
+} // namespace rgbd
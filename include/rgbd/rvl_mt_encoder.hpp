@@ -0,0 +1,27 @@
+#pragma once
+
+#include "depth_encoder.hpp"
+
+namespace rgbd
+{
+class RVLMTEncoder : public DepthEncoderImpl
+{
+public:
+    RVLMTEncoder(int width, int height, int band_count);
+    DepthCodecType getCodecType() noexcept;
+    size_t getMaxEncodedSize() noexcept;
+    size_t encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output) noexcept;
+
+private:
+    size_t getMaxBandSize(int band_index) noexcept;
+
+private:
+    const int width_;
+    const int height_;
+    const int band_count_;
+    // Where each band gets compressed in the output before packing, and its compressed size.
+    // Kept across frames, so encodeInto() does not allocate memory.
+    vector<size_t> band_offsets_;
+    vector<size_t> band_sizes_;
+};
+} // namespace rgbd
@@ -14,7 +14,11 @@ class TDC1Decoder : public DepthDecoderImpl
 {
 public:
     TDC1Decoder() noexcept;
-    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes) noexcept;
+    unique_ptr<Int32Frame> decode(span<const uint8_t> bytes);
+    void decodeInto(span<const uint8_t> bytes, span<int32_t> output);
+
+private:
+    void updatePreviousDepthValues(span<const uint8_t> bytes, int& width, int& height) noexcept;
 
 private:
     // Using int32_t to be compatible with the differences that can have
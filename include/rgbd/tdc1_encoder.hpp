@@ -9,7 +9,8 @@ class TDC1Encoder : public DepthEncoderImpl
 public:
     TDC1Encoder(int width, int height, int diff_multiplier) noexcept;
     DepthCodecType getCodecType() noexcept;
-    Bytes encode(const int32_t* depth_values, bool keyframe) noexcept;
+    size_t getMaxEncodedSize() noexcept;
+    size_t encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output) noexcept;
 
 private:
     const int width_;
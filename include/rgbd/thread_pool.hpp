@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "constants.hpp"
+
+namespace rgbd
+{
+// Runs tasks on worker threads that live as long as the pool, so code splitting a frame into
+// bands does not start threads per frame.
+// The calling thread of forEach() runs tasks too, so calling forEach() from a task does not
+// deadlock, and a pool without workers (e.g., when starting threads failed) runs them serially.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int worker_count) noexcept;
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    int worker_count() const noexcept
+    {
+        return gsl::narrow<int>(workers_.size());
+    }
+    // Runs function(index) for each index in [0, count) and returns after all of them finished.
+    // Rethrows the first exception thrown by function.
+    void forEach(int count, const std::function<void(int)>& function);
+    // The pool shared in the process, with a worker per hardware thread other than the caller's.
+    static ThreadPool& shared() noexcept;
+
+private:
+    struct Batch
+    {
+        Batch(int count, const std::function<void(int)>& function) noexcept;
+        const int count;
+        const std::function<void(int)>& function;
+        std::atomic<int> next_index;
+        // Guarded by ThreadPool::mutex_.
+        int finished_count;
+        std::exception_ptr exception;
+    };
+
+private:
+    void runWorker() noexcept;
+    void runBatch(Batch& batch) noexcept;
+
+private:
+    std::mutex mutex_;
+    std::condition_variable work_condition_variable_;
+    std::condition_variable done_condition_variable_;
+    // Guarded by mutex_.
+    std::deque<shared_ptr<Batch>> batches_;
+    bool stopping_;
+
+    vector<std::thread> workers_;
+};
+} // namespace rgbd
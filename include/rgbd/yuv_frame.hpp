@@ -33,6 +33,8 @@ public:
     YuvFrame(AVFrameHandle& av_frame);
     static unique_ptr<YuvFrame> createFromAzureKinectYuy2Buffer(
         const uint8_t* buffer, int width, int height, int stride_bytes, int downsample);
+    // Overwrites this frame with av_frame, reusing the memory of the channels when possible.
+    void copyFrom(const AVFrameHandle& av_frame);
     YuvFrame getDownsampled(int downsampling_factor) const;
     unique_ptr<YuvFrame> getMkvCoverSized() const;
     Bytes getPNGBytes() const;
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <mutex>
+#include "yuv_frame.hpp"
+
+namespace rgbd
+{
+// Keeps up to capacity YuvFrames that are no longer in use, so that decoding a stream of frames
+// can reuse their channels instead of allocating three vectors per frame.
+// Thread-safe, so frames can be released from a thread other than the decoding one.
+class YuvFramePool
+{
+public:
+    YuvFramePool(size_t capacity);
+    // Returns a released frame, or a new one when there is none.
+    // The contents of the returned frame are unspecified.
+    unique_ptr<YuvFrame> acquire(int width, int height);
+    // Gives yuv_frame back to the pool. Dropped when the pool is already full.
+    void release(unique_ptr<YuvFrame> yuv_frame);
+    size_t size();
+
+private:
+    std::mutex mutex_;
+    const size_t capacity_;
+    vector<unique_ptr<YuvFrame>> yuv_frames_;
+};
+} // namespace rgbd
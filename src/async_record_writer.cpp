@@ -0,0 +1,206 @@
+#include "async_record_writer.hpp"
+
+namespace rgbd
+{
+AsyncRecordWriter::AsyncRecordWriter(IOCallback& io_callback,
+                                     int sample_rate,
+                                     DepthCodecType depth_codec_type,
+                                     float depth_unit,
+                                     const CameraCalibration& calibration,
+                                     const optional<Bytes>& cover_png_bytes,
+                                     size_t max_queue_size,
+                                     AsyncRecordWriterOverflowPolicy overflow_policy,
+                                     const RecordWriterClusterPolicy& cluster_policy)
+    : record_writer_{io_callback,
+                     sample_rate,
+                     depth_codec_type,
+                     depth_unit,
+                     calibration,
+                     cover_png_bytes,
+                     cluster_policy}
+    , max_queue_size_{std::max<size_t>(max_queue_size, 1)}
+    , overflow_policy_{overflow_policy}
+    , mutex_{}
+    , condition_variable_{}
+    , queue_{}
+    , skipping_until_keyframe_{false}
+    , stats_{}
+    , writer_exception_{}
+    , stopping_{false}
+    , flushed_{false}
+    , writer_thread_{}
+{
+    writer_thread_ = std::thread{&AsyncRecordWriter::runWriter, this};
+}
+
+AsyncRecordWriter::~AsyncRecordWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+        queue_.clear();
+    }
+    condition_variable_.notify_all();
+    // Already joined when flush() was called.
+    if (writer_thread_.joinable())
+        writer_thread_.join();
+}
+
+void AsyncRecordWriter::writeVideoFrame(RecordVideoFrame video_frame)
+{
+    enqueue(std::make_unique<RecordVideoFrame>(std::move(video_frame)));
+}
+
+void AsyncRecordWriter::writeAudioFrame(RecordAudioFrame audio_frame)
+{
+    enqueue(std::make_unique<RecordAudioFrame>(std::move(audio_frame)));
+}
+
+void AsyncRecordWriter::writeIMUFrame(RecordIMUFrame imu_frame)
+{
+    enqueue(std::make_unique<RecordIMUFrame>(std::move(imu_frame)));
+}
+
+void AsyncRecordWriter::writePoseFrame(RecordPoseFrame pose_frame)
+{
+    enqueue(std::make_unique<RecordPoseFrame>(std::move(pose_frame)));
+}
+
+void AsyncRecordWriter::writeCalibrationFrame(RecordCalibrationFrame calibration_frame)
+{
+    enqueue(std::make_unique<RecordCalibrationFrame>(std::move(calibration_frame)));
+}
+
+void AsyncRecordWriter::flush()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (flushed_) {
+            spdlog::error("AsyncRecordWriter::flush: already flushed.");
+            throw std::runtime_error{"AsyncRecordWriter::flush: already flushed."};
+        }
+        // The writer thread returns after writing all queued frames.
+        stopping_ = true;
+        flushed_ = true;
+    }
+    condition_variable_.notify_all();
+    writer_thread_.join();
+
+    if (writer_exception_)
+        std::rethrow_exception(writer_exception_);
+
+    record_writer_.flush();
+}
+
+AsyncRecordWriterStats AsyncRecordWriter::getStats()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto stats{stats_};
+    stats.queue_size = queue_.size();
+    return stats;
+}
+
+void AsyncRecordWriter::enqueue(unique_ptr<RecordFrame> frame)
+{
+    auto enqueue_time{std::chrono::steady_clock::now()};
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        if (overflow_policy_ == AsyncRecordWriterOverflowPolicy::Block) {
+            condition_variable_.wait(lock, [this] {
+                return stopping_ || writer_exception_ || queue_.size() < max_queue_size_;
+            });
+        }
+        if (writer_exception_)
+            std::rethrow_exception(writer_exception_);
+        if (stopping_) {
+            spdlog::error("AsyncRecordWriter::enqueue: writer is already stopped.");
+            throw std::runtime_error{"AsyncRecordWriter::enqueue: writer is already stopped."};
+        }
+
+        while (queue_.size() >= max_queue_size_) {
+            if (queue_.front().frame->getType() == RecordFrameType::Video)
+                skipping_until_keyframe_ = true;
+            queue_.pop_front();
+            ++stats_.dropped_frame_count;
+        }
+
+        queue_.push_back(QueuedFrame{std::move(frame), enqueue_time});
+        stats_.peak_queue_size = std::max(stats_.peak_queue_size, queue_.size());
+    }
+    condition_variable_.notify_all();
+}
+
+void AsyncRecordWriter::runWriter()
+{
+    while (true) {
+        QueuedFrame queued_frame;
+        bool skipped{false};
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            condition_variable_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            // Returns only after the queue gets drained, so flush() does not lose frames.
+            if (queue_.empty())
+                return;
+
+            queued_frame = std::move(queue_.front());
+            queue_.pop_front();
+
+            if (skipping_until_keyframe_ &&
+                queued_frame.frame->getType() == RecordFrameType::Video) {
+                auto video_frame{dynamic_cast<RecordVideoFrame*>(queued_frame.frame.get())};
+                if (video_frame->keyframe()) {
+                    skipping_until_keyframe_ = false;
+                } else {
+                    ++stats_.dropped_frame_count;
+                    skipped = true;
+                }
+            }
+        }
+        // Wakes up callers waiting for room in the queue.
+        condition_variable_.notify_all();
+        if (skipped)
+            continue;
+
+        try {
+            writeFrame(*queued_frame.frame);
+        } catch (std::exception& e) {
+            spdlog::error("AsyncRecordWriter failed to write a frame: {}", e.what());
+            std::lock_guard<std::mutex> lock{mutex_};
+            writer_exception_ = std::current_exception();
+            condition_variable_.notify_all();
+            return;
+        }
+
+        auto latency_us{std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - queued_frame.enqueue_time)
+                            .count()};
+        std::lock_guard<std::mutex> lock{mutex_};
+        ++stats_.written_frame_count;
+        stats_.last_latency_us = latency_us;
+        stats_.max_latency_us = std::max(stats_.max_latency_us, stats_.last_latency_us);
+    }
+}
+
+void AsyncRecordWriter::writeFrame(RecordFrame& frame)
+{
+    switch (frame.getType()) {
+    case RecordFrameType::Video:
+        record_writer_.writeVideoFrame(dynamic_cast<RecordVideoFrame&>(frame));
+        break;
+    case RecordFrameType::Audio:
+        record_writer_.writeAudioFrame(dynamic_cast<RecordAudioFrame&>(frame));
+        break;
+    case RecordFrameType::IMU:
+        record_writer_.writeIMUFrame(dynamic_cast<RecordIMUFrame&>(frame));
+        break;
+    case RecordFrameType::Pose:
+        record_writer_.writePoseFrame(dynamic_cast<RecordPoseFrame&>(frame));
+        break;
+    case RecordFrameType::Calibration:
+        record_writer_.writeCalibrationFrame(dynamic_cast<RecordCalibrationFrame&>(frame));
+        break;
+    default:
+        throw std::runtime_error{"Invalid RecordFrameType found in AsyncRecordWriter::writeFrame"};
+    }
+}
+} // namespace rgbd
@@ -43,8 +43,8 @@ void decode_audio_packet(AVCodecContext* codec_context,
 }
 
 AudioDecoder::AudioDecoder()
-    : codec_parser_context_{avcodec_find_decoder(AV_CODEC_ID_OPUS)->id}
-    , codec_context_{avcodec_find_decoder(AV_CODEC_ID_OPUS)}
+    : codec_context_{avcodec_find_decoder(AV_CODEC_ID_OPUS)}
+    , packet_buffer_{}
     , packet_{}
 {
     codec_context_->request_sample_fmt = AV_SAMPLE_FMT_FLT;
@@ -56,41 +56,19 @@ AudioDecoder::AudioDecoder()
     }
 }
 
-// Decode frames in vp8_frame_data.
+// Decode frames in opus_frame.
 vector<float> AudioDecoder::decode(span<const uint8_t> opus_frame)
 {
+    // Each Matroska block holds exactly one Opus packet,
+    // so it is sent as a packet without going through a parser.
     vector<float> pcm_samples;
-    /* use the parser to split the data into frames */
-    size_t data_size{opus_frame.size()};
-    // Adding buffer padding is important!
-    // Removing this will result in crashes in some cases.
-    // When the crash happens, it happens in av_parser_parse2().
-    unique_ptr<uint8_t> padded_data(new uint8_t[data_size + AV_INPUT_BUFFER_PADDING_SIZE]);
-    memcpy(padded_data.get(), opus_frame.data(), data_size);
-    memset(padded_data.get() + data_size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
-    uint8_t* data{padded_data.get()};
+    // Unlike parsers, decoders reject empty packets.
+    if (opus_frame.empty())
+        return pcm_samples;
 
-    while (data_size > 0) {
-        // Returns the number of bytes used.
-        int size{av_parser_parse2(codec_parser_context_.get(),
-                                  codec_context_.get(),
-                                  &packet_->data,
-                                  &packet_->size,
-                                  data,
-                                  static_cast<int>(data_size),
-                                  AV_NOPTS_VALUE,
-                                  AV_NOPTS_VALUE,
-                                  0)};
-
-        if (size < 0)
-            throw std::runtime_error("An error from av_parser_parse2.");
-        
-        data += size;
-        data_size -= size;
-
-        if (packet_->size)
-            decode_audio_packet(codec_context_.get(), packet_.get(), pcm_samples);
-    }
+    packet_buffer_.fillPacket(opus_frame, packet_.get());
+    decode_audio_packet(codec_context_.get(), packet_.get(), pcm_samples);
+    av_packet_unref(packet_.get());
 
     return pcm_samples;
 }
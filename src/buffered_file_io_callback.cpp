@@ -0,0 +1,247 @@
+#include "buffered_file_io_callback.hpp"
+
+#ifdef CMAKE_RGBD_OS_WINDOWS
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rgbd
+{
+size_t round_up_to_alignment(size_t size)
+{
+    size_t aligned_size{(size + FILE_WRITE_ALIGNMENT - 1) / FILE_WRITE_ALIGNMENT *
+                        FILE_WRITE_ALIGNMENT};
+    return std::max(aligned_size, FILE_WRITE_ALIGNMENT);
+}
+
+#ifdef CMAKE_RGBD_OS_WINDOWS
+BufferedFileIOCallback::BufferedFileIOCallback(const string& file_path,
+                                               size_t buffer_size,
+                                               FileSyncPolicy sync_policy,
+                                               uint64_t preallocation_size)
+    : buffer_(round_up_to_alignment(buffer_size))
+    , buffer_used_{0}
+    , buffer_offset_{0}
+    , position_{0}
+    , file_size_{0}
+    , sync_policy_{sync_policy}
+    , file_write_count_{0}
+    , closed_{false}
+    , file_handle_{INVALID_HANDLE_VALUE}
+{
+    file_handle_ = CreateFileA(file_path.c_str(),
+                               GENERIC_WRITE,
+                               0,
+                               nullptr,
+                               CREATE_ALWAYS,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+    if (file_handle_ == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{fmt::format("Failed to open file: {}", file_path)};
+
+    if (preallocation_size > 0) {
+        FILE_ALLOCATION_INFO allocation_info;
+        allocation_info.AllocationSize.QuadPart = gsl::narrow<LONGLONG>(preallocation_size);
+        if (!SetFileInformationByHandle(
+                file_handle_, FileAllocationInfo, &allocation_info, sizeof(allocation_info)))
+            spdlog::warn("Failed to preallocate {} bytes for {}", preallocation_size, file_path);
+    }
+}
+
+void BufferedFileIOCallback::writeToFile(const uint8_t* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        DWORD size_to_write{gsl::narrow<DWORD>(std::min<size_t>(size, 1 << 30))};
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        DWORD written_size{0};
+        ++file_write_count_;
+        if (!WriteFile(file_handle_, data, size_to_write, &written_size, &overlapped))
+            throw std::runtime_error{"Failed to write file in BufferedFileIOCallback"};
+        data += written_size;
+        size -= written_size;
+        offset += written_size;
+    }
+}
+
+void BufferedFileIOCallback::sync()
+{
+    if (!FlushFileBuffers(file_handle_))
+        spdlog::warn("Failed to sync file in BufferedFileIOCallback");
+}
+
+void BufferedFileIOCallback::close()
+{
+    if (closed_)
+        return;
+
+    flush();
+    if (sync_policy_ != FileSyncPolicy::None)
+        sync();
+    CloseHandle(file_handle_);
+    closed_ = true;
+}
+#else
+BufferedFileIOCallback::BufferedFileIOCallback(const string& file_path,
+                                               size_t buffer_size,
+                                               FileSyncPolicy sync_policy,
+                                               uint64_t preallocation_size)
+    : buffer_(round_up_to_alignment(buffer_size))
+    , buffer_used_{0}
+    , buffer_offset_{0}
+    , position_{0}
+    , file_size_{0}
+    , sync_policy_{sync_policy}
+    , file_write_count_{0}
+    , closed_{false}
+    , fd_{-1}
+{
+    fd_ = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd_ < 0)
+        throw std::runtime_error{fmt::format("Failed to open file: {}", file_path)};
+
+    if (preallocation_size > 0) {
+#ifdef CMAKE_RGBD_OS_LINUX
+        // FALLOC_FL_KEEP_SIZE reserves the blocks without changing the size of the file,
+        // so there is nothing to truncate when the record ends up smaller.
+        if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, gsl::narrow<off_t>(preallocation_size)) != 0)
+            spdlog::warn("Failed to preallocate {} bytes for {}", preallocation_size, file_path);
+#else
+        spdlog::warn("Preallocation is not supported on this platform");
+#endif
+    }
+}
+
+void BufferedFileIOCallback::writeToFile(const uint8_t* data, size_t size, uint64_t offset)
+{
+    while (size > 0) {
+        ++file_write_count_;
+        ssize_t written_size{pwrite(fd_, data, size, gsl::narrow<off_t>(offset))};
+        if (written_size < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::runtime_error{
+                fmt::format("Failed to write file in BufferedFileIOCallback: {}", errno)};
+        }
+        data += written_size;
+        size -= gsl::narrow<size_t>(written_size);
+        offset += gsl::narrow<uint64_t>(written_size);
+    }
+}
+
+void BufferedFileIOCallback::sync()
+{
+#ifdef CMAKE_RGBD_OS_LINUX
+    int result{fdatasync(fd_)};
+#else
+    int result{fsync(fd_)};
+#endif
+    if (result != 0)
+        spdlog::warn("Failed to sync file in BufferedFileIOCallback");
+}
+
+void BufferedFileIOCallback::close()
+{
+    if (closed_)
+        return;
+
+    flush();
+    if (sync_policy_ != FileSyncPolicy::None)
+        sync();
+    ::close(fd_);
+    closed_ = true;
+}
+#endif
+
+BufferedFileIOCallback::~BufferedFileIOCallback()
+{
+    try {
+        close();
+    } catch (std::runtime_error e) {
+        spdlog::error("Failed to close BufferedFileIOCallback: {}", e.what());
+    }
+}
+
+uint32_t BufferedFileIOCallback::read(void*, size_t)
+{
+    throw std::runtime_error{"BufferedFileIOCallback is write-only"};
+}
+
+void BufferedFileIOCallback::setFilePointer(int64_t offset, libebml::seek_mode mode)
+{
+    int64_t position{0};
+    switch (mode) {
+    case libebml::seek_beginning:
+        position = offset;
+        break;
+    case libebml::seek_current:
+        position = gsl::narrow<int64_t>(position_) + offset;
+        break;
+    case libebml::seek_end:
+        position = gsl::narrow<int64_t>(file_size_) + offset;
+        break;
+    }
+    if (position < 0)
+        throw std::runtime_error{fmt::format("Invalid file pointer: {}", position)};
+
+    // Keeps buffer_ contiguous. Moving back to the end of the buffered bytes is free.
+    if (gsl::narrow<uint64_t>(position) != buffer_offset_ + buffer_used_) {
+        flush();
+        buffer_offset_ = gsl::narrow<uint64_t>(position);
+    }
+    position_ = gsl::narrow<uint64_t>(position);
+}
+
+size_t BufferedFileIOCallback::write(const void* buffer, size_t size)
+{
+    if (closed_)
+        throw std::runtime_error{"BufferedFileIOCallback is already closed"};
+
+    auto data{static_cast<const uint8_t*>(buffer)};
+    size_t remaining_size{size};
+    while (remaining_size > 0) {
+        // After a seek, the first flush ends at an aligned offset.
+        size_t capacity{buffer_.size() - buffer_offset_ % FILE_WRITE_ALIGNMENT};
+        if (buffer_used_ == 0 && remaining_size >= capacity) {
+            // No point of copying into the buffer.
+            writeToFile(data, remaining_size, buffer_offset_);
+            buffer_offset_ += remaining_size;
+            break;
+        }
+
+        size_t copy_size{std::min(remaining_size, capacity - buffer_used_)};
+        memcpy(buffer_.data() + buffer_used_, data, copy_size);
+        buffer_used_ += copy_size;
+        data += copy_size;
+        remaining_size -= copy_size;
+        if (buffer_used_ == capacity)
+            flush();
+    }
+
+    position_ += size;
+    file_size_ = std::max(file_size_, position_);
+    return size;
+}
+
+uint64_t BufferedFileIOCallback::getFilePointer()
+{
+    return position_;
+}
+
+void BufferedFileIOCallback::flush()
+{
+    if (buffer_used_ == 0)
+        return;
+
+    writeToFile(buffer_.data(), buffer_used_, buffer_offset_);
+    buffer_offset_ += buffer_used_;
+    buffer_used_ = 0;
+    if (sync_policy_ == FileSyncPolicy::OnFlush)
+        sync();
+}
+} // namespace rgbd
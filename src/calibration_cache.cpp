@@ -0,0 +1,136 @@
+#include "calibration_cache.hpp"
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "thread_pool.hpp"
+
+namespace rgbd
+{
+namespace calibration_cache
+{
+namespace
+{
+// Tables get evicted beyond this many per kind, least recently used first. Reopening files from
+// a few devices in turn stays instant, while tables of calibrations seen once do not pile up.
+constexpr size_t MAX_CACHED_TABLE_COUNT{8};
+
+template <class T> struct TableCache
+{
+    // The most recently used table first.
+    list<pair<string, shared_ptr<const T>>> entries;
+    std::unordered_map<string, typename list<pair<string, shared_ptr<const T>>>::iterator>
+        entry_iterators;
+};
+
+std::mutex mutex;
+TableCache<vector<glm::vec3>> directions_cache;
+TableCache<vector<glm::vec2>> uvs_cache;
+
+// Runs function for each row on the threads of ThreadPool::shared(), a band of rows per thread.
+void for_each_row_in_parallel(int height, const std::function<void(int)>& function)
+{
+    auto& thread_pool{ThreadPool::shared()};
+    const int band_count{std::max(1, std::min(thread_pool.worker_count() + 1, height))};
+    thread_pool.forEach(band_count, [&](int band_index) {
+        const int begin_row{static_cast<int>(static_cast<int64_t>(height) * band_index /
+                                             band_count)};
+        const int end_row{static_cast<int>(static_cast<int64_t>(height) * (band_index + 1) /
+                                           band_count)};
+        for (int row{begin_row}; row < end_row; ++row)
+            function(row);
+    });
+}
+
+// Looks up key in cache, or computes the value without holding the lock so computing
+// tables of different calibrations can happen at the same time.
+template <class T>
+shared_ptr<const T> get_or_compute(TableCache<T>& cache,
+                                   const string& key,
+                                   const std::function<shared_ptr<const T>()>& compute)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        auto it{cache.entry_iterators.find(key)};
+        if (it != cache.entry_iterators.end()) {
+            cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+            return it->second->second;
+        }
+    }
+
+    auto value{compute()};
+    std::lock_guard<std::mutex> lock{mutex};
+    // Keeping the first one when another thread computed the same table meanwhile.
+    auto it{cache.entry_iterators.find(key)};
+    if (it != cache.entry_iterators.end()) {
+        cache.entries.splice(cache.entries.begin(), cache.entries, it->second);
+        return it->second->second;
+    }
+
+    cache.entries.emplace_front(key, std::move(value));
+    cache.entry_iterators.emplace(key, cache.entries.begin());
+    if (cache.entries.size() > MAX_CACHED_TABLE_COUNT) {
+        cache.entry_iterators.erase(cache.entries.back().first);
+        cache.entries.pop_back();
+    }
+    return cache.entries.front().second;
+}
+} // namespace
+
+shared_ptr<const vector<glm::vec3>>
+get_directions(const CameraCalibration& calibration, int width, int height)
+{
+    const string key{calibration.toJson().dump() + "/" + std::to_string(width) + "x" +
+                     std::to_string(height)};
+    return get_or_compute<vector<glm::vec3>>(directions_cache, key, [&] {
+        auto directions{std::make_shared<vector<glm::vec3>>(static_cast<size_t>(width) * height)};
+        // A single column or row is at the left or top.
+        const float u_scale{width > 1 ? 1.0f / (width - 1) : 0.0f};
+        const float v_scale{height > 1 ? 1.0f / (height - 1) : 0.0f};
+        for_each_row_in_parallel(height, [&](int row) {
+            for (int col{0}; col < width; ++col) {
+                float u{col * u_scale};
+                float v{row * v_scale};
+                (*directions)[col + row * width] = calibration.getDirection(glm::vec2{u, v});
+            }
+        });
+        return shared_ptr<const vector<glm::vec3>>{std::move(directions)};
+    });
+}
+
+shared_ptr<const vector<glm::vec2>> get_uvs(const CameraCalibration& from_calibration,
+                                            int from_width,
+                                            int from_height,
+                                            const CameraCalibration& to_calibration)
+{
+    const string key{from_calibration.toJson().dump() + "/" + std::to_string(from_width) + "x" +
+                     std::to_string(from_height) + "/" + to_calibration.toJson().dump()};
+    return get_or_compute<vector<glm::vec2>>(uvs_cache, key, [&] {
+        auto uvs{
+            std::make_shared<vector<glm::vec2>>(static_cast<size_t>(from_width) * from_height)};
+        const float u_scale{from_width > 1 ? 1.0f / (from_width - 1) : 0.0f};
+        const float v_scale{from_height > 1 ? 1.0f / (from_height - 1) : 0.0f};
+        for_each_row_in_parallel(from_height, [&](int from_row) {
+            for (int from_col{0}; from_col < from_width; ++from_col) {
+                float from_u{from_col * u_scale};
+                float from_v{from_row * v_scale};
+
+                auto direction{from_calibration.getDirection(glm::vec2{from_u, from_v})};
+                (*uvs)[from_col + from_row * from_width] = to_calibration.getUv(direction);
+            }
+        });
+        return shared_ptr<const vector<glm::vec2>>{std::move(uvs)};
+    });
+}
+
+void clear() noexcept
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    directions_cache.entries.clear();
+    directions_cache.entry_iterators.clear();
+    uvs_cache.entries.clear();
+    uvs_cache.entry_iterators.clear();
+}
+} // namespace calibration_cache
+} // namespace rgbd
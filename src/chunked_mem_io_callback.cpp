@@ -0,0 +1,94 @@
+#include "chunked_mem_io_callback.hpp"
+
+namespace rgbd
+{
+ChunkedMemIOCallback::ChunkedMemIOCallback(size_t chunk_size)
+    : chunk_size_{std::max<size_t>(chunk_size, 1)}
+    , chunks_{}
+    , position_{0}
+    , size_{0}
+{
+}
+
+uint32_t ChunkedMemIOCallback::read(void* buffer, size_t size)
+{
+    if (position_ >= size_)
+        return 0;
+
+    auto data{static_cast<uint8_t*>(buffer)};
+    size_t read_size{std::min<size_t>(size, gsl::narrow<size_t>(size_ - position_))};
+    size_t remaining_size{read_size};
+    while (remaining_size > 0) {
+        size_t chunk_index{gsl::narrow<size_t>(position_ / chunk_size_)};
+        size_t chunk_offset{gsl::narrow<size_t>(position_ % chunk_size_)};
+        size_t copy_size{std::min(remaining_size, chunk_size_ - chunk_offset)};
+        memcpy(data, chunks_[chunk_index].get() + chunk_offset, copy_size);
+        data += copy_size;
+        remaining_size -= copy_size;
+        position_ += copy_size;
+    }
+    return gsl::narrow<uint32_t>(read_size);
+}
+
+void ChunkedMemIOCallback::setFilePointer(int64_t offset, libebml::seek_mode mode)
+{
+    int64_t position{0};
+    switch (mode) {
+    case libebml::seek_beginning:
+        position = offset;
+        break;
+    case libebml::seek_current:
+        position = gsl::narrow<int64_t>(position_) + offset;
+        break;
+    case libebml::seek_end:
+        position = gsl::narrow<int64_t>(size_) + offset;
+        break;
+    }
+    if (position < 0 || position > gsl::narrow<int64_t>(size_))
+        throw std::runtime_error{fmt::format("Invalid file pointer: {}", position)};
+
+    position_ = gsl::narrow<uint64_t>(position);
+}
+
+size_t ChunkedMemIOCallback::write(const void* buffer, size_t size)
+{
+    auto data{static_cast<const uint8_t*>(buffer)};
+    size_t remaining_size{size};
+    while (remaining_size > 0) {
+        size_t chunk_index{gsl::narrow<size_t>(position_ / chunk_size_)};
+        size_t chunk_offset{gsl::narrow<size_t>(position_ % chunk_size_)};
+        // Not using std::make_unique since it zero-fills the chunk.
+        if (chunk_index == chunks_.size())
+            chunks_.push_back(unique_ptr<uint8_t[]>{new uint8_t[chunk_size_]});
+
+        size_t copy_size{std::min(remaining_size, chunk_size_ - chunk_offset)};
+        memcpy(chunks_[chunk_index].get() + chunk_offset, data, copy_size);
+        data += copy_size;
+        remaining_size -= copy_size;
+        position_ += copy_size;
+    }
+    size_ = std::max(size_, position_);
+    return size;
+}
+
+uint64_t ChunkedMemIOCallback::getFilePointer()
+{
+    return position_;
+}
+
+void ChunkedMemIOCallback::close()
+{
+}
+
+Bytes ChunkedMemIOCallback::toBytes() const
+{
+    Bytes bytes(gsl::narrow<size_t>(size_));
+    size_t offset{0};
+    for (auto& chunk : chunks_) {
+        size_t copy_size{std::min(chunk_size_, bytes.size() - offset)};
+        memcpy(bytes.data() + offset, chunk.get(), copy_size);
+        offset += copy_size;
+    }
+    return bytes;
+}
+} // namespace rgbd
@@ -105,7 +105,7 @@ void split_file(const std::string& file_path)
             throw std::runtime_error("Invalid chunk_index found...");
         }
 
-        auto color_bytes{color_encoder->encode(*color_frame, first)};
+        auto color_bytes{color_encoder->encode(*color_frame, first, time_point_us)};
         auto depth_bytes{depth_encoder->encode(depth_frame->values().data(), first)};
 
         // file_writer->writeVideoFrame(time_point_us, first, color_bytes, depth_bytes);
@@ -121,40 +121,46 @@ void trim_file(const std::string& file_path, float from_sec, float to_sec)
 {
     int64_t from_us{static_cast<int64_t>(from_sec * 1000000)};
     int64_t to_us{static_cast<int64_t>(to_sec * 1000000)};
-    RecordParser parser{file_path};
-    auto file{parser.parse(true)};
-    auto& video_frames{file->video_frames()};
+    RecordFrameReader reader{file_path};
 
     auto output_path{"trimmed.mkv"};
     // FileWriterConfig writer_config;
     // writer_config.depth_codec_type = DepthCodecType::TDC1;
     // FileWriter file_writer{output_path, *file->attachments().camera_calibration, writer_config};
     RecordBuilder record_builder;
-    record_builder.setCalibration(*file->attachments().camera_calibration);
+    record_builder.setCalibration(*reader.attachments().camera_calibration);
 
     ColorEncoder color_encoder{
-        ColorCodecType::VP8, file->tracks().color_track.width, file->tracks().color_track.height};
+        ColorCodecType::VP8, reader.tracks().color_track.width, reader.tracks().color_track.height};
     DepthEncoder depth_encoder{
-        DepthCodecType::TDC1, file->tracks().depth_track.width, file->tracks().depth_track.height};
+        DepthCodecType::TDC1, reader.tracks().depth_track.width, reader.tracks().depth_track.height};
 
     ColorDecoder color_decoder{ColorCodecType::VP8};
-    TDC1Decoder depth_decoder;
+    DepthDecoder depth_decoder{reader.tracks().depth_track.codec};
+
+    // Start decoding from the keyframe before from_us instead of the beginning of the file.
+    reader.seekToTimePoint(from_us);
 
     int previous_keyframe_index{-1};
-    for (auto& video_frame : video_frames) {
-        int64_t original_time_point_us{video_frame.time_point_us()};
-        if (original_time_point_us < from_us)
+    while (auto frame{reader.next()}) {
+        if (frame->getType() != RecordFrameType::Video)
             continue;
+
+        auto& video_frame{*dynamic_cast<RecordVideoFrame*>(frame.get())};
+        int64_t original_time_point_us{video_frame.time_point_us()};
         if (original_time_point_us > to_us)
             break;
 
+        // Frames between the keyframe and from_us are decoded but not written.
+        auto color_frame{color_decoder.decode(video_frame.color_bytes())};
+        auto depth_frame{depth_decoder.decode(video_frame.depth_bytes())};
+        if (original_time_point_us < from_us)
+            continue;
+
         int64_t trimmed_time_point_us{video_frame.time_point_us() - from_us};
         constexpr int TWO_SECONDS{2000000};
         int keyframe_index{gsl::narrow<int>(trimmed_time_point_us / TWO_SECONDS)};
 
-        auto color_frame{color_decoder.decode(video_frame.color_bytes())};
-        auto depth_frame{depth_decoder.decode(video_frame.depth_bytes())};
-
         bool keyframe{false};
         if (keyframe_index == previous_keyframe_index + 1) {
             if (keyframe_index == 0) {
@@ -194,6 +200,20 @@ void standardize_calibration(const std::string& file_path)
     UndistortedCameraCalibration standard_calibration{1024, 1024, 512, 512, 0.5f, 0.5f, 0.5f, 0.5f};
 
     FrameMapper frame_mapper{original_calibration, standard_calibration};
+    // Reused for every frame.
+    const int standard_color_width{standard_calibration.getColorWidth()};
+    const int standard_color_height{standard_calibration.getColorHeight()};
+    const int standard_depth_width{standard_calibration.getDepthWidth()};
+    const int standard_depth_height{standard_calibration.getDepthHeight()};
+    YuvFrame mapped_color_frame{
+        standard_color_width,
+        standard_color_height,
+        vector<uint8_t>(standard_color_width * standard_color_height),
+        vector<uint8_t>(standard_color_width * standard_color_height / 4),
+        vector<uint8_t>(standard_color_width * standard_color_height / 4)};
+    Int32Frame mapped_depth_frame{standard_depth_width,
+                                  standard_depth_height,
+                                  vector<int32_t>(standard_depth_width * standard_depth_height)};
 
     RecordBuilder record_builder;
     record_builder.setCalibration(standard_calibration);
@@ -205,16 +225,21 @@ void standardize_calibration(const std::string& file_path)
                                standard_calibration.getDepthWidth(),
                                standard_calibration.getDepthHeight()};
 
-    ColorDecoder color_decoder{ColorCodecType::VP8};
-    TDC1Decoder depth_decoder;
+    // Decoding GOPs in parallel while the frames are mapped and encoded in this thread.
+    ParallelVideoDecoder video_decoder{ColorCodecType::VP8,
+                                       file->tracks().depth_track.codec,
+                                       video_frames,
+                                       gsl::narrow<int>(std::thread::hardware_concurrency()),
+                                       8};
     bool first{true};
     int audio_frame_index{0};
     int imu_frame_index{0};
     int pose_frame_index{0};
     for (auto& video_frame : video_frames) {
         auto video_time_point_us{video_frame.time_point_us()};
-        auto color_frame{color_decoder.decode(video_frame.color_bytes())};
-        auto depth_frame{depth_decoder.decode(video_frame.depth_bytes())};
+        auto decoded_frame{video_decoder.next()};
+        auto& color_frame{decoded_frame->yuv_frame()};
+        auto& depth_frame{decoded_frame->depth_frame()};
 
         bool keyframe{video_frame.keyframe()};
         if (first) {
@@ -223,11 +248,11 @@ void standardize_calibration(const std::string& file_path)
             first = false;
         }
 
-        auto mapped_color_frame{frame_mapper.mapColorFrame(*color_frame)};
-        auto mapped_depth_frame{frame_mapper.mapDepthFrame(*depth_frame)};
+        frame_mapper.mapColorFrameInto(*color_frame, mapped_color_frame);
+        frame_mapper.mapDepthFrameInto(*depth_frame, mapped_depth_frame);
 
-        auto color_bytes{color_encoder.encode(*mapped_color_frame, keyframe)};
-        auto depth_bytes{depth_encoder.encode(mapped_depth_frame->values().data(), keyframe)};
+        auto color_bytes{color_encoder.encode(mapped_color_frame, keyframe)};
+        auto depth_bytes{depth_encoder.encode(mapped_depth_frame.values().data(), keyframe)};
 
         record_builder.addVideoFrame(
             RecordVideoFrame{video_time_point_us, keyframe, color_bytes, depth_bytes});
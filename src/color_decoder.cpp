@@ -13,7 +13,7 @@ namespace rgbd
 // A helper function for Vp8Decoder::decode() that feeds frames of packet into decoder_frames.
 void decode_video_packet(AVCodecContext* codec_context,
                          AVPacket* packet,
-                         std::vector<unique_ptr<YuvFrame>>& yuv_frames)
+                         std::vector<AVFrameHandle>& av_frames)
 {
     if (avcodec_send_packet(codec_context, packet) < 0)
         throw std::runtime_error("Error from avcodec_send_packet.");
@@ -29,15 +29,18 @@ void decode_video_packet(AVCodecContext* codec_context,
             throw std::runtime_error("Error from avcodec_send_packet.");
         }
 
-        yuv_frames.push_back(std::make_unique<YuvFrame>(av_frame));
+        av_frames.push_back(av_frame);
     }
 }
 
-ColorDecoder::ColorDecoder(ColorCodecType type)
-    : codec_parser_context_{find_decoder_avcodec(type)->id}
-    , codec_context_{find_decoder_avcodec(type)}
+ColorDecoder::ColorDecoder(ColorCodecType type, const ColorDecoderOptions& options)
+    : codec_context_{find_decoder_avcodec(type)}
+    , packet_buffer_{}
     , packet_{}
 {
+    codec_context_->thread_count = options.thread_count;
+    codec_context_->thread_type = FF_THREAD_SLICE;
+
     if (avcodec_open2(codec_context_.get(), nullptr, nullptr) < 0) {
         spdlog::error("avcodec_open2 failed");
         throw std::runtime_error("avcodec_open2 failed.");
@@ -47,43 +50,36 @@ ColorDecoder::ColorDecoder(ColorCodecType type)
 // Decode frames in vp8_frame_data.
 unique_ptr<YuvFrame> ColorDecoder::decode(span<const uint8_t> vp8_frame)
 {
-    vector<unique_ptr<YuvFrame>> yuv_frames;
-    /* use the parser to split the data into frames */
-    size_t data_size{vp8_frame.size()};
-    // Adding buffer padding is important!
-    // Removing this will result in crashes in some cases.
-    // When the crash happens, it happens in av_parser_parse2().
-    unique_ptr<uint8_t> padded_data(new uint8_t[data_size + AV_INPUT_BUFFER_PADDING_SIZE]);
-    memcpy(padded_data.get(), vp8_frame.data(), data_size);
-    memset(padded_data.get() + data_size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
-    uint8_t* data{padded_data.get()};
-
-    while (data_size > 0) {
-        // Returns the number of bytes used.
-        int size{av_parser_parse2(codec_parser_context_.get(),
-                                  codec_context_.get(),
-                                  &packet_->data,
-                                  &packet_->size,
-                                  data,
-                                  static_cast<int>(data_size),
-                                  AV_NOPTS_VALUE,
-                                  AV_NOPTS_VALUE,
-                                  0)};
+    auto av_frame{decodeToAVFrame(vp8_frame)};
+    return std::make_unique<YuvFrame>(av_frame);
+}
 
-        if (size < 0)
-            throw std::runtime_error("An error from av_parser_parse2.");
+unique_ptr<YuvFrame> ColorDecoder::decode(span<const uint8_t> vp8_frame, YuvFramePool& pool)
+{
+    auto av_frame{decodeToAVFrame(vp8_frame)};
+    auto yuv_frame{pool.acquire(av_frame->width, av_frame->height)};
+    yuv_frame->copyFrom(av_frame);
+    return yuv_frame;
+}
 
-        data += size;
-        data_size -= size;
+void ColorDecoder::decodeInto(span<const uint8_t> vp8_frame, YuvFrame& yuv_frame)
+{
+    yuv_frame.copyFrom(decodeToAVFrame(vp8_frame));
+}
 
-        if (packet_->size)
-            decode_video_packet(codec_context_.get(), packet_.get(), yuv_frames);
-    }
+AVFrameHandle ColorDecoder::decodeToAVFrame(span<const uint8_t> vp8_frame)
+{
+    // Each Matroska block holds exactly one VP8 frame,
+    // so it is sent as a packet without going through a parser.
+    vector<AVFrameHandle> av_frames;
+    packet_buffer_.fillPacket(vp8_frame, packet_.get());
+    decode_video_packet(codec_context_.get(), packet_.get(), av_frames);
+    av_packet_unref(packet_.get());
 
-    if (yuv_frames.size() != 1)
+    if (av_frames.size() != 1)
         throw std::runtime_error(
             "More or less than one frame found in FFmpegVideoDecoder::decode.");
 
-    return std::move(yuv_frames[0]);
+    return av_frames[0];
 }
 } // namespace rgbd
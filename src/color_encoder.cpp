@@ -10,10 +10,15 @@ extern "C"
 
 namespace rgbd
 {
-ColorEncoder::ColorEncoder(ColorCodecType type, int width, int height)
+ColorEncoder::ColorEncoder(ColorCodecType type,
+                           int width,
+                           int height,
+                           const ColorEncoderOptions& options)
     : codec_context_{find_encoder_avcodec(type)}
     , frame_{}
     , next_pts_{0}
+    , last_pts_{-1}
+    , last_keyframe_{false}
 {
     if (type != ColorCodecType::VP8) {
         spdlog::error("Invalid ColorCodecType");
@@ -27,32 +32,49 @@ ColorEncoder::ColorEncoder(ColorCodecType type, int width, int height)
 
     // Dividing by 200 leads to a similar value to Youtube's recommendations.
     // ref: https://support.google.com/youtube/answer/1722171
-    const int target_bitrate_kbps{width * height / 200};
-
-    // Just assume 30 FPS.
-    const int framerate{30};
+    const int target_bitrate_kbps{options.target_bitrate_kbps > 0 ? options.target_bitrate_kbps
+                                                                   : width * height / 200};
+    const int64_t target_bitrate{static_cast<int64_t>(target_bitrate_kbps) * 1000};
+    codec_context_->bit_rate = target_bitrate;
+    if (options.rate_control_mode == ColorRateControlMode::CBR) {
+        // setting codec_context_->rc_min_rate == codec_context_->rc_max_rate and
+        // codec_context_->rc_min_rate == codec_context_->bit_rate
+        // puts libvpx into VPX_CBR (constant bitrate) mode.
+        codec_context_->rc_min_rate = target_bitrate;
+        codec_context_->rc_max_rate = target_bitrate;
+    } else if (options.rate_control_mode == ColorRateControlMode::VBR) {
+        // Leaving rc_min_rate and rc_max_rate unset puts libvpx into VPX_VBR mode.
+    } else if (options.rate_control_mode == ColorRateControlMode::CQ) {
+        // Setting crf puts libvpx into VPX_CQ mode, which keeps the quality at cq_level
+        // while using bit_rate as the upper bound.
+        av_dict_set_int(&opt, "crf", options.cq_level, 0);
+    } else {
+        spdlog::error("Invalid ColorRateControlMode: {}",
+                      static_cast<int>(options.rate_control_mode));
+        throw std::runtime_error("Invalid ColorRateControlMode");
+    }
 
-    // setting codec_context_->rc_min_rate == codec_context_->rc_max_rate and
-    // codec_context_->rc_min_rate == codec_context_->bit_rate
-    // puts libvpx into VPX_CBR (constant bitrate) mode.
-    codec_context_->bit_rate = target_bitrate_kbps * 1000;
-    codec_context_->rc_min_rate = static_cast<int64_t>(target_bitrate_kbps) * 1000;
-    codec_context_->rc_max_rate = target_bitrate_kbps * 1000;
-    codec_context_->framerate = AVRational{framerate, 1};
-    codec_context_->time_base = AVRational{1, framerate};
+    // Timestamps are in microseconds, so libvpx can derive the frame rate from the actual
+    // timestamps given to encode(). libvpx uses ticks_per_frame as the duration of each frame,
+    // which only matters for the first frame, so VIDEO_FRAME_RATE is just the initial guess.
+    codec_context_->framerate = AVRational{VIDEO_FRAME_RATE, 1};
+    codec_context_->time_base = AVRational{1, static_cast<int>(ONE_SECOND_US)};
+    codec_context_->ticks_per_frame = static_cast<int>(ONE_SECOND_US / VIDEO_FRAME_RATE);
 
-    codec_context_->thread_count = 4;
+    codec_context_->thread_count = options.thread_count;
     codec_context_->profile = 1;
     av_dict_set_int(&opt, "lag-in-frames", 0, 0);
     codec_context_->qmin = 4;
     codec_context_->qmax = 56;
-    // Set gop_size and keyint_min to INT_MAX as a way to
+    // Without keyframe_interval, set gop_size and keyint_min to INT_MAX as a way to
     // not have keyframes unless keyframe is set true in encode().
-    codec_context_->gop_size = INT_MAX;
-    codec_context_->keyint_min = INT_MAX;
-     
-    av_dict_set(&opt, "deadline", "realtime", 0);
-    av_dict_set_int(&opt, "cpu-used", 4, 0);
+    const int keyframe_interval{options.keyframe_interval > 0 ? options.keyframe_interval
+                                                              : INT_MAX};
+    codec_context_->gop_size = keyframe_interval;
+    codec_context_->keyint_min = keyframe_interval;
+
+    av_dict_set(&opt, "deadline", options.deadline.c_str(), 0);
+    av_dict_set_int(&opt, "cpu-used", options.cpu_used, 0);
     av_dict_set_int(&opt, "static-thresh", 0, 0);
     av_dict_set_int(&opt, "max-intra-rate", 300, 0);
 
@@ -69,28 +91,76 @@ ColorEncoder::ColorEncoder(ColorCodecType type, int width, int height)
         throw std::runtime_error("av_frame_get_buffer failed");
 };
 
-Bytes ColorEncoder::encode(const YuvFrame& yuv_image, bool keyframe)
+Bytes ColorEncoder::encode(const YuvFrame& yuv_image,
+                           bool keyframe,
+                           optional<int64_t> time_point_us)
 {
-    for (int row{0}; row < codec_context_->height; ++row) {
-        int frame_row_index{row * frame_->linesize[0]};
-        int y_row_index{row * codec_context_->width};
-        for (int col{0}; col < codec_context_->width; ++col) {
-            frame_->data[0][frame_row_index + col] = yuv_image.y_channel()[y_row_index + col];
-        }
+    const int uv_width{codec_context_->width / 2};
+    return encodePlanes(yuv_image.y_channel().data(),
+                        codec_context_->width,
+                        yuv_image.u_channel().data(),
+                        uv_width,
+                        yuv_image.v_channel().data(),
+                        uv_width,
+                        keyframe,
+                        time_point_us);
+}
+
+Bytes ColorEncoder::encodePlanes(const uint8_t* y_data,
+                                 int y_stride,
+                                 const uint8_t* u_data,
+                                 int u_stride,
+                                 const uint8_t* v_data,
+                                 int v_stride,
+                                 bool keyframe,
+                                 optional<int64_t> time_point_us)
+{
+    const int width{codec_context_->width};
+    const int height{codec_context_->height};
+    const int uv_width{width / 2};
+    const int uv_height{height / 2};
+    if (y_stride < width || u_stride < uv_width || v_stride < uv_width) {
+        spdlog::error("ColorEncoder::encodePlanes: strides ({}, {}, {}) are shorter than rows of "
+                      "{}x{} I420 planes",
+                      y_stride,
+                      u_stride,
+                      v_stride,
+                      width,
+                      height);
+        throw std::runtime_error("Invalid strides in ColorEncoder::encodePlanes");
+    }
+
+    // Timestamps should increase for libvpx. Rejecting the frame here instead of replacing its
+    // time point keeps the frame rate libvpx derives from the time points correct.
+    if (time_point_us && *time_point_us <= last_pts_) {
+        spdlog::error("ColorEncoder::encodePlanes: time_point_us ({}) is not after the previous "
+                      "time point ({})",
+                      *time_point_us,
+                      last_pts_);
+        throw std::runtime_error("Non-increasing time_point_us in ColorEncoder::encodePlanes");
+    }
+
+    // The encoder may still hold a reference to the buffer of frame_.
+    if (av_frame_make_writable(frame_.get()) < 0)
+        throw std::runtime_error("av_frame_make_writable failed");
+
+    for (int row{0}; row < height; ++row) {
+        memcpy(frame_->data[0] + static_cast<int64_t>(row) * frame_->linesize[0],
+               y_data + static_cast<int64_t>(row) * y_stride,
+               width);
     }
 
-    int uv_width{codec_context_->width / 2};
-    int uv_height{codec_context_->height / 2};
     for (int row{0}; row < uv_height; ++row) {
-        int frame_u_row_index{row * frame_->linesize[1]};
-        int frame_v_row_index{row * frame_->linesize[2]};
-        int uv_row_index{row * codec_context_->width / 2};
-        for (int col{0}; col < uv_width; ++col) {
-            frame_->data[1][frame_u_row_index + col] = yuv_image.u_channel()[uv_row_index + col];
-            frame_->data[2][frame_v_row_index + col] = yuv_image.v_channel()[uv_row_index + col];
-        }
+        memcpy(frame_->data[1] + static_cast<int64_t>(row) * frame_->linesize[1],
+               u_data + static_cast<int64_t>(row) * u_stride,
+               uv_width);
+        memcpy(frame_->data[2] + static_cast<int64_t>(row) * frame_->linesize[2],
+               v_data + static_cast<int64_t>(row) * v_stride,
+               uv_width);
     }
 
+    if (time_point_us)
+        next_pts_ = *time_point_us;
     frame_->pts = next_pts_;
     if (keyframe) {
         frame_->key_frame = 1;
@@ -104,7 +174,9 @@ Bytes ColorEncoder::encode(const YuvFrame& yuv_image, bool keyframe)
     if (packets.size() != 1)
         throw std::runtime_error("Should be only one packet from one frame.");
 
-    ++next_pts_;
+    last_pts_ = next_pts_;
+    next_pts_ += ONE_SECOND_US / VIDEO_FRAME_RATE;
+    last_keyframe_ = (packets[0]->flags & AV_PKT_FLAG_KEY) != 0;
     return packets[0].getDataBytes();
 }
 
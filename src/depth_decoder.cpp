@@ -1,6 +1,7 @@
 #include "depth_decoder.hpp"
 
 #include "rvl_decoder.hpp"
+#include "rvl_mt_decoder.hpp"
 #include "tdc1_decoder.hpp"
 
 namespace rgbd
@@ -12,14 +13,39 @@ DepthDecoder::DepthDecoder(DepthCodecType depth_codec_type)
         impl_.reset(new RVLDecoder);
     } else if (depth_codec_type == DepthCodecType::TDC1) {
         impl_.reset(new TDC1Decoder);
+    } else if (depth_codec_type == DepthCodecType::RVL_MT) {
+        impl_.reset(new RVLMTDecoder);
     } else {
         spdlog::error("Invalid depth_codec_type found in DepthDecoder::DepthDecoder: {}", depth_codec_type);
         throw std::runtime_error("Invalid depth_codec_type found in DepthDecoder::DepthDecoder");
     }
 }
 
-unique_ptr<Int32Frame> DepthDecoder::decode(span<const uint8_t> bytes) noexcept
+unique_ptr<Int32Frame> DepthDecoder::decode(span<const uint8_t> bytes)
 {
     return impl_->decode(bytes);
 }
+
+void DepthDecoder::decodeInto(span<const uint8_t> bytes, span<int32_t> output)
+{
+    impl_->decodeInto(bytes, output);
+}
+
+void DepthDecoder::decodeBatchInto(const vector<span<const uint8_t>>& bytes_list,
+                                   span<int32_t> output)
+{
+    if (bytes_list.empty())
+        return;
+
+    if (output.size() % bytes_list.size() != 0) {
+        spdlog::error("DepthDecoder::decodeBatchInto: output size ({}) is not a multiple of {}",
+                      output.size(),
+                      bytes_list.size());
+        throw std::runtime_error("Invalid output size in DepthDecoder::decodeBatchInto");
+    }
+
+    const size_t frame_size{output.size() / bytes_list.size()};
+    for (size_t i{0}; i < bytes_list.size(); ++i)
+        impl_->decodeInto(bytes_list[i], output.subspan(i * frame_size, frame_size));
+}
 }
@@ -1,12 +1,16 @@
 #include "depth_encoder.hpp"
 
 #include "rvl_encoder.hpp"
+#include "rvl_mt.hpp"
+#include "rvl_mt_encoder.hpp"
 #include "tdc1_encoder.hpp"
 
 namespace rgbd
 {
 DepthEncoder::DepthEncoder(DepthCodecType type, int width, int height)
     : impl_{}
+    , width_{width}
+    , height_{height}
 {
     if (type == DepthCodecType::RVL) {
         impl_.reset(new RVLEncoder{width, height});
@@ -14,6 +18,8 @@ DepthEncoder::DepthEncoder(DepthCodecType type, int width, int height)
         // 500 as the default value.
         const int DEPTH_DIFF_MULTIPLIER{500};
         impl_.reset(new TDC1Encoder{width, height, DEPTH_DIFF_MULTIPLIER});
+    } else if (type == DepthCodecType::RVL_MT) {
+        impl_.reset(new RVLMTEncoder{width, height, rvl_mt::DEFAULT_BAND_COUNT});
     } else {
         spdlog::error("Invalid type found in DepthEncoder::DepthEncoder: {}", type);
         throw std::runtime_error("Invalid type found in DepthEncoder::DepthEncoder");
@@ -27,6 +33,78 @@ DepthCodecType DepthEncoder::getCodecType() noexcept
 
 Bytes DepthEncoder::encode(const int32_t* depth_values, bool keyframe) noexcept
 {
-    return impl_->encode(depth_values, keyframe);
+    Bytes bytes;
+    bytes.resize(encodeInto(depth_values, keyframe, bytes));
+    bytes.shrink_to_fit();
+    return bytes;
+}
+
+size_t DepthEncoder::getMaxEncodedSize() noexcept
+{
+    return impl_->getMaxEncodedSize();
+}
+
+size_t DepthEncoder::encodeInto(const int32_t* depth_values, bool keyframe, span<uint8_t> output)
+{
+    if (output.size() < impl_->getMaxEncodedSize()) {
+        spdlog::error("DepthEncoder::encodeInto: output size ({}) is smaller than {}",
+                      output.size(),
+                      impl_->getMaxEncodedSize());
+        throw std::runtime_error("Output too small in DepthEncoder::encodeInto");
+    }
+    return impl_->encodeInto(depth_values, keyframe, output);
+}
+
+size_t DepthEncoder::encodeInto(const int32_t* depth_values, bool keyframe, Bytes& output) noexcept
+{
+    if (output.size() < impl_->getMaxEncodedSize())
+        output.resize(impl_->getMaxEncodedSize());
+    return impl_->encodeInto(depth_values, keyframe, output);
+}
+
+vector<Bytes> DepthEncoder::encodeBatch(const int32_t* depth_values,
+                                        const vector<bool>& keyframes) noexcept
+{
+    const size_t frame_size{static_cast<size_t>(width_) * height_};
+    vector<Bytes> bytes_list;
+    bytes_list.reserve(keyframes.size());
+    // One buffer gets reused for all frames, so each frame costs only one exact-sized copy.
+    Bytes buffer(impl_->getMaxEncodedSize());
+    for (size_t i{0}; i < keyframes.size(); ++i) {
+        size_t size{impl_->encodeInto(depth_values + i * frame_size, keyframes[i], buffer)};
+        bytes_list.emplace_back(buffer.begin(), buffer.begin() + size);
+    }
+    return bytes_list;
+}
+
+size_t DepthEncoder::encodeBatchInto(const int32_t* depth_values,
+                                     const vector<bool>& keyframes,
+                                     span<uint8_t> output,
+                                     span<size_t> encoded_sizes)
+{
+    const size_t max_encoded_size{impl_->getMaxEncodedSize()};
+    if (output.size() < keyframes.size() * max_encoded_size) {
+        spdlog::error("DepthEncoder::encodeBatchInto: output size ({}) is smaller than {}",
+                      output.size(),
+                      keyframes.size() * max_encoded_size);
+        throw std::runtime_error("Output too small in DepthEncoder::encodeBatchInto");
+    }
+    if (encoded_sizes.size() < keyframes.size()) {
+        spdlog::error("DepthEncoder::encodeBatchInto: encoded_sizes size ({}) is smaller than {}",
+                      encoded_sizes.size(),
+                      keyframes.size());
+        throw std::runtime_error("encoded_sizes too small in DepthEncoder::encodeBatchInto");
+    }
+
+    const size_t frame_size{static_cast<size_t>(width_) * height_};
+    size_t cursor{0};
+    for (size_t i{0}; i < keyframes.size(); ++i) {
+        size_t size{impl_->encodeInto(depth_values + i * frame_size,
+                                      keyframes[i],
+                                      output.subspan(cursor, max_encoded_size))};
+        encoded_sizes[i] = size;
+        cursor += size;
+    }
+    return cursor;
 }
 } // namespace rgbd
\ No newline at end of file
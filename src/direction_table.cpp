@@ -5,6 +5,7 @@
 #include "direction_table.hpp"
 
 #include <cmath>
+#include "calibration_cache.hpp"
 #include <spdlog/spdlog.h>
 
 namespace rgbd
@@ -12,25 +13,14 @@ namespace rgbd
 DirectionTable::DirectionTable(int width, int height, const std::vector<glm::vec3>& directions)
     : width_{width}
     , height_{height}
-    , directions_{directions}
+    , directions_{std::make_shared<const vector<glm::vec3>>(directions)}
 {
 }
 DirectionTable::DirectionTable(const rgbd::CameraCalibration& calibration)
     : width_{calibration.getDepthWidth()}
     , height_{calibration.getDepthHeight()}
-    , directions_{}
+    , directions_{calibration_cache::get_directions(calibration, width_, height_)}
 {
-    directions_.resize(gsl::narrow<size_t>(width_ * height_));
-
-    float u_scale{1.0f / (width_ - 1)};
-    float v_scale{1.0f / (height_ - 1)};
-    for (int row{0}; row < height_; ++row) {
-        for (int col{0}; col < width_; ++col) {
-            float u{col * u_scale};
-            float v{row * v_scale};
-            directions_[col + row * width_] = calibration.getDirection(glm::vec2{u, v});
-        }
-    }
 }
 
 glm::vec3 DirectionTable::getDirection(const glm::vec2& uv) const
@@ -49,10 +39,11 @@ glm::vec3 DirectionTable::getDirection(const glm::vec2& uv) const
     right_col = glm::min(right_col, width_ - 1);
     bottom_row = glm::min(bottom_row, height_ - 1);
 
-    glm::vec3 left_top{directions_[left_col + top_row * width_]};
-    glm::vec3 right_top{directions_[right_col + top_row * width_]};
-    glm::vec3 left_bottom{directions_[left_col + bottom_row * width_]};
-    glm::vec3 right_bottom{directions_[right_col + bottom_row * width_]};
+    const auto& directions{*directions_};
+    glm::vec3 left_top{directions[left_col + top_row * width_]};
+    glm::vec3 right_top{directions[right_col + top_row * width_]};
+    glm::vec3 left_bottom{directions[left_col + bottom_row * width_]};
+    glm::vec3 right_bottom{directions[right_col + bottom_row * width_]};
 
     // Bilinear interpolation
     // ref: https://en.wikipedia.org/wiki/Bilinear_interpolation
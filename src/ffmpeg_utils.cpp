@@ -90,4 +90,34 @@ AVCodecParserContextHandle::AVCodecParserContextHandle(int codec_id)
                 "Error from AVCodecParserContextHandle::AVCodecParserContextHandle");
     }
 }
+
+AVPacketBuffer::AVPacketBuffer()
+    : unique_ptr_{nullptr, [](AVBufferRef* ptr) { av_buffer_unref(&ptr); }}
+{
+}
+
+void AVPacketBuffer::fillPacket(span<const uint8_t> data, AVPacket* packet)
+{
+    const size_t padded_size{data.size() + AV_INPUT_BUFFER_PADDING_SIZE};
+    // Reallocating only when the buffer is too small or a decoder still holds a reference to it.
+    if (!unique_ptr_ || static_cast<size_t>(unique_ptr_->size) < padded_size ||
+        !av_buffer_is_writable(unique_ptr_.get())) {
+        unique_ptr_.reset(av_buffer_alloc(gsl::narrow<int>(padded_size)));
+        if (!unique_ptr_) {
+            spdlog::error("av_buffer_alloc failed in AVPacketBuffer::fillPacket");
+            throw std::runtime_error("av_buffer_alloc failed in AVPacketBuffer::fillPacket");
+        }
+    }
+    memcpy(unique_ptr_->data, data.data(), data.size());
+    memset(unique_ptr_->data + data.size(), 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    av_packet_unref(packet);
+    packet->buf = av_buffer_ref(unique_ptr_.get());
+    if (!packet->buf) {
+        spdlog::error("av_buffer_ref failed in AVPacketBuffer::fillPacket");
+        throw std::runtime_error("av_buffer_ref failed in AVPacketBuffer::fillPacket");
+    }
+    packet->data = unique_ptr_->data;
+    packet->size = gsl::narrow<int>(data.size());
+}
 }
@@ -1,111 +1,242 @@
 #include "frame_mapper.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include "calibration_cache.hpp"
+
 namespace rgbd
 {
-vector<optional<int>> get_index_map(const CameraCalibration& from_calibration,
-                                    int from_width,
-                                    int from_height,
-                                    const CameraCalibration& to_calibration,
-                                    int to_width,
-                                    int to_height)
+vector<int32_t> get_index_map(const vector<glm::vec2>& uv_map, int to_width, int to_height)
 {
     // For mapping from from_calibration indices to to_calibration indices.
-    vector<optional<int>> index_map(from_width * from_height);
-    for (int from_row{0}; from_row < from_height; ++from_row) {
-        for (int from_col{0}; from_col < from_width; ++from_col) {
-            float from_u{from_col / static_cast<float>(from_width - 1)};
-            float from_v{from_row / static_cast<float>(from_height - 1)};
-
-            auto direction{from_calibration.getDirection(glm::vec2{from_u, from_v})};
-            auto to_uv{to_calibration.getUv(direction)};
-            int to_col{static_cast<int>(std::round(to_uv.x * (to_width - 1)))};
-            int to_row{static_cast<int>(std::round(to_uv.y * (to_height - 1)))};
-
-            int from_index{from_col + from_row * from_width};
-            if (to_col < 0 || to_col >= to_width || to_row < 0 || to_row >= to_height) {
-                index_map[from_index] = nullopt;
-            } else {
-                index_map[from_index] = to_col + to_row * to_width;
-            }
+    vector<int32_t> index_map(uv_map.size());
+    for (size_t i{0}; i < uv_map.size(); ++i) {
+        int to_col{static_cast<int>(std::round(uv_map[i].x * (to_width - 1)))};
+        int to_row{static_cast<int>(std::round(uv_map[i].y * (to_height - 1)))};
+
+        if (to_col < 0 || to_col >= to_width || to_row < 0 || to_row >= to_height) {
+            index_map[i] = FrameMapper::INVALID_INDEX;
+        } else {
+            index_map[i] = to_col + to_row * to_width;
         }
     }
     return index_map;
 }
 
+vector<FrameMapper::BilinearSample>
+get_bilinear_map(const vector<glm::vec2>& uv_map, int to_width, int to_height)
+{
+    constexpr float WEIGHT_ONE{1 << FrameMapper::BILINEAR_WEIGHT_BITS};
+    vector<FrameMapper::BilinearSample> bilinear_map(uv_map.size());
+    for (size_t i{0}; i < uv_map.size(); ++i) {
+        float to_col{uv_map[i].x * (to_width - 1)};
+        float to_row{uv_map[i].y * (to_height - 1)};
+
+        // Pixels outside by less than half a pixel are still inside for get_index_map().
+        if (to_col < -0.5f || to_col >= to_width - 0.5f || to_row < -0.5f ||
+            to_row >= to_height - 0.5f) {
+            bilinear_map[i] = FrameMapper::BilinearSample{FrameMapper::INVALID_INDEX, 0, 0};
+            continue;
+        }
+
+        // Clamping so that the four pixels to blend are all inside.
+        // With a single source column or row, it is blended with itself at zero weight.
+        to_col = std::clamp(to_col, 0.0f, static_cast<float>(to_width - 1));
+        to_row = std::clamp(to_row, 0.0f, static_cast<float>(to_height - 1));
+        int left_col{std::max(std::min(static_cast<int>(to_col), to_width - 2), 0)};
+        int top_row{std::max(std::min(static_cast<int>(to_row), to_height - 2), 0)};
+        bilinear_map[i] = FrameMapper::BilinearSample{
+            left_col + top_row * to_width,
+            static_cast<uint16_t>(std::round((to_col - left_col) * WEIGHT_ONE)),
+            static_cast<uint16_t>(std::round((to_row - top_row) * WEIGHT_ONE))};
+    }
+    return bilinear_map;
+}
+
+void map_channel(span<const uint8_t> channel,
+                 const vector<int32_t>& index_map,
+                 uint8_t missing_value,
+                 span<uint8_t> mapped_channel)
+{
+    for (size_t i{0}; i < mapped_channel.size(); ++i) {
+        int32_t index{index_map[i]};
+        mapped_channel[i] = index == FrameMapper::INVALID_INDEX ? missing_value : channel[index];
+    }
+}
+
+void map_channel_bilinear(span<const uint8_t> channel,
+                          int width,
+                          int height,
+                          const vector<FrameMapper::BilinearSample>& bilinear_map,
+                          uint8_t missing_value,
+                          span<uint8_t> mapped_channel)
+{
+    constexpr int WEIGHT_ONE{1 << FrameMapper::BILINEAR_WEIGHT_BITS};
+    constexpr int ROUNDING{1 << (FrameMapper::BILINEAR_WEIGHT_BITS * 2 - 1)};
+    // Samples of a single column or row have zero weights toward the next one, which does not
+    // exist, so they read the same pixel again instead.
+    const int right_offset{width > 1 ? 1 : 0};
+    const int bottom_offset{height > 1 ? width : 0};
+    for (size_t i{0}; i < mapped_channel.size(); ++i) {
+        auto sample{bilinear_map[i]};
+        if (sample.index == FrameMapper::INVALID_INDEX) {
+            mapped_channel[i] = missing_value;
+            continue;
+        }
+
+        const uint8_t* top{&channel[sample.index]};
+        const uint8_t* bottom{top + bottom_offset};
+        int x{sample.x_weight};
+        int y{sample.y_weight};
+        int top_value{top[0] * (WEIGHT_ONE - x) + top[right_offset] * x};
+        int bottom_value{bottom[0] * (WEIGHT_ONE - x) + bottom[right_offset] * x};
+        mapped_channel[i] = static_cast<uint8_t>(
+            (top_value * (WEIGHT_ONE - y) + bottom_value * y + ROUNDING) >>
+            (FrameMapper::BILINEAR_WEIGHT_BITS * 2));
+    }
+}
+
 FrameMapper::FrameMapper(const rgbd::CameraCalibration& src_calibration,
-                         const rgbd::CameraCalibration& dst_calibration)
-    : dst_color_width_{dst_calibration.getColorWidth()}
+                         const rgbd::CameraCalibration& dst_calibration,
+                         FrameMapperSamplingMode sampling_mode)
+    : sampling_mode_{sampling_mode}
+    , src_color_width_{src_calibration.getColorWidth()}
+    , src_color_height_{src_calibration.getColorHeight()}
+    , src_depth_width_{src_calibration.getDepthWidth()}
+    , src_depth_height_{src_calibration.getDepthHeight()}
+    , dst_color_width_{dst_calibration.getColorWidth()}
     , dst_color_height_{dst_calibration.getColorHeight()}
     , dst_depth_width_{dst_calibration.getDepthWidth()}
     , dst_depth_height_{dst_calibration.getDepthHeight()}
-    , y_index_map_{get_index_map(dst_calibration,
-                                 dst_calibration.getColorWidth(),
-                                 dst_calibration.getColorHeight(),
-                                 src_calibration,
-                                 src_calibration.getColorWidth(),
-                                 src_calibration.getColorHeight())}
-    , uv_index_map_{get_index_map(dst_calibration,
-                                  dst_calibration.getColorWidth() / 2,
-                                  dst_calibration.getColorHeight() / 2,
-                                  src_calibration,
-                                  src_calibration.getColorWidth() / 2,
-                                  src_calibration.getColorHeight() / 2)}
-    , depth_index_map_{get_index_map(dst_calibration,
-                                     dst_calibration.getDepthWidth(),
-                                     dst_calibration.getDepthHeight(),
-                                     src_calibration,
-                                     src_calibration.getDepthWidth(),
-                                     src_calibration.getDepthHeight())}
+    , y_index_map_{}
+    , uv_index_map_{}
+    , depth_index_map_{}
+    , y_bilinear_map_{}
+    , uv_bilinear_map_{}
 {
+    // The uv maps come from calibration_cache, so opening files from the same device
+    // skips unprojecting each pixel again.
+    auto y_uv_map{calibration_cache::get_uvs(
+        dst_calibration, dst_color_width_, dst_color_height_, src_calibration)};
+    auto uv_uv_map{calibration_cache::get_uvs(
+        dst_calibration, dst_color_width_ / 2, dst_color_height_ / 2, src_calibration)};
+    if (sampling_mode_ == FrameMapperSamplingMode::Nearest) {
+        y_index_map_ = get_index_map(*y_uv_map, src_color_width_, src_color_height_);
+        uv_index_map_ = get_index_map(*uv_uv_map, src_color_width_ / 2, src_color_height_ / 2);
+    } else if (sampling_mode_ == FrameMapperSamplingMode::Bilinear) {
+        y_bilinear_map_ = get_bilinear_map(*y_uv_map, src_color_width_, src_color_height_);
+        uv_bilinear_map_ =
+            get_bilinear_map(*uv_uv_map, src_color_width_ / 2, src_color_height_ / 2);
+    } else {
+        spdlog::error("Invalid FrameMapperSamplingMode: {}", static_cast<int>(sampling_mode_));
+        throw std::runtime_error("Invalid FrameMapperSamplingMode");
+    }
+
+    depth_index_map_ = get_index_map(
+        *calibration_cache::get_uvs(
+            dst_calibration, dst_depth_width_, dst_depth_height_, src_calibration),
+        src_depth_width_,
+        src_depth_height_);
 }
 
 unique_ptr<YuvFrame> FrameMapper::mapColorFrame(const YuvFrame& color_frame)
 {
-    vector<uint8_t> mapped_y_channel(dst_color_width_ * dst_color_height_);
-    for (size_t i{0}; i < mapped_y_channel.size(); ++i) {
-        auto index{y_index_map_[i]};
-        if (!index) {
-            // Painting missing pixels black.
-            // Black corresponds to y = 0, u = 128, v = 128.
-            mapped_y_channel[i] = 0;
-        } else {
-            mapped_y_channel[i] = color_frame.y_channel()[*index];
-        }
+    auto mapped_color_frame{std::make_unique<YuvFrame>(
+        dst_color_width_,
+        dst_color_height_,
+        vector<uint8_t>(static_cast<size_t>(dst_color_width_) * dst_color_height_),
+        vector<uint8_t>(static_cast<size_t>(dst_color_width_ / 2) * (dst_color_height_ / 2)),
+        vector<uint8_t>(static_cast<size_t>(dst_color_width_ / 2) * (dst_color_height_ / 2)))};
+    mapColorFrameInto(color_frame, *mapped_color_frame);
+    return mapped_color_frame;
+}
+
+unique_ptr<Int32Frame> FrameMapper::mapDepthFrame(const Int32Frame& depth_frame)
+{
+    auto mapped_depth_frame{std::make_unique<Int32Frame>(
+        dst_depth_width_,
+        dst_depth_height_,
+        vector<int32_t>(static_cast<size_t>(dst_depth_width_) * dst_depth_height_))};
+    mapDepthFrameInto(depth_frame, *mapped_depth_frame);
+    return mapped_depth_frame;
+}
+
+void FrameMapper::mapColorFrameInto(const YuvFrame& color_frame, YuvFrame& mapped_color_frame)
+{
+    // The maps index into frames of the source size.
+    if (color_frame.width() != src_color_width_ || color_frame.height() != src_color_height_) {
+        spdlog::error("FrameMapper::mapColorFrameInto: frame size ({}x{}) is not {}x{}",
+                      color_frame.width(),
+                      color_frame.height(),
+                      src_color_width_,
+                      src_color_height_);
+        throw std::runtime_error("Invalid frame size in FrameMapper::mapColorFrameInto");
     }
-    vector<uint8_t> mapped_u_channel(mapped_y_channel.size() / 4);
-    vector<uint8_t> mapped_v_channel(mapped_y_channel.size() / 4);
-    for (size_t i{0}; i < mapped_u_channel.size(); ++i) {
-        auto index{uv_index_map_[i]};
-        if (!index) {
-            // Painting missing pixels black.
-            // Black corresponds to y = 0, u = 128, v = 128.
-            mapped_u_channel[i] = 128;
-            mapped_v_channel[i] = 128;
-        } else {
-            mapped_u_channel[i] = color_frame.u_channel()[*index];
-            mapped_v_channel[i] = color_frame.v_channel()[*index];
-        }
+    if (mapped_color_frame.width() != dst_color_width_ ||
+        mapped_color_frame.height() != dst_color_height_) {
+        spdlog::error("FrameMapper::mapColorFrameInto: mapped frame size ({}x{}) is not {}x{}",
+                      mapped_color_frame.width(),
+                      mapped_color_frame.height(),
+                      dst_color_width_,
+                      dst_color_height_);
+        throw std::runtime_error("Invalid mapped frame size in FrameMapper::mapColorFrameInto");
     }
 
-    return std::make_unique<YuvFrame>(dst_color_width_,
-                                      dst_color_height_,
-                                      std::move(mapped_y_channel),
-                                      std::move(mapped_u_channel),
-                                      std::move(mapped_v_channel));
+    // Painting missing pixels black.
+    // Black corresponds to y = 0, u = 128, v = 128.
+    if (sampling_mode_ == FrameMapperSamplingMode::Nearest) {
+        map_channel(color_frame.y_channel(), y_index_map_, 0, mapped_color_frame.y_channel());
+        map_channel(color_frame.u_channel(), uv_index_map_, 128, mapped_color_frame.u_channel());
+        map_channel(color_frame.v_channel(), uv_index_map_, 128, mapped_color_frame.v_channel());
+    } else {
+        const int uv_width{src_color_width_ / 2};
+        const int uv_height{src_color_height_ / 2};
+        map_channel_bilinear(color_frame.y_channel(),
+                             src_color_width_,
+                             src_color_height_,
+                             y_bilinear_map_,
+                             0,
+                             mapped_color_frame.y_channel());
+        map_channel_bilinear(color_frame.u_channel(),
+                             uv_width,
+                             uv_height,
+                             uv_bilinear_map_,
+                             128,
+                             mapped_color_frame.u_channel());
+        map_channel_bilinear(color_frame.v_channel(),
+                             uv_width,
+                             uv_height,
+                             uv_bilinear_map_,
+                             128,
+                             mapped_color_frame.v_channel());
+    }
 }
 
-unique_ptr<Int32Frame> FrameMapper::mapDepthFrame(const Int32Frame& depth_frame)
+void FrameMapper::mapDepthFrameInto(const Int32Frame& depth_frame, Int32Frame& mapped_depth_frame)
 {
-    vector<int> mapped_depth_values(dst_depth_width_ * dst_depth_height_);
-    for (size_t i{0}; i < mapped_depth_values.size(); ++i) {
-        auto index{depth_index_map_[i]};
-        if (!index) {
-            mapped_depth_values[i] = 0;
-        } else {
-            mapped_depth_values[i] = depth_frame.values()[*index];
-        }
+    if (depth_frame.width() != src_depth_width_ || depth_frame.height() != src_depth_height_) {
+        spdlog::error("FrameMapper::mapDepthFrameInto: frame size ({}x{}) is not {}x{}",
+                      depth_frame.width(),
+                      depth_frame.height(),
+                      src_depth_width_,
+                      src_depth_height_);
+        throw std::runtime_error("Invalid frame size in FrameMapper::mapDepthFrameInto");
+    }
+    if (mapped_depth_frame.width() != dst_depth_width_ ||
+        mapped_depth_frame.height() != dst_depth_height_) {
+        spdlog::error("FrameMapper::mapDepthFrameInto: mapped frame size ({}x{}) is not {}x{}",
+                      mapped_depth_frame.width(),
+                      mapped_depth_frame.height(),
+                      dst_depth_width_,
+                      dst_depth_height_);
+        throw std::runtime_error("Invalid mapped frame size in FrameMapper::mapDepthFrameInto");
     }
 
-    return std::make_unique<Int32Frame>(dst_depth_width_, dst_depth_height_, mapped_depth_values);
+    const int32_t* depth_values{depth_frame.values().data()};
+    int32_t* mapped_depth_values{mapped_depth_frame.values().data()};
+    for (size_t i{0}; i < depth_index_map_.size(); ++i) {
+        int32_t index{depth_index_map_[i]};
+        mapped_depth_values[i] = index == INVALID_INDEX ? 0 : depth_values[index];
+    }
 }
-} // namespace rgbd
\ No newline at end of file
+} // namespace rgbd
@@ -0,0 +1,163 @@
+#include "mmap_io_callback.hpp"
+
+#ifdef CMAKE_RGBD_OS_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rgbd
+{
+#ifdef CMAKE_RGBD_OS_WINDOWS
+MmapFile::MmapFile(const string& file_path)
+    : data_{nullptr}
+    , size_{0}
+    , file_handle_{INVALID_HANDLE_VALUE}
+    , mapping_handle_{nullptr}
+{
+    file_handle_ = CreateFileA(file_path.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               nullptr);
+    if (file_handle_ == INVALID_HANDLE_VALUE)
+        throw std::runtime_error{fmt::format("Failed to open file: {}", file_path)};
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle_, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error{fmt::format("Failed to get size of file: {}", file_path)};
+    }
+    size_ = gsl::narrow<size_t>(file_size.QuadPart);
+
+    mapping_handle_ = CreateFileMappingA(file_handle_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_handle_) {
+        CloseHandle(file_handle_);
+        throw std::runtime_error{fmt::format("Failed to map file: {}", file_path)};
+    }
+
+    data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_) {
+        CloseHandle(mapping_handle_);
+        CloseHandle(file_handle_);
+        throw std::runtime_error{fmt::format("Failed to map file: {}", file_path)};
+    }
+}
+
+MmapFile::~MmapFile()
+{
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_handle_);
+    CloseHandle(file_handle_);
+}
+
+void MmapFile::advise(MmapAdvice) const noexcept
+{
+    // Windows does not have an equivalent of madvise for mapped files.
+}
+#else
+MmapFile::MmapFile(const string& file_path)
+    : data_{nullptr}
+    , size_{0}
+{
+    int fd{open(file_path.c_str(), O_RDONLY)};
+    if (fd < 0)
+        throw std::runtime_error{fmt::format("Failed to open file: {}", file_path)};
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0) {
+        ::close(fd);
+        throw std::runtime_error{fmt::format("Failed to get size of file: {}", file_path)};
+    }
+    size_ = gsl::narrow<size_t>(file_stat.st_size);
+
+    void* data{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0)};
+    // The mapping stays valid after closing the file descriptor.
+    ::close(fd);
+    if (data == MAP_FAILED)
+        throw std::runtime_error{fmt::format("Failed to map file: {}", file_path)};
+
+    data_ = static_cast<const uint8_t*>(data);
+}
+
+MmapFile::~MmapFile()
+{
+    munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+void MmapFile::advise(MmapAdvice advice) const noexcept
+{
+    int posix_advice{MADV_NORMAL};
+    switch (advice) {
+    case MmapAdvice::Normal:
+        posix_advice = MADV_NORMAL;
+        break;
+    case MmapAdvice::Sequential:
+        posix_advice = MADV_SEQUENTIAL;
+        break;
+    case MmapAdvice::Random:
+        posix_advice = MADV_RANDOM;
+        break;
+    }
+    if (madvise(const_cast<uint8_t*>(data_), size_, posix_advice) != 0)
+        spdlog::warn("madvise failed with advice {}", static_cast<int>(advice));
+}
+#endif
+
+MmapIOCallback::MmapIOCallback(shared_ptr<const MmapFile> file)
+    : file_{std::move(file)}
+    , position_{0}
+{
+}
+
+uint32_t MmapIOCallback::read(void* buffer, size_t size)
+{
+    if (position_ >= file_->size())
+        return 0;
+
+    size_t read_size{std::min<size_t>(size, gsl::narrow<size_t>(file_->size() - position_))};
+    memcpy(buffer, file_->data() + position_, read_size);
+    position_ += read_size;
+    return gsl::narrow<uint32_t>(read_size);
+}
+
+void MmapIOCallback::setFilePointer(int64_t offset, libebml::seek_mode mode)
+{
+    int64_t position{0};
+    switch (mode) {
+    case libebml::seek_beginning:
+        position = offset;
+        break;
+    case libebml::seek_current:
+        position = gsl::narrow<int64_t>(position_) + offset;
+        break;
+    case libebml::seek_end:
+        position = gsl::narrow<int64_t>(file_->size()) + offset;
+        break;
+    }
+    // Same as MemReadIOCallback, seeking outside of the file is an error.
+    if (position < 0 || position > gsl::narrow<int64_t>(file_->size()))
+        throw std::runtime_error{fmt::format("Invalid file pointer: {}", position)};
+
+    position_ = gsl::narrow<uint64_t>(position);
+}
+
+size_t MmapIOCallback::write(const void*, size_t)
+{
+    throw std::runtime_error{"MmapIOCallback is read-only"};
+}
+
+uint64_t MmapIOCallback::getFilePointer()
+{
+    return position_;
+}
+
+void MmapIOCallback::close()
+{
+}
+} // namespace rgbd
@@ -0,0 +1,122 @@
+#include "parallel_video_decoder.hpp"
+
+namespace rgbd
+{
+ParallelVideoDecoder::ParallelVideoDecoder(ColorCodecType color_codec_type,
+                                           DepthCodecType depth_codec_type,
+                                           const vector<RecordVideoFrame>& video_frames,
+                                           int thread_count,
+                                           int max_buffered_gops)
+    : color_codec_type_{color_codec_type}
+    , depth_codec_type_{depth_codec_type}
+    , video_frames_{video_frames}
+    , gop_starts_{}
+    , max_buffered_gops_{std::max(max_buffered_gops, 1)}
+    , mutex_{}
+    , condition_variable_{}
+    , next_gop_to_decode_{0}
+    , next_gop_to_deliver_{0}
+    , decoded_gops_{}
+    , worker_exception_{}
+    , stopping_{false}
+    , workers_{}
+{
+    // The first GOP starts at index 0 even when the first frame is not a keyframe
+    // to decode frames the same way a sequential decoder would.
+    for (size_t i{0}; i < video_frames_.size(); ++i) {
+        if (i == 0 || video_frames_[i].keyframe())
+            gop_starts_.push_back(i);
+    }
+
+    for (int i{0}; i < std::max(thread_count, 1); ++i)
+        workers_.emplace_back(&ParallelVideoDecoder::runWorker, this);
+}
+
+ParallelVideoDecoder::~ParallelVideoDecoder()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    condition_variable_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+unique_ptr<VideoFrame> ParallelVideoDecoder::next()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (next_gop_to_deliver_ < gop_starts_.size()) {
+        condition_variable_.wait(lock, [this] {
+            return worker_exception_ || decoded_gops_.count(next_gop_to_deliver_) > 0;
+        });
+        if (worker_exception_)
+            std::rethrow_exception(worker_exception_);
+
+        auto& decoded_gop{decoded_gops_[next_gop_to_deliver_]};
+        if (!decoded_gop.empty()) {
+            auto video_frame{std::move(decoded_gop.front())};
+            decoded_gop.pop_front();
+            return video_frame;
+        }
+
+        // The GOP is fully delivered, so a worker can start decoding another GOP.
+        decoded_gops_.erase(next_gop_to_deliver_);
+        ++next_gop_to_deliver_;
+        condition_variable_.notify_all();
+    }
+
+    return nullptr;
+}
+
+void ParallelVideoDecoder::runWorker()
+{
+    ColorDecoder color_decoder{color_codec_type_};
+    DepthDecoder depth_decoder{depth_codec_type_};
+
+    while (true) {
+        size_t gop_index{0};
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            condition_variable_.wait(lock, [this] {
+                return stopping_ || worker_exception_ ||
+                       (next_gop_to_decode_ < gop_starts_.size() &&
+                        next_gop_to_decode_ <
+                            next_gop_to_deliver_ + static_cast<size_t>(max_buffered_gops_));
+            });
+            if (stopping_ || worker_exception_ || next_gop_to_decode_ >= gop_starts_.size())
+                return;
+
+            gop_index = next_gop_to_decode_++;
+        }
+
+        size_t gop_start{gop_starts_[gop_index]};
+        size_t gop_end{gop_index + 1 < gop_starts_.size() ? gop_starts_[gop_index + 1]
+                                                           : video_frames_.size()};
+        std::deque<unique_ptr<VideoFrame>> decoded_gop;
+        try {
+            for (size_t i{gop_start}; i < gop_end; ++i) {
+                auto& record_video_frame{video_frames_[i]};
+                auto yuv_frame{color_decoder.decode(record_video_frame.color_bytes())};
+                auto depth_frame{depth_decoder.decode(record_video_frame.depth_bytes())};
+                decoded_gop.push_back(std::make_unique<VideoFrame>(record_video_frame.time_point_us(),
+                                                                   record_video_frame.keyframe(),
+                                                                   std::move(yuv_frame),
+                                                                   std::move(depth_frame)));
+            }
+        } catch (std::exception& e) {
+            spdlog::error("ParallelVideoDecoder failed to decode GOP {}: {}", gop_index, e.what());
+            std::lock_guard<std::mutex> lock{mutex_};
+            worker_exception_ = std::current_exception();
+            condition_variable_.notify_all();
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            decoded_gops_[gop_index] = std::move(decoded_gop);
+        }
+        condition_variable_.notify_all();
+    }
+}
+} // namespace rgbd
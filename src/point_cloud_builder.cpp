@@ -0,0 +1,151 @@
+#include "point_cloud_builder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "thread_pool.hpp"
+
+namespace rgbd
+{
+PointCloudBuilder::PointCloudBuilder(const DirectionTable& direction_table,
+                                     float depth_unit,
+                                     int thread_count)
+    : width_{direction_table.width()}
+    , height_{direction_table.height()}
+    , thread_count_{std::max(1, std::min(thread_count, direction_table.height()))}
+    , direction_xs_(direction_table.directions().size())
+    , direction_ys_(direction_table.directions().size())
+    , direction_zs_(direction_table.directions().size())
+    , color_width_{0}
+    , color_height_{0}
+    , y_index_map_{}
+    , uv_index_map_{}
+{
+    const auto& directions{direction_table.directions()};
+    for (size_t i{0}; i < directions.size(); ++i) {
+        direction_xs_[i] = directions[i].x * depth_unit;
+        direction_ys_[i] = directions[i].y * depth_unit;
+        direction_zs_[i] = directions[i].z * depth_unit;
+    }
+}
+
+PointCloudBuilder::PointCloudBuilder(const DirectionTable& direction_table,
+                                     float depth_unit,
+                                     int color_width,
+                                     int color_height,
+                                     int thread_count)
+    : PointCloudBuilder{direction_table, depth_unit, thread_count}
+{
+    color_width_ = color_width;
+    color_height_ = color_height;
+    y_index_map_.resize(point_count());
+    uv_index_map_.resize(point_count());
+
+    // Color and depth frames share their uv coordinates,
+    // so a depth pixel samples the color pixel at the same uv.
+    // A depth frame of a single row or column samples the first row or column of color.
+    const int uv_width{color_width / 2};
+    const float u_scale{width_ > 1 ? 1.0f / (width_ - 1) : 0.0f};
+    const float v_scale{height_ > 1 ? 1.0f / (height_ - 1) : 0.0f};
+    for (int row{0}; row < height_; ++row) {
+        float v{row * v_scale};
+        int color_row{static_cast<int>(std::round(v * (color_height - 1)))};
+        for (int col{0}; col < width_; ++col) {
+            float u{col * u_scale};
+            int color_col{static_cast<int>(std::round(u * (color_width - 1)))};
+            y_index_map_[col + row * width_] = color_col + color_row * color_width;
+            uv_index_map_[col + row * width_] = color_col / 2 + (color_row / 2) * uv_width;
+        }
+    }
+}
+
+void PointCloudBuilder::buildPositions(const Int32Frame& depth_frame, span<float> positions) const
+{
+    if (depth_frame.width() != width_ || depth_frame.height() != height_) {
+        spdlog::error("PointCloudBuilder::buildPositions: depth frame size ({}x{}) is not {}x{}",
+                      depth_frame.width(),
+                      depth_frame.height(),
+                      width_,
+                      height_);
+        throw std::runtime_error("Invalid depth frame size in PointCloudBuilder::buildPositions");
+    }
+    if (positions.size() != point_count() * 3) {
+        spdlog::error("PointCloudBuilder::buildPositions: positions size ({}) is not {}",
+                      positions.size(),
+                      point_count() * 3);
+        throw std::runtime_error("Invalid positions size in PointCloudBuilder::buildPositions");
+    }
+
+    const int32_t* depth_values{depth_frame.values().data()};
+    float* xs{positions.data()};
+    float* ys{xs + point_count()};
+    float* zs{ys + point_count()};
+    forEachBand([&](size_t begin, size_t end) {
+        const float* direction_xs{direction_xs_.data()};
+        const float* direction_ys{direction_ys_.data()};
+        const float* direction_zs{direction_zs_.data()};
+        // A branchless loop over contiguous arrays, for compilers to vectorize.
+        for (size_t i{begin}; i < end; ++i) {
+            float depth{static_cast<float>(depth_values[i])};
+            xs[i] = direction_xs[i] * depth;
+            ys[i] = direction_ys[i] * depth;
+            zs[i] = direction_zs[i] * depth;
+        }
+    });
+}
+
+void PointCloudBuilder::buildColors(const YuvFrame& yuv_frame, span<uint8_t> colors) const
+{
+    if (y_index_map_.empty()) {
+        spdlog::error("PointCloudBuilder::buildColors: no color size was given");
+        throw std::runtime_error("No color size in PointCloudBuilder::buildColors");
+    }
+    if (yuv_frame.width() != color_width_ || yuv_frame.height() != color_height_) {
+        spdlog::error("PointCloudBuilder::buildColors: color frame size ({}x{}) is not {}x{}",
+                      yuv_frame.width(),
+                      yuv_frame.height(),
+                      color_width_,
+                      color_height_);
+        throw std::runtime_error("Invalid color frame size in PointCloudBuilder::buildColors");
+    }
+    if (colors.size() != point_count() * 3) {
+        spdlog::error("PointCloudBuilder::buildColors: colors size ({}) is not {}",
+                      colors.size(),
+                      point_count() * 3);
+        throw std::runtime_error("Invalid colors size in PointCloudBuilder::buildColors");
+    }
+
+    const uint8_t* y_channel{yuv_frame.y_channel().data()};
+    const uint8_t* u_channel{yuv_frame.u_channel().data()};
+    const uint8_t* v_channel{yuv_frame.v_channel().data()};
+    uint8_t* rs{colors.data()};
+    uint8_t* gs{rs + point_count()};
+    uint8_t* bs{gs + point_count()};
+    forEachBand([&](size_t begin, size_t end) {
+        for (size_t i{begin}; i < end; ++i) {
+            int y{y_channel[y_index_map_[i]]};
+            int u{u_channel[uv_index_map_[i]] - 128};
+            int v{v_channel[uv_index_map_[i]] - 128};
+
+            // Same conversion as YuvFrame::getPNGBytes().
+            // from https://en.wikipedia.org/wiki/YUV
+            rs[i] = static_cast<uint8_t>(std::clamp(y + ((351 * v) >> 8), 0, 255));
+            gs[i] = static_cast<uint8_t>(std::clamp(y - ((179 * v + 86 * u) >> 8), 0, 255));
+            bs[i] = static_cast<uint8_t>(std::clamp(y + ((443 * u) >> 8), 0, 255));
+        }
+    });
+}
+
+// Runs function with the range of points of each of thread_count_ bands of rows
+// on the threads of ThreadPool::shared().
+void PointCloudBuilder::forEachBand(const std::function<void(size_t, size_t)>& function) const
+{
+    auto get_band_begin{[this](int band_index) {
+        const int64_t begin_row{static_cast<int64_t>(height_) * band_index / thread_count_};
+        return static_cast<size_t>(width_ * begin_row);
+    }};
+
+    ThreadPool::shared().forEach(thread_count_, [&](int band_index) {
+        function(get_band_begin(band_index), get_band_begin(band_index + 1));
+    });
+}
+} // namespace rgbd
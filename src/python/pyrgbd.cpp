@@ -40,6 +40,23 @@ py::object create_py_vec3(py::module_ glm, const glm::vec3& vec3)
     return glm.attr("vec3")(vec3.x, vec3.y, vec3.z);
 }
 
+// Returns a read-only numpy array pointing to data without copying.
+// owner is the Python object holding data, which the array keeps alive.
+template <class T>
+py::array_t<T>
+create_py_array_view(const T* data, py::array::ShapeContainer shape, py::handle owner)
+{
+    py::array_t<T> array{std::move(shape), data, owner};
+    array.attr("setflags")(py::arg("write") = false);
+    return array;
+}
+
+// Returns a read-only 1D numpy array pointing to values without copying.
+template <class T> py::array_t<T> create_py_vector_view(const vector<T>& values, py::handle owner)
+{
+    return create_py_array_view(values.data(), {gsl::narrow<py::ssize_t>(values.size())}, owner);
+}
+
 PYBIND11_MODULE(pyrgbd, m)
 {
     m.doc() = R"pbdoc(
@@ -54,7 +71,10 @@ PYBIND11_MODULE(pyrgbd, m)
            AudioFrame
            CameraCalibration
            ColorDecoder
+           ColorDecoderOptions
            ColorEncoder
+           ColorEncoderOptions
+           ColorRateControlMode
            CameraCalibrationType
            ColorCodecType
            DepthCodecType
@@ -62,9 +82,12 @@ PYBIND11_MODULE(pyrgbd, m)
            DepthEncoder
            DirectionTable
            FrameMapper
+           FrameMapperSamplingMode
            Int32Frame
            IosCameraCalibration
            MathUtils
+           ParallelVideoDecoder
+           PointCloudBuilder
            RecordOffsets
            RecordInfo
            RecordVideoTrack
@@ -78,12 +101,17 @@ PYBIND11_MODULE(pyrgbd, m)
            RecordVideoFrame
            RecordAudioFrame
            RecordIMUFrame
+           RecordVec3Array
+           RecordIMUSamples
            RecordPoseFrame
            RecordCalibrationFrame
            Record
            RecordBuilder
+           RecordFrameReader
+           RecordFileAccess
            RecordParser
            UndistortedCameraCalibration
+           VideoFrame
            YuvFrame
     )pbdoc";
 
@@ -93,8 +121,9 @@ PYBIND11_MODULE(pyrgbd, m)
         .def("decode",
              [](AudioDecoder& decoder, const Bytes& bytes) {
                  return decoder.decode({bytes.data(), bytes.size()});
-             })
-        .def("decode", &AudioDecoder::decode);
+             },
+             py::call_guard<py::gil_scoped_release>())
+        .def("decode", &AudioDecoder::decode, py::call_guard<py::gil_scoped_release>());
     // END audio_decoder.hpp
 
     // BEGIN audio_encoder.hpp
@@ -104,8 +133,8 @@ PYBIND11_MODULE(pyrgbd, m)
 
     py::class_<AudioEncoder>(m, "AudioEncoder")
         .def(py::init())
-        .def("packet_bytes_list", &AudioEncoder::encode)
-        .def("flush", &AudioEncoder::flush)
+        .def("packet_bytes_list", &AudioEncoder::encode, py::call_guard<py::gil_scoped_release>())
+        .def("flush", &AudioEncoder::flush, py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("codec_context", &AudioEncoder::codec_context)
         .def_property_readonly("next_pts", &AudioEncoder::next_pts);
     // END audio_encoder.hpp
@@ -134,18 +163,87 @@ PYBIND11_MODULE(pyrgbd, m)
     // END camera_calibration.hpp
 
     // BEGIN color_decoder.hpp
+    py::class_<ColorDecoderOptions>(m, "ColorDecoderOptions")
+        .def(py::init())
+        .def_readwrite("thread_count", &ColorDecoderOptions::thread_count);
+
     py::class_<ColorDecoder>(m, "ColorDecoder")
         .def(py::init<ColorCodecType>())
-        .def("decode", [](ColorDecoder& decoder, const Bytes& bytes) {
-            auto yuv_frame{decoder.decode({bytes.data(), bytes.size()})};
-            return YuvFrame{std::move(*yuv_frame)};
-        });
+        .def(py::init<ColorCodecType, const ColorDecoderOptions&>())
+        .def(
+            "decode",
+            [](ColorDecoder& decoder, const Bytes& bytes) {
+                auto yuv_frame{decoder.decode({bytes.data(), bytes.size()})};
+                return YuvFrame{std::move(*yuv_frame)};
+            },
+            py::call_guard<py::gil_scoped_release>());
     // END color_decoder.hpp
 
     // BEGIN color_encoder.hpp
+    py::enum_<ColorRateControlMode>(m, "ColorRateControlMode")
+        .value("CBR", ColorRateControlMode::CBR)
+        .value("VBR", ColorRateControlMode::VBR)
+        .value("CQ", ColorRateControlMode::CQ);
+
+    py::class_<ColorEncoderOptions>(m, "ColorEncoderOptions")
+        .def(py::init())
+        .def_readwrite("rate_control_mode", &ColorEncoderOptions::rate_control_mode)
+        .def_readwrite("thread_count", &ColorEncoderOptions::thread_count)
+        .def_readwrite("deadline", &ColorEncoderOptions::deadline)
+        .def_readwrite("cpu_used", &ColorEncoderOptions::cpu_used)
+        .def_readwrite("target_bitrate_kbps", &ColorEncoderOptions::target_bitrate_kbps)
+        .def_readwrite("cq_level", &ColorEncoderOptions::cq_level)
+        .def_readwrite("keyframe_interval", &ColorEncoderOptions::keyframe_interval);
+
     py::class_<ColorEncoder>(m, "ColorEncoder")
         .def(py::init<ColorCodecType, int, int>())
-        .def("encode", &ColorEncoder::encode);
+        .def(py::init<ColorCodecType, int, int, const ColorEncoderOptions&>())
+        .def("encode",
+             &ColorEncoder::encode,
+             py::arg("yuv_frame"),
+             py::arg("keyframe"),
+             py::arg("time_point_us") = std::nullopt,
+             py::call_guard<py::gil_scoped_release>())
+        .def("encode_planes",
+             [](ColorEncoder& encoder,
+                const py::array_t<uint8_t> y_array,
+                const py::array_t<uint8_t> u_array,
+                const py::array_t<uint8_t> v_array,
+                bool keyframe,
+                optional<int64_t> time_point_us) {
+                 // Rows may be strided (e.g., slices of a larger array), but pixels in a row
+                 // should be contiguous.
+                 for (auto array : {&y_array, &u_array, &v_array}) {
+                     if (array->ndim() != 2 || array->strides(1) != 1)
+                         throw std::runtime_error("Planes should be 2D with contiguous rows.");
+                 }
+                 // encodePlanes reads the planes by the resolution of the encoder,
+                 // so smaller planes would get read out of bounds.
+                 const int width{encoder.codec_context()->width};
+                 const int height{encoder.codec_context()->height};
+                 if (y_array.shape(0) < height || y_array.shape(1) < width)
+                     throw std::runtime_error("y_array is smaller than the encoder resolution.");
+                 for (auto array : {&u_array, &v_array}) {
+                     if (array->shape(0) < height / 2 || array->shape(1) < width / 2)
+                         throw std::runtime_error("u_array or v_array is smaller than half the "
+                                                  "encoder resolution.");
+                 }
+                 py::gil_scoped_release release;
+                 return encoder.encodePlanes(y_array.data(),
+                                             gsl::narrow<int>(y_array.strides(0)),
+                                             u_array.data(),
+                                             gsl::narrow<int>(u_array.strides(0)),
+                                             v_array.data(),
+                                             gsl::narrow<int>(v_array.strides(0)),
+                                             keyframe,
+                                             time_point_us);
+             },
+             py::arg("y_array"),
+             py::arg("u_array"),
+             py::arg("v_array"),
+             py::arg("keyframe"),
+             py::arg("time_point_us") = std::nullopt)
+        .def_property_readonly("last_keyframe", &ColorEncoder::last_keyframe);
     // END color_encoder.hpp
 
     // BEGIN constants.hpp
@@ -158,7 +256,8 @@ PYBIND11_MODULE(pyrgbd, m)
 
     py::enum_<DepthCodecType>(m, "DepthCodecType")
         .value("RVL", DepthCodecType::RVL)
-        .value("TDC1", DepthCodecType::TDC1);
+        .value("TDC1", DepthCodecType::TDC1)
+        .value("RVL_MT", DepthCodecType::RVL_MT);
 
     m.attr("VIDEO_FRAME_RATE") = VIDEO_FRAME_RATE;
     m.attr("AUDIO_SAMPLE_RATE") = AUDIO_SAMPLE_RATE;
@@ -168,47 +267,126 @@ PYBIND11_MODULE(pyrgbd, m)
     // BEGIN depth_decoder.hpp
     py::class_<DepthDecoder>(m, "DepthDecoder")
         .def(py::init<DepthCodecType>())
-        .def("decode", [](DepthDecoder& decoder, const Bytes& bytes) {
-            auto depth_frame{decoder.decode({bytes.data(), bytes.size()})};
-            return Int32Frame{std::move(*depth_frame)};
-        });
+        .def(
+            "decode",
+            [](DepthDecoder& decoder, const Bytes& bytes) {
+                auto depth_frame{decoder.decode({bytes.data(), bytes.size()})};
+                return Int32Frame{std::move(*depth_frame)};
+            },
+            py::call_guard<py::gil_scoped_release>())
+        .def("decode_into",
+             [](DepthDecoder& decoder, const Bytes& bytes, py::array output) {
+                 // Taking py::array_t would let pybind11 convert output into a temporary copy
+                 // (e.g., from float, int64, or a strided view), which would get the depth
+                 // values instead of output.
+                 using OutputArray = py::array_t<int32_t, py::array::c_style>;
+                 if (!py::isinstance<OutputArray>(output))
+                     throw std::runtime_error("output should be a C-contiguous int32 array.");
+                 auto output_array{output.cast<OutputArray>()};
+
+                 if (bytes.size() < sizeof(int32_t) * 2)
+                     throw std::runtime_error("bytes is too short for a depth frame.");
+                 int cursor{0};
+                 int width{read_from_bytes<int32_t>(bytes, cursor)};
+                 int height{read_from_bytes<int32_t>(bytes, cursor)};
+                 if (output_array.size() != static_cast<py::ssize_t>(width) * height)
+                     throw std::runtime_error("output should have width * height elements.");
+
+                 span<int32_t> output_values{output_array.mutable_data(),
+                                             static_cast<size_t>(output_array.size())};
+                 py::gil_scoped_release release;
+                 decoder.decodeInto({bytes.data(), bytes.size()}, output_values);
+             })
+        .def("decode_batch",
+             [](DepthDecoder& decoder, const vector<Bytes>& bytes_list, int width, int height) {
+                 py::array_t<int32_t> array(
+                     {static_cast<py::ssize_t>(bytes_list.size()),
+                      static_cast<py::ssize_t>(height),
+                      static_cast<py::ssize_t>(width)});
+                 span<int32_t> output{array.mutable_data(), static_cast<size_t>(array.size())};
+                 vector<span<const uint8_t>> byte_spans;
+                 byte_spans.reserve(bytes_list.size());
+                 for (auto& bytes : bytes_list)
+                     byte_spans.push_back({bytes.data(), bytes.size()});
+                 {
+                     py::gil_scoped_release release;
+                     decoder.decodeBatchInto(byte_spans, output);
+                 }
+                 return array;
+             });
     // END depth_decoder.hpp
 
     // BEGIN depth_encoder.hpp
     py::class_<DepthEncoder>(m, "DepthEncoder")
         .def(py::init<DepthCodecType, int, int>())
         .def_property_readonly("codec_type", &DepthEncoder::getCodecType)
+        .def_property_readonly("width", &DepthEncoder::width)
+        .def_property_readonly("height", &DepthEncoder::height)
         .def("encode",
              [](DepthEncoder& encoder, const py::array_t<int32_t> depth_array, bool keyframe) {
                  py::buffer_info depth_buffer{depth_array.request()};
+                 py::gil_scoped_release release;
                  return encoder.encode(static_cast<int32_t*>(depth_buffer.ptr), keyframe);
+             })
+        .def("encode_batch",
+             [](DepthEncoder& encoder,
+                const py::array_t<int32_t, py::array::c_style | py::array::forcecast> depth_array,
+                const vector<bool>& keyframes) {
+                 py::buffer_info depth_buffer{depth_array.request()};
+                 if (depth_buffer.ndim != 3 ||
+                     depth_buffer.shape[0] != static_cast<py::ssize_t>(keyframes.size()) ||
+                     depth_buffer.shape[1] != encoder.height() ||
+                     depth_buffer.shape[2] != encoder.width())
+                     throw std::runtime_error("depth_array should be (len(keyframes), H, W)");
+                 const int32_t* depth_values{static_cast<int32_t*>(depth_buffer.ptr)};
+                 vector<Bytes> bytes_list;
+                 {
+                     py::gil_scoped_release release;
+                     bytes_list = encoder.encodeBatch(depth_values, keyframes);
+                 }
+                 return bytes_list;
              });
     // END depth_encoder.hpp
 
     // BEGIN direction_table.hpp
     py::class_<DirectionTable>(m, "DirectionTable")
+        .def(py::init<const CameraCalibration&>(), py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("width", &DirectionTable::width)
         .def_property_readonly("height", &DirectionTable::height)
-        .def("get_directions", [](const DirectionTable& direction_table) {
-            auto directions{direction_table.directions()};
-            py::array_t<float> array(directions.size() * 3);
-            auto buffer{array.request()};
-            float* ptr{static_cast<float*>(buffer.ptr)};
-            for (size_t i{0}; i < directions.size(); ++i) {
-                ptr[i * 3 + 0] = directions[i].x;
-                ptr[i * 3 + 1] = directions[i].y;
-                ptr[i * 3 + 2] = directions[i].z;
-            }
-            array = array.reshape({direction_table.height(), direction_table.width(), 3});
-            return array;
+        .def("get_directions", [](py::object self) {
+            // glm::vec3 is three packed floats, so the directions can be viewed as
+            // a (height, width, 3) float array.
+            static_assert(sizeof(glm::vec3) == sizeof(float) * 3);
+            auto& direction_table{self.cast<const DirectionTable&>()};
+            return create_py_array_view(
+                &direction_table.directions()[0].x,
+                {direction_table.height(), direction_table.width(), 3},
+                self);
         });
     // END depth_encoder.hpp
 
     // BEGIN frame_mapper.hpp
+    py::enum_<FrameMapperSamplingMode>(m, "FrameMapperSamplingMode")
+        .value("Nearest", FrameMapperSamplingMode::Nearest)
+        .value("Bilinear", FrameMapperSamplingMode::Bilinear);
+
     py::class_<FrameMapper>(m, "FrameMapper")
         .def(py::init<const rgbd::CameraCalibration&, const rgbd::CameraCalibration&>())
-        .def("map_color_frame", &FrameMapper::mapColorFrame)
-        .def("map_depth_frame", &FrameMapper::mapDepthFrame);
+        .def(py::init<const rgbd::CameraCalibration&,
+                      const rgbd::CameraCalibration&,
+                      FrameMapperSamplingMode>())
+        .def("map_color_frame",
+             &FrameMapper::mapColorFrame,
+             py::call_guard<py::gil_scoped_release>())
+        .def("map_depth_frame",
+             &FrameMapper::mapDepthFrame,
+             py::call_guard<py::gil_scoped_release>())
+        .def("map_color_frame_into",
+             &FrameMapper::mapColorFrameInto,
+             py::call_guard<py::gil_scoped_release>())
+        .def("map_depth_frame_into",
+             &FrameMapper::mapDepthFrameInto,
+             py::call_guard<py::gil_scoped_release>());
     // END frame_mapper.hpp
 
     // BEGIN integer_frame.hpp
@@ -221,11 +399,12 @@ PYBIND11_MODULE(pyrgbd, m)
         }))
         .def_property_readonly("width", &Int32Frame::width)
         .def_property_readonly("height", &Int32Frame::height)
-        .def("get_values", [](const Int32Frame& frame) {
-            py::array_t<int32_t> array(frame.values().size(), frame.values().data());
-            array = array.reshape({frame.height(), frame.width()});
-            return array;
-        })
+        .def("get_values",
+             [](py::object self) {
+                 auto& frame{self.cast<const Int32Frame&>()};
+                 return create_py_array_view(
+                     frame.values().data(), {frame.height(), frame.width()}, self);
+             })
         .def(py::pickle(
             [](const Int32Frame& frame) { // dump
                 return py::make_tuple(frame.width(), frame.height(), frame.values());
@@ -291,6 +470,62 @@ PYBIND11_MODULE(pyrgbd, m)
                     
     // END math_utils.hpp
 
+    // BEGIN parallel_video_decoder.hpp
+    py::class_<ParallelVideoDecoder>(m, "ParallelVideoDecoder")
+        .def(py::init<ColorCodecType, DepthCodecType, const vector<RecordVideoFrame>&, int, int>())
+        .def("next", &ParallelVideoDecoder::next, py::call_guard<py::gil_scoped_release>())
+        .def("__iter__",
+             [](ParallelVideoDecoder& decoder) -> ParallelVideoDecoder& { return decoder; })
+        .def("__next__", [](ParallelVideoDecoder& decoder) {
+            unique_ptr<VideoFrame> video_frame;
+            {
+                py::gil_scoped_release release;
+                video_frame = decoder.next();
+            }
+            if (!video_frame)
+                throw py::stop_iteration();
+            return video_frame;
+        });
+    // END parallel_video_decoder.hpp
+
+    // BEGIN point_cloud_builder.hpp
+    py::class_<PointCloudBuilder>(m, "PointCloudBuilder")
+        .def(py::init<const DirectionTable&, float, int>(),
+             py::arg("direction_table"),
+             py::arg("depth_unit"),
+             py::arg("thread_count") = 1)
+        .def(py::init<const DirectionTable&, float, int, int, int>(),
+             py::arg("direction_table"),
+             py::arg("depth_unit"),
+             py::arg("color_width"),
+             py::arg("color_height"),
+             py::arg("thread_count") = 1)
+        .def_property_readonly("width", &PointCloudBuilder::width)
+        .def_property_readonly("height", &PointCloudBuilder::height)
+        .def_property_readonly("point_count", &PointCloudBuilder::point_count)
+        // Returns positions as a (3, height, width) array of x, y, and z.
+        .def("build_positions",
+             [](const PointCloudBuilder& builder, const Int32Frame& depth_frame) {
+                 py::array_t<float> array({3, builder.height(), builder.width()});
+                 span<float> positions{array.mutable_data(), static_cast<size_t>(array.size())};
+                 {
+                     py::gil_scoped_release release;
+                     builder.buildPositions(depth_frame, positions);
+                 }
+                 return array;
+             })
+        // Returns colors as a (3, height, width) array of r, g, and b.
+        .def("build_colors", [](const PointCloudBuilder& builder, const YuvFrame& yuv_frame) {
+            py::array_t<uint8_t> array({3, builder.height(), builder.width()});
+            span<uint8_t> colors{array.mutable_data(), static_cast<size_t>(array.size())};
+            {
+                py::gil_scoped_release release;
+                builder.buildColors(yuv_frame, colors);
+            }
+            return array;
+        });
+    // END point_cloud_builder.hpp
+
     // BEGIN record.hpp
     py::class_<RecordOffsets>(m, "RecordOffsets")
         .def(py::init())
@@ -331,6 +566,7 @@ PYBIND11_MODULE(pyrgbd, m)
         .def_readwrite("color_track", &RecordTracks::color_track)
         .def_readwrite("depth_track", &RecordTracks::depth_track)
         .def_readwrite("audio_track", &RecordTracks::audio_track)
+        .def_readwrite("imu_track_number", &RecordTracks::imu_track_number)
         .def_readwrite("acceleration_track_number", &RecordTracks::acceleration_track_number)
         .def_readwrite("rotation_rate_track_number", &RecordTracks::rotation_rate_track_number)
         .def_readwrite("magnetic_field_track_number", &RecordTracks::magnetic_field_track_number)
@@ -348,7 +584,8 @@ PYBIND11_MODULE(pyrgbd, m)
         .value("Video", RecordFrameType::Video)
         .value("Audio", RecordFrameType::Audio)
         .value("IMU", RecordFrameType::IMU)
-        .value("Pose", RecordFrameType::Pose);
+        .value("Pose", RecordFrameType::Pose)
+        .value("Calibration", RecordFrameType::Calibration);
 
     py::class_<RecordFrame>(m, "RecordFrame").def("getType", &RecordFrame::getType);
 
@@ -356,13 +593,23 @@ PYBIND11_MODULE(pyrgbd, m)
         .def(py::init<int64_t, bool, const Bytes&, const Bytes&>())
         .def_property_readonly("time_point_us", &RecordVideoFrame::time_point_us)
         .def_property_readonly("keyframe", &RecordVideoFrame::keyframe)
-        .def("get_color_bytes", &RecordVideoFrame::color_bytes, py::return_value_policy::copy)
-        .def("get_depth_bytes", &RecordVideoFrame::depth_bytes, py::return_value_policy::copy);
+        .def("get_color_bytes",
+             [](const RecordVideoFrame& frame) {
+                 auto color_bytes{frame.color_bytes()};
+                 return Bytes(color_bytes.begin(), color_bytes.end());
+             })
+        .def("get_depth_bytes", [](const RecordVideoFrame& frame) {
+            auto depth_bytes{frame.depth_bytes()};
+            return Bytes(depth_bytes.begin(), depth_bytes.end());
+        });
 
     py::class_<RecordAudioFrame, RecordFrame>(m, "RecordAudioFrame")
         .def(py::init<int64_t, const Bytes&>())
         .def_property_readonly("time_point_us", &RecordAudioFrame::time_point_us)
-        .def("get_bytes", &RecordAudioFrame::bytes, py::return_value_policy::copy);
+        .def("get_bytes", [](const RecordAudioFrame& frame) {
+            auto bytes{frame.bytes()};
+            return Bytes(bytes.begin(), bytes.end());
+        });
 
     py::class_<RecordIMUFrame, RecordFrame>(m, "RecordIMUFrame")
         .def(py::init([](int64_t time_point_us,
@@ -402,6 +649,36 @@ PYBIND11_MODULE(pyrgbd, m)
             return create_py_vec3(glm, frame.gravity());
         });
 
+    py::class_<RecordVec3Array>(m, "RecordVec3Array")
+        .def_property_readonly("x",
+                               [](py::object self) {
+                                   auto& array{self.cast<const RecordVec3Array&>()};
+                                   return create_py_vector_view(array.x, self);
+                               })
+        .def_property_readonly("y",
+                               [](py::object self) {
+                                   auto& array{self.cast<const RecordVec3Array&>()};
+                                   return create_py_vector_view(array.y, self);
+                               })
+        .def_property_readonly("z", [](py::object self) {
+            auto& array{self.cast<const RecordVec3Array&>()};
+            return create_py_vector_view(array.z, self);
+        });
+
+    // The arrays are views into the samples, which they keep alive.
+    py::class_<RecordIMUSamples>(m, "RecordIMUSamples")
+        .def("__len__", &RecordIMUSamples::size)
+        .def_property_readonly("time_points_us",
+                               [](py::object self) {
+                                   auto& samples{self.cast<const RecordIMUSamples&>()};
+                                   return create_py_vector_view(samples.time_points_us, self);
+                               })
+        .def_readonly("acceleration", &RecordIMUSamples::acceleration)
+        .def_readonly("rotation_rate", &RecordIMUSamples::rotation_rate)
+        .def_readonly("magnetic_field", &RecordIMUSamples::magnetic_field)
+        .def_readonly("gravity", &RecordIMUSamples::gravity)
+        .def("get_frame", &RecordIMUSamples::getFrame);
+
     py::class_<RecordPoseFrame, RecordFrame>(m, "RecordPoseFrame")
         .def(py::init([](int64_t time_point_us,
                          const py::object& py_translation,
@@ -455,14 +732,60 @@ PYBIND11_MODULE(pyrgbd, m)
         .def("add_imu_frame", &RecordBuilder::addIMUFrame)
         .def("add_pose_frame", &RecordBuilder::addPoseFrame)
         .def("add_calibration_frame", &RecordBuilder::addCalibrationFrame)
-        .def("build_to_bytes", &RecordBuilder::buildToBytes)
-        .def("build_to_path", &RecordBuilder::buildToPath);
+        .def("build_to_bytes",
+             &RecordBuilder::buildToBytes,
+             py::call_guard<py::gil_scoped_release>())
+        .def("build_to_path",
+             &RecordBuilder::buildToPath,
+             py::call_guard<py::gil_scoped_release>());
     // END record_builder.hpp
 
+    // BEGIN record_frame_reader.hpp
+    py::class_<RecordFrameReader>(m, "RecordFrameReader")
+        .def(py::init<const string&>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const string&, RecordFileAccess>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("get_offsets", &RecordFrameReader::offsets, py::return_value_policy::copy)
+        .def("get_info", &RecordFrameReader::info, py::return_value_policy::copy)
+        .def("get_tracks", &RecordFrameReader::tracks, py::return_value_policy::copy)
+        .def("get_attachments", &RecordFrameReader::attachments, py::return_value_policy::copy)
+        .def("next", &RecordFrameReader::next, py::call_guard<py::gil_scoped_release>())
+        .def("reset", &RecordFrameReader::reset, py::call_guard<py::gil_scoped_release>())
+        .def("seek_to_time_point",
+             &RecordFrameReader::seekToTimePoint,
+             py::call_guard<py::gil_scoped_release>())
+        .def("__iter__", [](RecordFrameReader& reader) -> RecordFrameReader& { return reader; })
+        .def("__next__", [](RecordFrameReader& reader) {
+            unique_ptr<RecordFrame> frame;
+            {
+                py::gil_scoped_release release;
+                frame = reader.next();
+            }
+            if (!frame)
+                throw py::stop_iteration();
+            return frame;
+        });
+    // END record_frame_reader.hpp
+
     // BEGIN record_parser.hpp
+    py::enum_<RecordFileAccess>(m, "RecordFileAccess")
+        .value("Read", RecordFileAccess::Read)
+        .value("MemoryMap", RecordFileAccess::MemoryMap);
+
     py::class_<RecordParser>(m, "RecordParser")
-        .def(py::init<const string&>())
-        .def("parse", &RecordParser::parse);
+        .def(py::init<const string&>(), py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const string&, RecordFileAccess>(),
+             py::call_guard<py::gil_scoped_release>())
+        .def("parse", &RecordParser::parse, py::call_guard<py::gil_scoped_release>())
+        .def("parse_next_frame",
+             &RecordParser::parseNextFrame,
+             py::call_guard<py::gil_scoped_release>())
+        .def("seek_to_time_point",
+             &RecordParser::seekToTimePoint,
+             py::call_guard<py::gil_scoped_release>())
+        .def("parse_imu_samples",
+             &RecordParser::parseIMUSamples,
+             py::call_guard<py::gil_scoped_release>());
     // END record_parser.hpp
 
     // BEGIN undistorted_camera_distortion.hpp
@@ -476,6 +799,20 @@ PYBIND11_MODULE(pyrgbd, m)
         .def_property_readonly("cy", &UndistortedCameraCalibration::cy);
     // END undistorted_camera_distortion.hpp
 
+    // BEGIN video_frame.hpp
+    py::class_<VideoFrame>(m, "VideoFrame")
+        .def_property_readonly("time_point_us", &VideoFrame::time_point_us)
+        .def_property_readonly("keyframe", &VideoFrame::keyframe)
+        .def_property_readonly(
+            "yuv_frame",
+            [](const VideoFrame& frame) { return frame.yuv_frame().get(); },
+            py::return_value_policy::reference_internal)
+        .def_property_readonly(
+            "depth_frame",
+            [](const VideoFrame& frame) { return frame.depth_frame().get(); },
+            py::return_value_policy::reference_internal);
+    // END video_frame.hpp
+
     // BEGIN yuv_frame.hpp
     py::class_<YuvFrame>(m, "YuvFrame")
         .def(py::init([](const py::array_t<uint8_t> y_array,
@@ -495,29 +832,34 @@ PYBIND11_MODULE(pyrgbd, m)
         .def_property_readonly("width", &YuvFrame::width)
         .def_property_readonly("height", &YuvFrame::height)
         .def("get_y_channel",
-             [](const YuvFrame& frame) {
-                 py::array_t<uint8_t> y_array(frame.y_channel().size(), frame.y_channel().data());
-                 y_array = y_array.reshape({frame.height(), frame.width()});
-                 return y_array;
+             [](py::object self) {
+                 auto& frame{self.cast<const YuvFrame&>()};
+                 return create_py_array_view(
+                     frame.y_channel().data(), {frame.height(), frame.width()}, self);
              })
         .def("get_u_channel",
-             [](const YuvFrame& frame) {
-                 py::array_t<uint8_t> u_array(frame.u_channel().size(), frame.u_channel().data());
-                 u_array = u_array.reshape({frame.height() / 2, frame.width() / 2});
-                 return u_array;
+             [](py::object self) {
+                 auto& frame{self.cast<const YuvFrame&>()};
+                 return create_py_array_view(
+                     frame.u_channel().data(), {frame.height() / 2, frame.width() / 2}, self);
              })
         .def("get_v_channel",
-             [](const YuvFrame& frame) {
-                 py::array_t<uint8_t> v_array(frame.v_channel().size(), frame.v_channel().data());
-                 v_array = v_array.reshape({frame.height() / 2, frame.width() / 2});
-                 return v_array;
-             })
-        .def("get_mkv_cover_sized",
-             [](const YuvFrame& frame) {
-                 auto mkv_cover_sized{frame.getMkvCoverSized()};
-                 return YuvFrame{std::move(*mkv_cover_sized)};
+             [](py::object self) {
+                 auto& frame{self.cast<const YuvFrame&>()};
+                 return create_py_array_view(
+                     frame.v_channel().data(), {frame.height() / 2, frame.width() / 2}, self);
              })
-        .def("get_png_bytes", [](const YuvFrame& frame) { return frame.getPNGBytes(); })
+        .def(
+            "get_mkv_cover_sized",
+            [](const YuvFrame& frame) {
+                auto mkv_cover_sized{frame.getMkvCoverSized()};
+                return YuvFrame{std::move(*mkv_cover_sized)};
+            },
+            py::call_guard<py::gil_scoped_release>())
+        .def(
+            "get_png_bytes",
+            [](const YuvFrame& frame) { return frame.getPNGBytes(); },
+            py::call_guard<py::gil_scoped_release>())
         .def(py::pickle(
             [](const YuvFrame& frame) { // dump
                 return py::make_tuple(frame.width(), frame.height(),
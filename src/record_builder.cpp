@@ -1,5 +1,8 @@
 #include "record_builder.hpp"
 
+#include "buffered_file_io_callback.hpp"
+#include "chunked_mem_io_callback.hpp"
+
 namespace rgbd
 {
 RecordBuilder::RecordBuilder()
@@ -8,11 +11,19 @@ RecordBuilder::RecordBuilder()
     , depth_codec_type_{DepthCodecType::TDC1}
     , depth_unit_{DEFAULT_DEPTH_UNIT}
     , cover_png_bytes_{std::nullopt}
+    , cluster_policy_{}
     , video_frames_{}
     , audio_frames_{}
     , imu_frames_{}
     , pose_frames_{}
     , calibration_frames_{}
+    , streaming_io_callback_owner_{}
+    , streaming_writer_{}
+    , reorder_window_us_{0}
+    , pending_frames_{}
+    , latest_time_point_us_{nullopt}
+    , last_written_time_point_us_{nullopt}
+    , initial_video_time_point_us_{nullopt}
 {
 }
 
@@ -41,48 +52,263 @@ void RecordBuilder::setCoverPNGBytes(const optional<Bytes>& cover_png_bytes)
     cover_png_bytes_ = cover_png_bytes;
 }
 
+void RecordBuilder::setClusterPolicy(const RecordWriterClusterPolicy& cluster_policy)
+{
+    cluster_policy_ = cluster_policy;
+}
+
 void RecordBuilder::addVideoFrame(const RecordVideoFrame& video_frame)
 {
+    if (streaming_writer_) {
+        addStreamingFrame(video_frame.time_point_us(),
+                          std::make_unique<RecordVideoFrame>(video_frame));
+        return;
+    }
     video_frames_.push_back(video_frame);
 }
 
 void RecordBuilder::addAudioFrame(const RecordAudioFrame& audio_frame)
 {
+    if (streaming_writer_) {
+        addStreamingFrame(audio_frame.time_point_us(),
+                          std::make_unique<RecordAudioFrame>(audio_frame));
+        return;
+    }
     audio_frames_.push_back(audio_frame);
 }
 
 void RecordBuilder::addIMUFrame(const RecordIMUFrame& imu_frame)
 {
+    if (streaming_writer_) {
+        addStreamingFrame(imu_frame.time_point_us(),
+                          std::make_unique<RecordIMUFrame>(imu_frame));
+        return;
+    }
     imu_frames_.push_back(imu_frame);
 }
 
 void RecordBuilder::addPoseFrame(const RecordPoseFrame& pose_frame)
 {
+    if (streaming_writer_) {
+        addStreamingFrame(pose_frame.time_point_us(),
+                          std::make_unique<RecordPoseFrame>(pose_frame));
+        return;
+    }
     pose_frames_.push_back(pose_frame);
 }
 
 void RecordBuilder::addCalibrationFrame(const RecordCalibrationFrame& calibration_frame)
 {
+    if (streaming_writer_) {
+        addStreamingFrame(calibration_frame.time_point_us(),
+                          std::make_unique<RecordCalibrationFrame>(calibration_frame));
+        return;
+    }
     calibration_frames_.push_back(calibration_frame);
 }
 
 Bytes RecordBuilder::buildToBytes()
 {
-    MemIOCallback io_callback;
-    _build(io_callback);
+    if (streaming_writer_) {
+        spdlog::error("RecordBuilder::buildToBytes: cannot build while streaming.");
+        throw std::runtime_error{"RecordBuilder::buildToBytes: cannot build while streaming."};
+    }
 
-    uint64_t size{io_callback.GetDataBufferSize()};
-    Bytes bytes(size);
-    memcpy(bytes.data(), io_callback.GetDataBuffer(), size);
-    return bytes;
+    ChunkedMemIOCallback io_callback;
+    _build(io_callback);
+    return io_callback.toBytes();
 }
 
 void RecordBuilder::buildToPath(const std::string& path)
 {
-    StdIOCallback io_callback{path.c_str(), MODE_CREATE};
+    if (streaming_writer_) {
+        spdlog::error("RecordBuilder::buildToPath: cannot build while streaming.");
+        throw std::runtime_error{"RecordBuilder::buildToPath: cannot build while streaming."};
+    }
+
+    BufferedFileIOCallback io_callback{path};
     _build(io_callback);
 }
 
+void RecordBuilder::startStreaming(IOCallback& io_callback, int64_t reorder_window_us)
+{
+    checkStreamingStart();
+
+    streaming_writer_ = std::make_unique<RecordWriter>(io_callback,
+                                                       sample_rate_,
+                                                       depth_codec_type_,
+                                                       depth_unit_,
+                                                       *calibration_,
+                                                       cover_png_bytes_,
+                                                       cluster_policy_);
+    reorder_window_us_ = std::max<int64_t>(reorder_window_us, 0);
+    latest_time_point_us_ = nullopt;
+    last_written_time_point_us_ = nullopt;
+    initial_video_time_point_us_ = nullopt;
+
+    // Frames added before streaming get streamed too.
+    for (auto& video_frame : video_frames_)
+        addStreamingFrame(video_frame.time_point_us(),
+                          std::make_unique<RecordVideoFrame>(std::move(video_frame)));
+    for (auto& audio_frame : audio_frames_)
+        addStreamingFrame(audio_frame.time_point_us(),
+                          std::make_unique<RecordAudioFrame>(std::move(audio_frame)));
+    for (auto& imu_frame : imu_frames_)
+        addStreamingFrame(imu_frame.time_point_us(),
+                          std::make_unique<RecordIMUFrame>(std::move(imu_frame)));
+    for (auto& pose_frame : pose_frames_)
+        addStreamingFrame(pose_frame.time_point_us(),
+                          std::make_unique<RecordPoseFrame>(std::move(pose_frame)));
+    for (auto& calibration_frame : calibration_frames_)
+        addStreamingFrame(calibration_frame.time_point_us(),
+                          std::make_unique<RecordCalibrationFrame>(std::move(calibration_frame)));
+    video_frames_.clear();
+    audio_frames_.clear();
+    imu_frames_.clear();
+    pose_frames_.clear();
+    calibration_frames_.clear();
+}
+
+void RecordBuilder::startStreamingToPath(const std::string& path, int64_t reorder_window_us)
+{
+    // Checking before opening the file, since opening it truncates an existing one.
+    checkStreamingStart();
+    auto io_callback{std::make_unique<BufferedFileIOCallback>(path)};
+    startStreaming(*io_callback, reorder_window_us);
+    streaming_io_callback_owner_ = std::move(io_callback);
+}
+
+void RecordBuilder::checkStreamingStart() const
+{
+    if (streaming_writer_) {
+        spdlog::error("RecordBuilder::startStreaming: already streaming.");
+        throw std::runtime_error{"RecordBuilder::startStreaming: already streaming."};
+    }
+    if (!calibration_) {
+        spdlog::error("RecordBuilder::startStreaming: no CameraCalibration set.");
+        throw std::runtime_error("No CameraCalibration found from RecordBytesBuilder");
+    }
+}
+
+void RecordBuilder::finishStreaming()
+{
+    if (!streaming_writer_) {
+        spdlog::error("RecordBuilder::finishStreaming: not streaming.");
+        throw std::runtime_error{"RecordBuilder::finishStreaming: not streaming."};
+    }
+
+    writePendingFrames(true);
+    if (!initial_video_time_point_us_)
+        spdlog::info("No video frame found from RecordBytesBuilder.");
+    streaming_writer_->flush();
+    streaming_writer_.reset();
+    streaming_io_callback_owner_.reset();
+}
+
+void RecordBuilder::addStreamingFrame(int64_t time_point_us, unique_ptr<RecordFrame> frame)
+{
+    if (last_written_time_point_us_ && time_point_us < *last_written_time_point_us_) {
+        spdlog::warn("RecordBuilder: dropping a frame ({} us) that arrived later than the "
+                     "reordering window.",
+                     time_point_us);
+        return;
+    }
+
+    auto& queue{pending_frames_[static_cast<size_t>(frame->getType())]};
+    // Frames mostly arrive in order, so searching from the back is cheap.
+    auto it{queue.end()};
+    while (it != queue.begin() && std::prev(it)->time_point_us > time_point_us)
+        --it;
+    queue.insert(it, PendingFrame{time_point_us, std::move(frame)});
+
+    latest_time_point_us_ = std::max(latest_time_point_us_.value_or(time_point_us), time_point_us);
+    writePendingFrames(false);
+}
+
+void RecordBuilder::writePendingFrames(bool flushing)
+{
+    while (true) {
+        // k-way merge of the per-type queues.
+        // On ties, the lowest RecordFrameType (i.e., video) gets written first so that frames at
+        // the time point of the first video frame are not dropped.
+        std::deque<PendingFrame>* next_queue{nullptr};
+        for (auto& queue : pending_frames_) {
+            if (queue.empty())
+                continue;
+            if (!next_queue || queue.front().time_point_us < next_queue->front().time_point_us)
+                next_queue = &queue;
+        }
+        if (!next_queue)
+            return;
+
+        int64_t time_point_us{next_queue->front().time_point_us};
+        if (!flushing && time_point_us > *latest_time_point_us_ - reorder_window_us_)
+            return;
+
+        auto frame{std::move(next_queue->front().frame)};
+        next_queue->pop_front();
+        last_written_time_point_us_ = time_point_us;
+        writeStreamingFrame(*frame);
+    }
+}
+
+void RecordBuilder::writeStreamingFrame(RecordFrame& frame)
+{
+    // Same as _build(), time points start from the first video frame,
+    // and frames before the first video frame are skipped.
+    if (frame.getType() == RecordFrameType::Video && !initial_video_time_point_us_)
+        initial_video_time_point_us_ = dynamic_cast<RecordVideoFrame&>(frame).time_point_us();
+    if (!initial_video_time_point_us_)
+        return;
+
+    int64_t initial_time_point_us{*initial_video_time_point_us_};
+    switch (frame.getType()) {
+    case RecordFrameType::Video: {
+        auto& video_frame{dynamic_cast<RecordVideoFrame&>(frame)};
+        streaming_writer_->writeVideoFrame(
+            RecordVideoFrame{video_frame.time_point_us() - initial_time_point_us,
+                             video_frame.keyframe(),
+                             video_frame.color_payload(),
+                             video_frame.depth_payload()});
+        break;
+    }
+    case RecordFrameType::Audio: {
+        auto& audio_frame{dynamic_cast<RecordAudioFrame&>(frame)};
+        streaming_writer_->writeAudioFrame(RecordAudioFrame{
+            audio_frame.time_point_us() - initial_time_point_us, audio_frame.payload()});
+        break;
+    }
+    case RecordFrameType::IMU: {
+        auto& imu_frame{dynamic_cast<RecordIMUFrame&>(frame)};
+        streaming_writer_->writeIMUFrame(
+            RecordIMUFrame{imu_frame.time_point_us() - initial_time_point_us,
+                           imu_frame.acceleration(),
+                           imu_frame.rotation_rate(),
+                           imu_frame.magnetic_field(),
+                           imu_frame.gravity()});
+        break;
+    }
+    case RecordFrameType::Pose: {
+        auto& pose_frame{dynamic_cast<RecordPoseFrame&>(frame)};
+        streaming_writer_->writePoseFrame(
+            RecordPoseFrame{pose_frame.time_point_us() - initial_time_point_us,
+                            pose_frame.translation(),
+                            pose_frame.rotation()});
+        break;
+    }
+    case RecordFrameType::Calibration: {
+        auto& calibration_frame{dynamic_cast<RecordCalibrationFrame&>(frame)};
+        streaming_writer_->writeCalibrationFrame(
+            RecordCalibrationFrame{calibration_frame.time_point_us() - initial_time_point_us,
+                                   calibration_frame.camera_calibration()});
+        break;
+    }
+    default:
+        throw std::runtime_error{
+            "Invalid RecordFrameType found in RecordBuilder::writeStreamingFrame"};
+    }
+}
+
 void RecordBuilder::_build(IOCallback& io_callback)
 {
     sort(video_frames_.begin(),
@@ -120,7 +346,8 @@ void RecordBuilder::_build(IOCallback& io_callback)
                            depth_codec_type_,
                            depth_unit_,
                            *calibration_,
-                           cover_png_bytes_};
+                           cover_png_bytes_,
+                           cluster_policy_};
 
     if (video_frames_.size() == 0) {
         spdlog::info("No video frame found from RecordBytesBuilder.");
@@ -149,7 +376,7 @@ void RecordBuilder::_build(IOCallback& io_callback)
             // Write if it is before the current video frame.
             if (audio_frame.time_point_us() > video_time_point_us)
                 break;
-            file_writer.writeAudioFrame(RecordAudioFrame{audio_time_point_us, audio_frame.bytes()});
+            file_writer.writeAudioFrame(RecordAudioFrame{audio_time_point_us, audio_frame.payload()});
             ++audio_frame_index;
         }
         while (imu_frame_index < imu_frames_.size()) {
@@ -198,8 +425,8 @@ void RecordBuilder::_build(IOCallback& io_callback)
         file_writer.writeVideoFrame(RecordVideoFrame{
             video_time_point_us,
             video_frame.keyframe(),
-            video_frame.color_bytes(),
-            video_frame.depth_bytes()
+            video_frame.color_payload(),
+            video_frame.depth_payload()
         });
     }
 
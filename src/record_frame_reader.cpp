@@ -0,0 +1,29 @@
+#include "record_frame_reader.hpp"
+
+namespace rgbd
+{
+RecordFrameReader::RecordFrameReader(const void* ptr, size_t size)
+    : parser_{new RecordParser{ptr, size}}
+{
+}
+
+RecordFrameReader::RecordFrameReader(const string& file_path, RecordFileAccess file_access)
+    : parser_{new RecordParser{file_path, file_access}}
+{
+}
+
+unique_ptr<RecordFrame> RecordFrameReader::next()
+{
+    return parser_->parseNextFrame();
+}
+
+void RecordFrameReader::reset()
+{
+    parser_->seekToFirstCluster();
+}
+
+int64_t RecordFrameReader::seekToTimePoint(int64_t time_point_us)
+{
+    return parser_->seekToTimePoint(time_point_us);
+}
+} // namespace rgbd
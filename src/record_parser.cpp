@@ -96,14 +96,17 @@ template <typename T> std::unique_ptr<T> find_next(EbmlStream& stream, bool sear
 }
 
 // Template helper functions
-template <typename T> T* read_element(EbmlStream& stream, EbmlElement* element)
+// With SCOPE_PARTIAL_DATA, blocks are read without their frame data.
+// Their frames can be located with GetDataPosition() and GetFrameSize().
+template <typename T>
+T* read_element(EbmlStream& stream, EbmlElement* element, ScopeMode read_fully = SCOPE_ALL_DATA)
 {
     try {
         int upper_level = 0;
         EbmlElement* dummy = nullptr;
 
         T* typed_element = static_cast<T*>(element);
-        typed_element->Read(stream, T::ClassInfos.Context, upper_level, dummy, true);
+        typed_element->Read(stream, T::ClassInfos.Context, upper_level, dummy, true, read_fully);
         return typed_element;
     } catch (std::ios_base::failure& e) {
         spdlog::error(
@@ -137,7 +140,7 @@ Bytes copy_data_buffer_to_bytes(DataBuffer& data_buffer)
     return bytes;
 }
 
-glm::vec3 read_vec3(const Bytes& bytes)
+glm::vec3 read_vec3(span<const uint8_t> bytes)
 {
     int cursor{0};
     float x{read_from_bytes<float>(bytes, cursor)};
@@ -146,7 +149,7 @@ glm::vec3 read_vec3(const Bytes& bytes)
     return glm::vec3{x, y, z};
 }
 
-glm::quat read_quat(const Bytes& bytes)
+glm::quat read_quat(span<const uint8_t> bytes)
 {
     int cursor{0};
     float w{read_from_bytes<float>(bytes, cursor)};
@@ -156,6 +159,130 @@ glm::quat read_quat(const Bytes& bytes)
     return glm::quat{w, x, y, z};
 }
 
+// Appends the samples of a block of the IMU track.
+// See convert_imu_samples_to_bytes() of RecordWriter for the layout.
+void read_imu_samples(span<const uint8_t> bytes, int64_t time_point_us, RecordIMUSamples& samples)
+{
+    constexpr size_t IMU_SAMPLE_SIZE{sizeof(int32_t) + 12 * sizeof(float)};
+    size_t byte_size{gsl::narrow<size_t>(bytes.size())};
+    if (byte_size < sizeof(uint32_t))
+        throw std::runtime_error{"Invalid IMU block"};
+
+    int cursor{0};
+    size_t sample_count{read_from_bytes<uint32_t>(bytes, cursor)};
+    // Compared by division so a corrupt sample_count cannot overflow.
+    size_t samples_byte_size{byte_size - sizeof(uint32_t)};
+    if (samples_byte_size % IMU_SAMPLE_SIZE != 0 ||
+        sample_count != samples_byte_size / IMU_SAMPLE_SIZE) {
+        spdlog::error("IMU block of {} bytes does not fit {} samples", byte_size, sample_count);
+        throw std::runtime_error{"Invalid size of IMU block"};
+    }
+
+    for (size_t i{0}; i < sample_count; ++i)
+        samples.time_points_us.push_back(time_point_us + read_from_bytes<int32_t>(bytes, cursor));
+    for (auto array : {&samples.acceleration,
+                       &samples.rotation_rate,
+                       &samples.magnetic_field,
+                       &samples.gravity}) {
+        for (auto components : {&array->x, &array->y, &array->z}) {
+            size_t offset{components->size()};
+            components->resize(offset + sample_count);
+            // Not &bytes[cursor], which fails gsl's bounds check at the end of an empty block.
+            memcpy(components->data() + offset,
+                   bytes.data() + cursor,
+                   sample_count * sizeof(float));
+            cursor += gsl::narrow<int>(sample_count * sizeof(float));
+        }
+    }
+}
+
+// Assembles RecordIMUFrames of files written before the IMU track, which store each vector of
+// a sample as a block of its own track.
+class LegacyIMUFrameAssembler
+{
+public:
+    LegacyIMUFrameAssembler(const RecordTracks& tracks) noexcept
+        : tracks_{tracks}
+        , time_point_us_{0}
+        , acceleration_{nullopt}
+        , rotation_rate_{nullopt}
+        , magnetic_field_{nullopt}
+        , gravity_{nullopt}
+    {
+    }
+    bool hasTrack(int track_number) const noexcept
+    {
+        return track_number == tracks_.acceleration_track_number ||
+               track_number == tracks_.rotation_rate_track_number ||
+               track_number == tracks_.magnetic_field_track_number ||
+               track_number == tracks_.gravity_track_number;
+    }
+    // Returns the frame once the blocks of all four vectors of a sample have been added.
+    // The time point of a sample is the one of its acceleration block.
+    optional<RecordIMUFrame>
+    addBlock(int track_number, int64_t time_point_us, span<const uint8_t> bytes)
+    {
+        if (track_number == tracks_.acceleration_track_number) {
+            time_point_us_ = time_point_us;
+            acceleration_ = read_vec3(bytes);
+        } else if (track_number == tracks_.rotation_rate_track_number) {
+            rotation_rate_ = read_vec3(bytes);
+        } else if (track_number == tracks_.magnetic_field_track_number) {
+            magnetic_field_ = read_vec3(bytes);
+        } else if (track_number == tracks_.gravity_track_number) {
+            gravity_ = read_vec3(bytes);
+        }
+
+        if (!acceleration_ || !rotation_rate_ || !magnetic_field_ || !gravity_)
+            return nullopt;
+
+        RecordIMUFrame imu_frame{
+            time_point_us_, *acceleration_, *rotation_rate_, *magnetic_field_, *gravity_};
+        acceleration_ = nullopt;
+        rotation_rate_ = nullopt;
+        magnetic_field_ = nullopt;
+        gravity_ = nullopt;
+        return imu_frame;
+    }
+    // Throws when a sample started in the cluster is left without the rest of its blocks.
+    void checkComplete() const
+    {
+        if (!acceleration_)
+            return;
+        if (!rotation_rate_)
+            throw std::runtime_error{"Failed to find rotation_rate"};
+        if (!magnetic_field_)
+            throw std::runtime_error{"Failed to find magnetic_field"};
+        if (!gravity_)
+            throw std::runtime_error{"Failed to find gravity"};
+    }
+
+private:
+    const RecordTracks& tracks_;
+    int64_t time_point_us_;
+    optional<glm::vec3> acceleration_;
+    optional<glm::vec3> rotation_rate_;
+    optional<glm::vec3> magnetic_field_;
+    optional<glm::vec3> gravity_;
+};
+
+int64_t get_frame_time_point_us(RecordFrame& frame)
+{
+    switch (frame.getType()) {
+    case RecordFrameType::Video:
+        return static_cast<RecordVideoFrame&>(frame).time_point_us();
+    case RecordFrameType::Audio:
+        return static_cast<RecordAudioFrame&>(frame).time_point_us();
+    case RecordFrameType::IMU:
+        return static_cast<RecordIMUFrame&>(frame).time_point_us();
+    case RecordFrameType::Pose:
+        return static_cast<RecordPoseFrame&>(frame).time_point_us();
+    case RecordFrameType::Calibration:
+        return static_cast<RecordCalibrationFrame&>(frame).time_point_us();
+    }
+    throw std::runtime_error{"Invalid RecordFrameType"};
+}
+
 shared_ptr<CameraCalibration> read_camera_calibration(string calibration_str)
 {
     // Brace initialization of json behaves differently in gcc than in clang.
@@ -179,26 +306,75 @@ shared_ptr<CameraCalibration> read_camera_calibration(string calibration_str)
 
 RecordParser::RecordParser(const void* ptr, size_t size)
     : input_{new MemReadIOCallback{ptr, size}}
+    , input_data_{nullptr}
+    , input_size_{0}
+    , input_owner_{}
+    , mmap_file_{}
     , stream_{*input_}
     , kax_segment_{}
     , file_offsets_{}
     , file_info_{}
     , file_tracks_{}
     , file_attachments_{}
+    , cues_offset_{}
+    , cue_points_{}
+    , next_cluster_offset_{}
 {
     parseExceptClusters();
+    seekToFirstCluster();
+}
+
+RecordParser::RecordParser(const void* ptr, size_t size, shared_ptr<const void> owner)
+    : input_{new MemReadIOCallback{ptr, size}}
+    , input_data_{static_cast<const uint8_t*>(ptr)}
+    , input_size_{size}
+    , input_owner_{std::move(owner)}
+    , mmap_file_{}
+    , stream_{*input_}
+    , kax_segment_{}
+    , file_offsets_{}
+    , file_info_{}
+    , file_tracks_{}
+    , file_attachments_{}
+    , cues_offset_{}
+    , cue_points_{}
+    , next_cluster_offset_{}
+{
+    parseExceptClusters();
+    seekToFirstCluster();
+}
+
+RecordParser::RecordParser(const string& file_path, RecordFileAccess file_access)
+    : RecordParser{file_path,
+                   file_access == RecordFileAccess::MemoryMap
+                       ? std::make_shared<const MmapFile>(file_path)
+                       : nullptr}
+{
 }
 
-RecordParser::RecordParser(const string& file_path)
-    : input_{new StdIOCallback{file_path.c_str(), open_mode::MODE_READ}}
+RecordParser::RecordParser(const string& file_path, shared_ptr<const MmapFile> mmap_file)
+    : input_{mmap_file ? static_cast<IOCallback*>(new MmapIOCallback{mmap_file})
+                       : new StdIOCallback{file_path.c_str(), open_mode::MODE_READ}}
+    , input_data_{mmap_file ? mmap_file->data() : nullptr}
+    , input_size_{mmap_file ? mmap_file->size() : 0}
+    , input_owner_{mmap_file}
+    , mmap_file_{mmap_file}
     , stream_{*input_}
     , kax_segment_{}
     , file_offsets_{}
     , file_info_{}
     , file_tracks_{}
     , file_attachments_{}
+    , cues_offset_{}
+    , cue_points_{}
+    , next_cluster_offset_{}
 {
+    // Clusters are mostly read in order.
+    if (mmap_file)
+        mmap_file->advise(MmapAdvice::Sequential);
+
     parseExceptClusters();
+    seekToFirstCluster();
 }
 
 void RecordParser::parseExceptClusters()
@@ -317,8 +493,8 @@ optional<const RecordOffsets> RecordParser::parseOffsets(unique_ptr<KaxSegment>&
                     } else if (ebml_id == KaxAttachments::ClassInfos.GlobalId) {
                         attachments_offset = seek_location;
                     } else if (ebml_id == KaxCues::ClassInfos.GlobalId) {
-                        // Not using Cues for now.
-//                        spdlog::info("Found cues");
+                        // Cues are parsed lazily when seeking.
+                        cues_offset_ = seek_location;
                     } else {
                         spdlog::info("Found seek not used.");
                     }
@@ -348,6 +524,7 @@ optional<const RecordTracks> RecordParser::parseTracks(unique_ptr<KaxTracks>& tr
     optional<RecordColorVideoTrack> color_track{nullopt};
     optional<RecordDepthVideoTrack> depth_track{nullopt};
     optional<RecordAudioTrack> audio_track{nullopt};
+    optional<int> imu_track_number{nullopt};
     optional<int> acceleration_track_number{nullopt};
     optional<int> rotation_rate_track_number{nullopt};
     optional<int> magnetic_field_track_number{nullopt};
@@ -411,6 +588,8 @@ optional<const RecordTracks> RecordParser::parseTracks(unique_ptr<KaxTracks>& tr
                     depth_track->codec = DepthCodecType::RVL;
                 } else if (codec_id == "V_TDC1") {
                     depth_track->codec = DepthCodecType::TDC1;
+                } else if (codec_id == "V_RVL_MT") {
+                    depth_track->codec = DepthCodecType::RVL_MT;
                 } else {
                     string message{fmt::format("Invalid depth codec: {}", codec_id)};
                     spdlog::error(message);
@@ -429,6 +608,13 @@ optional<const RecordTracks> RecordParser::parseTracks(unique_ptr<KaxTracks>& tr
                 audio_track->sampling_frequency = sampling_freq;
             } else if (track_name == "FLOOR") {
                 // Floor track is no longer used.
+            } else if (track_name == "IMU") {
+                if (codec_id != "S_IMU_PACKED") {
+                    string message{fmt::format("Invalid IMU codec: {}", codec_id)};
+                    spdlog::error(message);
+                    throw std::runtime_error(message);
+                }
+                imu_track_number = gsl::narrow<int>(track_number);
             } else if (track_name == "ACCELERATION") {
                 acceleration_track_number = gsl::narrow<int>(track_number);
             } else if (track_name == "ROTATION_RATE") {
@@ -460,6 +646,7 @@ optional<const RecordTracks> RecordParser::parseTracks(unique_ptr<KaxTracks>& tr
     file_tracks.color_track = *color_track;
     file_tracks.depth_track = *depth_track;
     file_tracks.audio_track = *audio_track;
+    file_tracks.imu_track_number = imu_track_number;
     file_tracks.acceleration_track_number = acceleration_track_number;
     file_tracks.rotation_rate_track_number = rotation_rate_track_number;
     file_tracks.magnetic_field_track_number = magnetic_field_track_number;
@@ -510,26 +697,125 @@ RecordParser::parseAttachments(unique_ptr<libmatroska::KaxAttachments>& attachme
     return file_attachments;
 }
 
-RecordFrame* RecordParser::parseCluster(unique_ptr<libmatroska::KaxCluster>& cluster)
+vector<RecordCuePoint> RecordParser::parseCues(unique_ptr<libmatroska::KaxCues>& cues)
+{
+    vector<RecordCuePoint> cue_points;
+    for (EbmlElement* e : cues->GetElementList()) {
+        if (EbmlId(*e) != KaxCuePoint::ClassInfos.GlobalId)
+            continue;
+
+        auto cue_point{static_cast<KaxCuePoint*>(e)};
+        auto cue_time{FindChild<KaxCueTime>(*cue_point)};
+        if (!cue_time)
+            continue;
+
+        for (EbmlElement* cue_point_child : cue_point->GetElementList()) {
+            if (EbmlId(*cue_point_child) != KaxCueTrackPositions::ClassInfos.GlobalId)
+                continue;
+
+            auto track_positions{static_cast<KaxCueTrackPositions*>(cue_point_child)};
+            auto cue_track{FindChild<KaxCueTrack>(*track_positions)};
+            auto cue_cluster_position{FindChild<KaxCueClusterPosition>(*track_positions)};
+            if (!cue_track || !cue_cluster_position)
+                continue;
+            // RecordWriter adds cues only for color keyframes,
+            // but other writers might have added more.
+            if (gsl::narrow<int>(cue_track->GetValue()) != file_tracks_->color_track.track_number)
+                continue;
+
+            int64_t time_point_ns{
+                gsl::narrow<int64_t>(cue_time->GetValue() * file_info_->timecode_scale_ns)};
+            RecordCuePoint record_cue_point;
+            record_cue_point.time_point_us = time_point_ns / 1000;
+            record_cue_point.cluster_offset = gsl::narrow<int64_t>(cue_cluster_position->GetValue());
+            cue_points.push_back(record_cue_point);
+        }
+    }
+
+    sort(cue_points.begin(),
+         cue_points.end(),
+         [](const RecordCuePoint& lhs, const RecordCuePoint& rhs) {
+             return lhs.time_point_us < rhs.time_point_us;
+         });
+    return cue_points;
+}
+
+// Files written before RecordWriter started adding color keyframes to Cues have empty Cues.
+// For those, build the index by visiting every cluster once.
+vector<RecordCuePoint> RecordParser::scanCuePoints()
 {
-    if (read_element<KaxCluster>(stream_, cluster.get()) == nullptr)
+    vector<RecordCuePoint> cue_points;
+    auto cluster{findFirstCluster()};
+    while (cluster != nullptr) {
+        int64_t cluster_offset{gsl::narrow<int64_t>(kax_segment_->GetRelativePosition(*cluster))};
+        for (auto& frame : parseCluster(cluster)) {
+            if (frame->getType() != RecordFrameType::Video)
+                continue;
+            auto video_frame{dynamic_cast<RecordVideoFrame*>(frame.get())};
+            if (video_frame->keyframe()) {
+                RecordCuePoint cue_point;
+                cue_point.time_point_us = video_frame->time_point_us();
+                cue_point.cluster_offset = cluster_offset;
+                cue_points.push_back(cue_point);
+            }
+        }
+        cluster = findNextCluster();
+    }
+    return cue_points;
+}
+
+RecordPayload RecordParser::readPayload(KaxSimpleBlock& simple_block)
+{
+    if (!input_owner_)
+        return RecordPayload{copy_data_buffer_to_bytes(simple_block.GetBuffer(0))};
+
+    uint64_t data_position{simple_block.GetDataPosition(0)};
+    uint64_t frame_size{simple_block.GetFrameSize(0)};
+    if (data_position + frame_size > input_size_)
+        throw std::runtime_error{"Block data out of the input buffer"};
+
+    return RecordPayload{
+        span<const uint8_t>{input_data_ + data_position, gsl::narrow<size_t>(frame_size)},
+        input_owner_};
+}
+
+void RecordParser::readCluster(unique_ptr<libmatroska::KaxCluster>& cluster)
+{
+    // When the input is kept alive by input_owner_,
+    // frames view into the input instead of copying the frame data.
+    ScopeMode read_fully{input_owner_ ? SCOPE_PARTIAL_DATA : SCOPE_ALL_DATA};
+    if (read_element<KaxCluster>(stream_, cluster.get(), read_fully) == nullptr)
         throw std::runtime_error{"Failed reading cluster"};
     auto cluster_timecode{FindChild<KaxClusterTimecode>(*cluster)->GetValue()};
     cluster->InitTimecode(cluster_timecode / file_info_->timecode_scale_ns,
                           file_info_->timecode_scale_ns);
+}
 
-    int64 global_timecode{0};
+int64_t RecordParser::getTimePointUs(int64_t global_timecode)
+{
+    int64_t time_point_ns{gsl::narrow<int64_t>(global_timecode * file_info_->timecode_scale_ns)};
+    return time_point_ns / 1000;
+}
+
+vector<unique_ptr<RecordFrame>>
+RecordParser::parseCluster(unique_ptr<libmatroska::KaxCluster>& cluster)
+{
+    readCluster(cluster);
+
+    // A cluster may hold frames of any tracks, each frame made of one or more blocks
+    // (e.g., a video frame is a color block and a depth block).
+    // Blocks of a frame are collected below and the frame gets emitted once all of its blocks
+    // are found.
+    vector<unique_ptr<RecordFrame>> frames;
+    int64_t video_timecode{0};
     optional<bool> keyframe{nullopt};
-    Bytes color_bytes;
-    Bytes depth_bytes;
-    Bytes audio_bytes;
-    optional<glm::vec3> acceleration{nullopt};
-    optional<glm::vec3> rotation_rate{nullopt};
-    optional<glm::vec3> magnetic_field{nullopt};
-    optional<glm::vec3> gravity{nullopt};
+    RecordPayload color_payload;
+    RecordPayload depth_payload;
+    RecordIMUSamples imu_samples;
+    LegacyIMUFrameAssembler legacy_imu_frame_assembler{*file_tracks_};
+    int64_t pose_timecode{0};
     optional<glm::vec3> translation{nullopt};
     optional<glm::quat> rotation{nullopt};
-    shared_ptr<CameraCalibration> camera_calibration{nullptr};
 
     for (EbmlElement* e : cluster->GetElementList()) {
         EbmlId id{*e};
@@ -539,12 +825,11 @@ RecordFrame* RecordParser::parseCluster(unique_ptr<libmatroska::KaxCluster>& clu
             simple_block->SetParent(*cluster);
             auto track_number{simple_block->TrackNum()};
             auto block_global_timecode{gsl::narrow<int64_t>(simple_block->GlobalTimecode())};
-            auto data_buffer{simple_block->GetBuffer(0)};
             if (track_number == file_tracks_->color_track.track_number) {
-                global_timecode = block_global_timecode;
-                color_bytes = copy_data_buffer_to_bytes(data_buffer);
+                video_timecode = block_global_timecode;
+                color_payload = readPayload(*simple_block);
             } else if (track_number == file_tracks_->depth_track.track_number) {
-                depth_bytes = copy_data_buffer_to_bytes(data_buffer);
+                depth_payload = readPayload(*simple_block);
 
                 keyframe = simple_block->IsKeyframe();
                 // The below step is added since before 1.4.0, FileWriter was incorrectly
@@ -552,34 +837,38 @@ RecordFrame* RecordParser::parseCluster(unique_ptr<libmatroska::KaxCluster>& clu
                 // Depth frames were correctly marked whether they were keyframe or not,
                 // so using this information to obtain correct information.
                 if (file_tracks_->depth_track.codec == DepthCodecType::TDC1) {
-                    if (!is_tdc1_keyframe(depth_bytes)) {
+                    if (!is_tdc1_keyframe(depth_payload.bytes())) {
                         keyframe = false;
                     }
                 }
             } else if (track_number == file_tracks_->audio_track.track_number) {
-                global_timecode = block_global_timecode;
-                audio_bytes = copy_data_buffer_to_bytes(data_buffer);
-            } else if (track_number == file_tracks_->acceleration_track_number) {
-                global_timecode = block_global_timecode;
-                acceleration = read_vec3(copy_data_buffer_to_bytes(data_buffer));
-            } else if (track_number == file_tracks_->rotation_rate_track_number) {
-                rotation_rate = read_vec3(copy_data_buffer_to_bytes(data_buffer));
-            } else if (track_number == file_tracks_->magnetic_field_track_number) {
-                magnetic_field = read_vec3(copy_data_buffer_to_bytes(data_buffer));
-            } else if (track_number == file_tracks_->gravity_track_number) {
-                gravity = read_vec3(copy_data_buffer_to_bytes(data_buffer));
+                auto audio_payload{readPayload(*simple_block)};
+                if (audio_payload.bytes().size() > 0) {
+                    frames.push_back(std::make_unique<RecordAudioFrame>(
+                        getTimePointUs(block_global_timecode), audio_payload));
+                }
+            } else if (track_number == file_tracks_->imu_track_number) {
+                read_imu_samples(readPayload(*simple_block).bytes(),
+                                 getTimePointUs(block_global_timecode),
+                                 imu_samples);
+            } else if (legacy_imu_frame_assembler.hasTrack(track_number)) {
+                auto imu_frame{
+                    legacy_imu_frame_assembler.addBlock(track_number,
+                                                        getTimePointUs(block_global_timecode),
+                                                        readPayload(*simple_block).bytes())};
+                if (imu_frame)
+                    frames.push_back(std::make_unique<RecordIMUFrame>(std::move(*imu_frame)));
             } else if (track_number == file_tracks_->translation_track_number) {
-                global_timecode = block_global_timecode;
-                translation = read_vec3(copy_data_buffer_to_bytes(data_buffer));
+                pose_timecode = block_global_timecode;
+                translation = read_vec3(readPayload(*simple_block).bytes());
             } else if (track_number == file_tracks_->rotation_track_number) {
-                rotation = read_quat(copy_data_buffer_to_bytes(data_buffer));
+                rotation = read_quat(readPayload(*simple_block).bytes());
             } else if (track_number == file_tracks_->calibration_track_number) {
-                global_timecode = block_global_timecode;
-                Bytes bytes{copy_data_buffer_to_bytes(data_buffer)};
-                vector<char> calibration_vector(bytes.size());
-                memcpy(calibration_vector.data(), bytes.data(), bytes.size());
-                string calibration_str{calibration_vector.begin(), calibration_vector.end()};
-                camera_calibration = read_camera_calibration(calibration_str);
+                auto calibration_bytes{readPayload(*simple_block).bytes()};
+                string calibration_str{calibration_bytes.begin(), calibration_bytes.end()};
+                frames.push_back(std::make_unique<RecordCalibrationFrame>(
+                    getTimePointUs(block_global_timecode),
+                    read_camera_calibration(calibration_str)));
             } else {
                 // There might be some obsolete tracks in a file,
                 // spdlog::debug("Invalid track number from simple_block");
@@ -587,48 +876,73 @@ RecordFrame* RecordParser::parseCluster(unique_ptr<libmatroska::KaxCluster>& clu
         } else {
             throw std::runtime_error{"Invalid element from KaxCluster"};
         }
-    }
 
-    int64_t time_point_ns{gsl::narrow<int64_t>(global_timecode * file_info_->timecode_scale_ns)};
-    int64_t time_point_us{time_point_ns / 1000};
-
-    // emplace only when the cluster is for video, not audio.
-    if (color_bytes.size() > 0) {
-        if (!keyframe)
-            throw std::runtime_error("Failed to find keyframe info.");
-        return new RecordVideoFrame{
-            time_point_us, *keyframe, color_bytes, depth_bytes};
+        if (color_payload.bytes().size() > 0 && keyframe) {
+            frames.push_back(std::make_unique<RecordVideoFrame>(
+                getTimePointUs(video_timecode), *keyframe, color_payload, depth_payload));
+            color_payload = RecordPayload{};
+            depth_payload = RecordPayload{};
+            keyframe = nullopt;
+        }
+        if (translation && rotation) {
+            frames.push_back(std::make_unique<RecordPoseFrame>(
+                getTimePointUs(pose_timecode), *translation, *rotation));
+            translation = nullopt;
+            rotation = nullopt;
+        }
     }
 
-    if (audio_bytes.size() > 0) {
-        return new RecordAudioFrame{time_point_us, audio_bytes};
+    // Blocks left without the rest of their frames.
+    if (color_payload.bytes().size() > 0)
+        throw std::runtime_error("Failed to find keyframe info.");
+    legacy_imu_frame_assembler.checkComplete();
+    if (translation && !rotation)
+        throw std::runtime_error("Failed to find rotation");
+
+    // RecordWriter adds the block of IMU samples when it has enough samples or at the end of
+    // the cluster, which can be after frames of later time points.
+    // Puts the samples back in between the other frames by their time points.
+    if (!imu_samples.empty()) {
+        vector<unique_ptr<RecordFrame>> merged_frames;
+        merged_frames.reserve(frames.size() + imu_samples.size());
+        size_t imu_sample_index{0};
+        for (auto& frame : frames) {
+            int64_t frame_time_point_us{get_frame_time_point_us(*frame)};
+            while (imu_sample_index < imu_samples.size() &&
+                   imu_samples.time_points_us[imu_sample_index] <= frame_time_point_us) {
+                merged_frames.push_back(
+                    std::make_unique<RecordIMUFrame>(imu_samples.getFrame(imu_sample_index++)));
+            }
+            merged_frames.push_back(std::move(frame));
+        }
+        while (imu_sample_index < imu_samples.size()) {
+            merged_frames.push_back(
+                std::make_unique<RecordIMUFrame>(imu_samples.getFrame(imu_sample_index++)));
+        }
+        frames = std::move(merged_frames);
     }
 
-    if (acceleration) {
-        if (!rotation_rate)
-            throw std::runtime_error{"Failed to find rotation_rate"};
-        if (!magnetic_field)
-            throw std::runtime_error{"Failed to find magnetic_field"};
-        if (!gravity)
-            throw std::runtime_error{"Failed to find gravity"};
-
-        return new RecordIMUFrame{
-            time_point_us, *acceleration, *rotation_rate, *magnetic_field, *gravity};
-    }
+    if (frames.empty())
+        spdlog::warn("No frame made from cluster. Maybe a frame from the future.");
+    return frames;
+}
 
-    if (translation) {
-        if (!rotation)
-            throw std::runtime_error("Failed to find rotation");
+unique_ptr<KaxCluster> RecordParser::findFirstCluster()
+{
+    auto cluster{read_offset<KaxCluster>(
+        *input_, stream_, *kax_segment_, file_offsets_->first_cluster_offset)};
 
-        return new RecordPoseFrame{time_point_us, *translation, *rotation};
-    }
+    if (!cluster)
+        throw std::runtime_error("Failed to read first cluster");
 
-    if (camera_calibration) { 
-        return new RecordCalibrationFrame(time_point_us, camera_calibration);
-    }
+    return cluster;
+}
 
-    spdlog::warn("No frame made from cluster. Maybe a frame from the future.");
-    return nullptr;
+// Should be called right after parseCluster() so the stream is at the end of the previous
+// cluster.
+unique_ptr<KaxCluster> RecordParser::findNextCluster()
+{
+    return find_next<KaxCluster>(stream_, true);
 }
 
 void RecordParser::parseAllClusters(vector<RecordVideoFrame>& video_frames,
@@ -637,49 +951,188 @@ void RecordParser::parseAllClusters(vector<RecordVideoFrame>& video_frames,
                                     vector<RecordPoseFrame>& pose_frames,
                                     vector<RecordCalibrationFrame>& calibration_frames)
 {
-    auto cluster{read_offset<KaxCluster>(
-        *input_, stream_, *kax_segment_, file_offsets_->first_cluster_offset)};
-
-    if (!cluster)
-        throw std::runtime_error("Failed to read first cluster");
+    auto cluster{findFirstCluster()};
+    while (cluster != nullptr) {
+        auto frames{parseCluster(cluster)};
+        cluster = findNextCluster();
+
+        for (auto& frame : frames) {
+            switch (frame->getType()) {
+            case RecordFrameType::Video: {
+                auto video_frame{dynamic_cast<RecordVideoFrame*>(frame.get())};
+                video_frames.push_back(std::move(*video_frame));
+                break;
+            }
+            case RecordFrameType::Audio: {
+                auto audio_frame{dynamic_cast<RecordAudioFrame*>(frame.get())};
+                audio_frames.push_back(std::move(*audio_frame));
+                break;
+            }
+            case RecordFrameType::IMU: {
+                auto imu_frame{dynamic_cast<RecordIMUFrame*>(frame.get())};
+                imu_frames.push_back(std::move(*imu_frame));
+                break;
+            }
+            case RecordFrameType::Pose: {
+                auto pose_frame{dynamic_cast<RecordPoseFrame*>(frame.get())};
+                pose_frames.push_back(std::move(*pose_frame));
+                break;
+            }
+            case RecordFrameType::Calibration: {
+                auto calibration_frame{dynamic_cast<RecordCalibrationFrame*>(frame.get())};
+                calibration_frames.push_back(std::move(*calibration_frame));
+                break;
+            }
+            default:
+                throw std::runtime_error{
+                    "Invalid FileFrameType found in FileParser::parseAllClusters"};
+            }
+        }
+    }
+}
 
+RecordIMUSamples RecordParser::parseIMUSamples()
+{
+    RecordIMUSamples imu_samples;
+    auto cluster{findFirstCluster()};
     while (cluster != nullptr) {
-        auto frame{parseCluster(cluster)};
-        cluster = find_next<KaxCluster>(stream_, true);
+        readCluster(cluster);
 
-        if (!frame)
-            continue;
+        LegacyIMUFrameAssembler legacy_imu_frame_assembler{*file_tracks_};
+        for (EbmlElement* e : cluster->GetElementList()) {
+            if (EbmlId(*e) != KaxSimpleBlock::ClassInfos.GlobalId)
+                continue;
 
-        switch (frame->getType()) {
-        case RecordFrameType::Video: {
-            auto video_frame{dynamic_cast<RecordVideoFrame*>(frame)};
-            video_frames.push_back(std::move(*video_frame));
-            break;
-        }
-        case RecordFrameType::Audio: {
-            auto audio_frame{dynamic_cast<RecordAudioFrame*>(frame)};
-            audio_frames.push_back(std::move(*audio_frame));
-            break;
-        }
-        case RecordFrameType::IMU: {
-            auto imu_frame{dynamic_cast<RecordIMUFrame*>(frame)};
-            imu_frames.push_back(std::move(*imu_frame));
-            break;
-        }
-        case RecordFrameType::Pose: {
-            auto pose_frame{dynamic_cast<RecordPoseFrame*>(frame)};
-            pose_frames.push_back(std::move(*pose_frame));
-            break;
-        }
-        case RecordFrameType::Calibration: {
-            auto calibration_frame{dynamic_cast<RecordCalibrationFrame*>(frame)};
-            calibration_frames.push_back(std::move(*calibration_frame));
-            break;
+            auto simple_block{static_cast<KaxSimpleBlock*>(e)};
+            simple_block->SetParent(*cluster);
+            auto track_number{simple_block->TrackNum()};
+            auto block_global_timecode{gsl::narrow<int64_t>(simple_block->GlobalTimecode())};
+            if (track_number == file_tracks_->imu_track_number) {
+                read_imu_samples(readPayload(*simple_block).bytes(),
+                                 getTimePointUs(block_global_timecode),
+                                 imu_samples);
+            } else if (legacy_imu_frame_assembler.hasTrack(track_number)) {
+                auto imu_frame{
+                    legacy_imu_frame_assembler.addBlock(track_number,
+                                                        getTimePointUs(block_global_timecode),
+                                                        readPayload(*simple_block).bytes())};
+                if (imu_frame)
+                    imu_samples.append(*imu_frame);
+            }
         }
-        default:
-            throw std::runtime_error{"Invalid FileFrameType found in FileParser::parseAllClusters"};
+        legacy_imu_frame_assembler.checkComplete();
+        cluster = findNextCluster();
+    }
+    return imu_samples;
+}
+
+unique_ptr<RecordFrame> RecordParser::parseNextFrame()
+{
+    while (pending_frames_.empty()) {
+        if (!parseNextCluster())
+            return nullptr;
+    }
+
+    auto frame{std::move(pending_frames_.front())};
+    pending_frames_.pop_front();
+    return frame;
+}
+
+bool RecordParser::parseNextCluster()
+{
+    // The cursor is kept as an offset, not as an element,
+    // so that parse() and parseNextFrame() can be called in any order.
+    if (!next_cluster_offset_)
+        return false;
+
+    input_->setFilePointer(
+        gsl::narrow<int64_t>(kax_segment_->GetGlobalPosition(*next_cluster_offset_)));
+    auto cluster{find_next<KaxCluster>(stream_, true)};
+    if (!cluster) {
+        next_cluster_offset_ = nullopt;
+        return false;
+    }
+
+    for (auto& frame : parseCluster(cluster))
+        pending_frames_.push_back(std::move(frame));
+    uint64_t cluster_end_position{cluster->GetElementPosition() + cluster->HeadSize() +
+                                  cluster->GetSize()};
+    next_cluster_offset_ =
+        gsl::narrow<int64_t>(kax_segment_->GetRelativePosition(cluster_end_position));
+    return true;
+}
+
+void RecordParser::seekToFirstCluster()
+{
+    next_cluster_offset_ = file_offsets_->first_cluster_offset;
+    pending_frames_.clear();
+}
+
+int64_t RecordParser::seekToTimePoint(int64_t time_point_us)
+{
+    // Reading Cues and jumping to a cluster do not follow the file order, so readahead
+    // around them is wasted. Reading frames from the keyframe on is sequential again.
+    if (mmap_file_)
+        mmap_file_->advise(MmapAdvice::Random);
+    auto restore_advice{gsl::finally([this] {
+        if (mmap_file_)
+            mmap_file_->advise(MmapAdvice::Sequential);
+    })};
+
+    auto& cue_points{getCuePoints()};
+    // Find the first cue point after time_point_us, then step back to the one before it.
+    auto it{std::upper_bound(cue_points.begin(),
+                             cue_points.end(),
+                             time_point_us,
+                             [](int64_t time_point, const RecordCuePoint& cue_point) {
+                                 return time_point < cue_point.time_point_us;
+                             })};
+    if (it == cue_points.begin()) {
+        // Before the first cue point, frames come out from the first cluster, which may start
+        // before the first cue point.
+        seekToFirstCluster();
+        while (pending_frames_.empty()) {
+            if (!parseNextCluster())
+                return 0;
         }
+        return get_frame_time_point_us(*pending_frames_.front());
     }
+
+    --it;
+    next_cluster_offset_ = it->cluster_offset;
+    pending_frames_.clear();
+
+    // The cluster of the keyframe may also hold frames written before the keyframe,
+    // which should not come out after seeking.
+    parseNextCluster();
+    auto keyframe_it{std::find_if(
+        pending_frames_.begin(), pending_frames_.end(), [&](const unique_ptr<RecordFrame>& frame) {
+            if (frame->getType() != RecordFrameType::Video)
+                return false;
+            auto video_frame{static_cast<RecordVideoFrame*>(frame.get())};
+            return video_frame->keyframe() && video_frame->time_point_us() == it->time_point_us;
+        })};
+    if (keyframe_it != pending_frames_.end())
+        pending_frames_.erase(pending_frames_.begin(), keyframe_it);
+    return it->time_point_us;
+}
+
+const vector<RecordCuePoint>& RecordParser::getCuePoints()
+{
+    if (cue_points_)
+        return *cue_points_;
+
+    if (cues_offset_) {
+        auto kax_cues{read_offset<KaxCues>(*input_, stream_, *kax_segment_, *cues_offset_)};
+        cue_points_ = parseCues(kax_cues);
+    } else {
+        cue_points_ = vector<RecordCuePoint>{};
+    }
+
+    if (cue_points_->empty())
+        cue_points_ = scanCuePoints();
+
+    return *cue_points_;
 }
 
 unique_ptr<Record> RecordParser::parse(bool with_frames)
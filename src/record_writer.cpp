@@ -25,12 +25,42 @@ Bytes convert_quat_to_bytes(const glm::quat& q)
     return bytes;
 }
 
+// Size of a sample in a block of the IMU track, an int32 time offset and 12 floats.
+constexpr size_t IMU_SAMPLE_SIZE{sizeof(int32_t) + 12 * sizeof(float)};
+
+// A block of the IMU track starts with the uint32 number of samples, followed by int32 offsets of
+// the time points of the samples from the first one in microseconds.
+// Then come float arrays of the samples, one for each component:
+// acceleration x, y, z, rotation_rate x, y, z, magnetic_field x, y, z, and gravity x, y, z.
+Bytes convert_imu_samples_to_bytes(const RecordIMUSamples& samples)
+{
+    size_t sample_count{samples.size()};
+    Bytes bytes(sizeof(uint32_t) + sample_count * IMU_SAMPLE_SIZE);
+    int cursor{0};
+    write_to_bytes(bytes, cursor, gsl::narrow<uint32_t>(sample_count));
+    for (int64_t time_point_us : samples.time_points_us) {
+        write_to_bytes(
+            bytes, cursor, gsl::narrow<int32_t>(time_point_us - samples.time_points_us.front()));
+    }
+    for (auto array : {&samples.acceleration,
+                       &samples.rotation_rate,
+                       &samples.magnetic_field,
+                       &samples.gravity}) {
+        for (auto components : {&array->x, &array->y, &array->z}) {
+            memcpy(&bytes[cursor], components->data(), sample_count * sizeof(float));
+            cursor += gsl::narrow<int>(sample_count * sizeof(float));
+        }
+    }
+    return bytes;
+}
+
 RecordWriter::RecordWriter(IOCallback& io_callback,
                        int sample_rate,
                        DepthCodecType depth_codec_type,
                        float depth_unit,
                        const CameraCalibration& calibration,
-                       const optional<Bytes>& cover_png_bytes)
+                       const optional<Bytes>& cover_png_bytes,
+                       const RecordWriterClusterPolicy& cluster_policy)
     : io_callback_{io_callback}
     , segment_{}
     , seek_head_placeholder_{}
@@ -39,6 +69,11 @@ RecordWriter::RecordWriter(IOCallback& io_callback,
     , past_color_block_blob_{nullptr}
     , past_depth_block_blob_{nullptr}
     , last_timecode_{0}
+    , cluster_policy_{cluster_policy}
+    , cluster_{nullptr}
+    , cluster_timecode_{0}
+    , cluster_size_{0}
+    , pending_imu_samples_{}
 {
     std::random_device random_device;
     std::mt19937 generator{random_device()};
@@ -68,6 +103,7 @@ RecordWriter::RecordWriter(IOCallback& io_callback,
     constexpr uint64_t TRANSLATION_TRACK_NUMBER{8};
     constexpr uint64_t ROTATION_TRACK_NUMBER{9};
     constexpr uint64_t CALIBRATION_TRACK_NUMBER{10};
+    constexpr uint64_t IMU_TRACK_NUMBER{11};
     //
     // init color_track_
     //
@@ -109,6 +145,8 @@ RecordWriter::RecordWriter(IOCallback& io_callback,
             GetChild<KaxCodecID>(*writer_tracks_.depth_track).SetValue("V_RVL");
         } else if (depth_codec_type == DepthCodecType::TDC1) {
             GetChild<KaxCodecID>(*writer_tracks_.depth_track).SetValue("V_TDC1");
+        } else if (depth_codec_type == DepthCodecType::RVL_MT) {
+            GetChild<KaxCodecID>(*writer_tracks_.depth_track).SetValue("V_RVL_MT");
         } else {
             spdlog::error("Invalid depth codec found");
             throw std::runtime_error("Invalid depth codec found");
@@ -312,6 +350,22 @@ RecordWriter::RecordWriter(IOCallback& io_callback,
         GetChild<KaxCodecID>(*writer_tracks_.calibration_track).SetValue("S_CALIBRATION");
     }
     //
+    // init imu_track_
+    //
+    {
+        auto& tracks{GetChild<KaxTracks>(segment_)};
+        writer_tracks_.imu_track = new KaxTrackEntry;
+        tracks.PushElement(
+            *writer_tracks_.imu_track); // Track will be freed when the file is closed.
+        writer_tracks_.imu_track->SetGlobalTimecodeScale(MATROSKA_TIMESCALE_NS);
+
+        GetChild<KaxTrackNumber>(*writer_tracks_.imu_track).SetValue(IMU_TRACK_NUMBER);
+        GetChild<KaxTrackUID>(*writer_tracks_.imu_track).SetValue(distribution(generator));
+        GetChild<KaxTrackType>(*writer_tracks_.imu_track).SetValue(track_subtitle);
+        GetChild<KaxTrackName>(*writer_tracks_.imu_track).SetValueUTF8("IMU");
+        GetChild<KaxCodecID>(*writer_tracks_.imu_track).SetValue("S_IMU_PACKED");
+    }
+    //
     // init calibration as attachment
     //
     {
@@ -406,36 +460,22 @@ void RecordWriter::writeVideoFrame(const RecordVideoFrame& video_frame)
     auto& cues{GetChild<KaxCues>(segment_)};
     auto video_timecode{gsl::narrow<uint64_t>(time_point_ns)};
 
-    auto video_cluster{new KaxCluster};
-    segment_.PushElement(*video_cluster);
-    video_cluster->InitTimecode(video_timecode / MATROSKA_TIMESCALE_NS, MATROSKA_TIMESCALE_NS);
-    video_cluster->SetParent(segment_);
-    video_cluster->EnableChecksum();
-
-    auto color_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto color_data_buffer{new DataBuffer{const_cast<uint8_t*>(video_frame.color_bytes().data()),
-        gsl::narrow<uint32_t>(video_frame.color_bytes().size())}};
-    video_cluster->AddBlockBlob(color_block_blob);
-    color_block_blob->SetParent(*video_cluster);
-    color_block_blob->AddFrameAuto(*writer_tracks_.color_track,
-                                   video_timecode,
-                                   *color_data_buffer,
-                                   LACING_AUTO,
-                                   video_frame.keyframe() ? nullptr : past_color_block_blob_);
-
-    auto depth_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto depth_data_buffer{new DataBuffer{const_cast<uint8_t*>(video_frame.depth_bytes().data()),
-        gsl::narrow<uint32_t>(video_frame.depth_bytes().size())}};
-    video_cluster->AddBlockBlob(depth_block_blob);
-    depth_block_blob->SetParent(*video_cluster);
-    depth_block_blob->AddFrameAuto(*writer_tracks_.depth_track,
+    prepareCluster(video_timecode,
+                   video_frame.keyframe(),
+                   video_frame.color_bytes().size() + video_frame.depth_bytes().size());
+
+    auto color_block_blob{addBlock(*writer_tracks_.color_track,
                                    video_timecode,
-                                   *depth_data_buffer,
-                                   LACING_AUTO,
-                                   video_frame.keyframe() ? nullptr : past_depth_block_blob_);
+                                   video_frame.color_bytes(),
+                                   video_frame.keyframe() ? nullptr : past_color_block_blob_)};
+    // Index keyframes in Cues so RecordParser can seek without reading every cluster.
+    if (video_frame.keyframe())
+        cues.AddBlockBlob(*color_block_blob);
 
-    video_cluster->Render(io_callback_, cues);
-    video_cluster->ReleaseFrames();
+    auto depth_block_blob{addBlock(*writer_tracks_.depth_track,
+                                   video_timecode,
+                                   video_frame.depth_bytes(),
+                                   video_frame.keyframe() ? nullptr : past_depth_block_blob_)};
 
     past_color_block_blob_ = color_block_blob;
     past_depth_block_blob_ = depth_block_blob;
@@ -451,32 +491,12 @@ void RecordWriter::writeAudioFrame(const RecordAudioFrame& audio_frame)
         return;
     }
 
-    auto audio_frame_timecode{gsl::narrow<uint64_t>(time_point_ns)};
+    auto audio_timecode{gsl::narrow<uint64_t>(time_point_ns)};
 
-    auto& cues{GetChild<KaxCues>(segment_)};
-    auto audio_cluster_timecode{audio_frame_timecode};
-
-    auto audio_cluster{new KaxCluster};
-    segment_.PushElement(*audio_cluster);
-    audio_cluster->InitTimecode(audio_cluster_timecode / MATROSKA_TIMESCALE_NS,
-                                MATROSKA_TIMESCALE_NS);
-    audio_cluster->SetParent(segment_);
-    audio_cluster->EnableChecksum();
+    prepareCluster(audio_timecode, false, audio_frame.bytes().size());
+    addBlock(*writer_tracks_.audio_track, audio_timecode, audio_frame.bytes());
 
-    auto block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    // const_cast is okay here since the audio_bytes will not be modified here,
-    // and this lets the argument become a const one, which is helpful for the C API side.
-    // For example, this makes calling the C API easier from Swift.
-    auto data_buffer{new DataBuffer{const_cast<uint8_t*>(audio_frame.bytes().data()),
-                                    gsl::narrow<uint32_t>(audio_frame.bytes().size())}};
-    audio_cluster->AddBlockBlob(block_blob);
-    block_blob->SetParent(*audio_cluster);
-    block_blob->AddFrameAuto(*writer_tracks_.audio_track, audio_cluster_timecode, *data_buffer);
-
-    audio_cluster->Render(io_callback_, cues);
-    audio_cluster->ReleaseFrames();
-
-    last_timecode_ = audio_cluster_timecode;
+    last_timecode_ = audio_timecode;
 }
 
 void RecordWriter::writeIMUFrame(const RecordIMUFrame& imu_frame)
@@ -490,59 +510,32 @@ void RecordWriter::writeIMUFrame(const RecordIMUFrame& imu_frame)
 
     auto imu_timecode{gsl::narrow<uint64_t>(time_point_ns)};
 
-    auto& cues{GetChild<KaxCues>(segment_)};
+    if (cluster_policy_.imu_samples_per_block > 0) {
+        // The sample waits in pending_imu_samples_ until there are enough samples for a block
+        // or the cluster gets rendered.
+        prepareCluster(imu_timecode, false, IMU_SAMPLE_SIZE);
+        pending_imu_samples_.append(imu_frame);
+        if (pending_imu_samples_.size() >=
+            gsl::narrow<size_t>(cluster_policy_.imu_samples_per_block))
+            writeIMUBlock();
 
-    auto imu_cluster{new KaxCluster};
-    segment_.PushElement(*imu_cluster);
-    imu_cluster->InitTimecode(imu_timecode / MATROSKA_TIMESCALE_NS, MATROSKA_TIMESCALE_NS);
-    imu_cluster->SetParent(segment_);
-    imu_cluster->EnableChecksum();
+        last_timecode_ = imu_timecode;
+        return;
+    }
 
     Bytes acceleration_bytes(convert_vec3_to_bytes(imu_frame.acceleration()));
-
-    auto acceleration_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto acceleration_data_buffer{
-        new DataBuffer{reinterpret_cast<uint8_t*>(acceleration_bytes.data()),
-                       gsl::narrow<uint32_t>(acceleration_bytes.size())}};
-    imu_cluster->AddBlockBlob(acceleration_block_blob);
-    acceleration_block_blob->SetParent(*imu_cluster);
-    acceleration_block_blob->AddFrameAuto(
-        *writer_tracks_.acceleration_track, imu_timecode, *acceleration_data_buffer);
-
     Bytes rotation_rate_bytes(convert_vec3_to_bytes(imu_frame.rotation_rate()));
-
-    auto rotation_rate_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto rotation_rate_data_buffer{
-        new DataBuffer{reinterpret_cast<uint8_t*>(rotation_rate_bytes.data()),
-                       gsl::narrow<uint32_t>(rotation_rate_bytes.size())}};
-    imu_cluster->AddBlockBlob(rotation_rate_block_blob);
-    rotation_rate_block_blob->SetParent(*imu_cluster);
-    rotation_rate_block_blob->AddFrameAuto(
-        *writer_tracks_.rotation_rate_track, imu_timecode, *rotation_rate_data_buffer);
-
     Bytes magnetic_field_bytes(convert_vec3_to_bytes(imu_frame.magnetic_field()));
-
-    auto magnetic_field_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto magnetic_field_data_buffer{
-        new DataBuffer{reinterpret_cast<uint8_t*>(magnetic_field_bytes.data()),
-                       gsl::narrow<uint32_t>(magnetic_field_bytes.size())}};
-    imu_cluster->AddBlockBlob(magnetic_field_block_blob);
-    magnetic_field_block_blob->SetParent(*imu_cluster);
-    magnetic_field_block_blob->AddFrameAuto(
-        *writer_tracks_.magnetic_field_track, imu_timecode, *magnetic_field_data_buffer);
-
     Bytes gravity_bytes(convert_vec3_to_bytes(imu_frame.gravity()));
 
-    auto gravity_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto gravity_data_buffer{new DataBuffer{reinterpret_cast<uint8_t*>(gravity_bytes.data()),
-                                            gsl::narrow<uint32_t>(gravity_bytes.size())}};
-    imu_cluster->AddBlockBlob(gravity_block_blob);
-    gravity_block_blob->SetParent(*imu_cluster);
-    gravity_block_blob->AddFrameAuto(
-        *writer_tracks_.gravity_track, imu_timecode, *gravity_data_buffer);
-
-    imu_cluster->Render(io_callback_, cues);
-    imu_cluster->ReleaseFrames();
+    prepareCluster(imu_timecode,
+                   false,
+                   acceleration_bytes.size() + rotation_rate_bytes.size() +
+                       magnetic_field_bytes.size() + gravity_bytes.size());
+    addBlock(*writer_tracks_.acceleration_track, imu_timecode, acceleration_bytes);
+    addBlock(*writer_tracks_.rotation_rate_track, imu_timecode, rotation_rate_bytes);
+    addBlock(*writer_tracks_.magnetic_field_track, imu_timecode, magnetic_field_bytes);
+    addBlock(*writer_tracks_.gravity_track, imu_timecode, gravity_bytes);
 
     last_timecode_ = imu_timecode;
 }
@@ -558,37 +551,12 @@ void RecordWriter::writePoseFrame(const RecordPoseFrame& pose_frame)
 
     auto pose_timecode{gsl::narrow<uint64_t>(time_point_ns)};
 
-    auto& cues{GetChild<KaxCues>(segment_)};
-
-    auto pose_cluster{new KaxCluster};
-    segment_.PushElement(*pose_cluster);
-    pose_cluster->InitTimecode(pose_timecode / MATROSKA_TIMESCALE_NS, MATROSKA_TIMESCALE_NS);
-    pose_cluster->SetParent(segment_);
-    pose_cluster->EnableChecksum();
-
     Bytes translation_bytes(convert_vec3_to_bytes(pose_frame.translation()));
-
-    auto translation_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto translation_data_buffer{
-        new DataBuffer{reinterpret_cast<uint8_t*>(translation_bytes.data()),
-                       gsl::narrow<uint32_t>(translation_bytes.size())}};
-    pose_cluster->AddBlockBlob(translation_block_blob);
-    translation_block_blob->SetParent(*pose_cluster);
-    translation_block_blob->AddFrameAuto(
-        *writer_tracks_.translation_track, pose_timecode, *translation_data_buffer);
-
     Bytes rotation_bytes(convert_quat_to_bytes(pose_frame.rotation()));
 
-    auto rotation_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto rotation_data_buffer{new DataBuffer{reinterpret_cast<uint8_t*>(rotation_bytes.data()),
-                                             gsl::narrow<uint32_t>(rotation_bytes.size())}};
-    pose_cluster->AddBlockBlob(rotation_block_blob);
-    rotation_block_blob->SetParent(*pose_cluster);
-    rotation_block_blob->AddFrameAuto(
-        *writer_tracks_.rotation_track, pose_timecode, *rotation_data_buffer);
-
-    pose_cluster->Render(io_callback_, cues);
-    pose_cluster->ReleaseFrames();
+    prepareCluster(pose_timecode, false, translation_bytes.size() + rotation_bytes.size());
+    addBlock(*writer_tracks_.translation_track, pose_timecode, translation_bytes);
+    addBlock(*writer_tracks_.rotation_track, pose_timecode, rotation_bytes);
 
     last_timecode_ = pose_timecode;
 }
@@ -604,34 +572,93 @@ void RecordWriter::writeCalibrationFrame(const RecordCalibrationFrame& calibrati
 
     auto calibration_timecode{gsl::narrow<uint64_t>(time_point_ns)};
 
-    auto& cues{GetChild<KaxCues>(segment_)};
+    string calibration_str{calibration_frame.camera_calibration()->toJson().dump()};
+    span<const uint8_t> calibration_bytes{reinterpret_cast<const uint8_t*>(calibration_str.data()),
+                                          calibration_str.size()};
 
-    auto calibration_cluster{new KaxCluster};
-    segment_.PushElement(*calibration_cluster);
-    calibration_cluster->InitTimecode(calibration_timecode / MATROSKA_TIMESCALE_NS, MATROSKA_TIMESCALE_NS);
-    calibration_cluster->SetParent(segment_);
-    calibration_cluster->EnableChecksum();
+    prepareCluster(calibration_timecode, false, calibration_bytes.size());
+    addBlock(*writer_tracks_.calibration_track, calibration_timecode, calibration_bytes);
 
-    string calibration_str{calibration_frame.camera_calibration()->toJson().dump()};
-    std::vector<char> calibration_chars(calibration_str.begin(), calibration_str.end());
+    last_timecode_ = calibration_timecode;
+}
 
-    auto calibration_block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
-    auto calibration_data_buffer{
-        new DataBuffer{reinterpret_cast<uint8_t*>(calibration_chars.data()),
-                       gsl::narrow<uint32_t>(calibration_chars.size())}};
-    calibration_cluster->AddBlockBlob(calibration_block_blob);
-    calibration_block_blob->SetParent(*calibration_cluster);
-    calibration_block_blob->AddFrameAuto(
-        *writer_tracks_.calibration_track, calibration_timecode, *calibration_data_buffer);
+void RecordWriter::prepareCluster(uint64_t timecode, bool video_keyframe, size_t size)
+{
+    if (cluster_) {
+        // Relative timecodes of blocks are int16 in the unit of MATROSKA_TIMESCALE_NS.
+        bool out_of_range{timecode < cluster_timecode_ ||
+                          (timecode - cluster_timecode_) / MATROSKA_TIMESCALE_NS >
+                              static_cast<uint64_t>(std::numeric_limits<int16_t>::max())};
+        bool too_long{cluster_policy_.max_duration_us <= 0 ||
+                      static_cast<int64_t>(timecode - cluster_timecode_) >
+                          cluster_policy_.max_duration_us * 1000};
+        bool too_large{cluster_size_ + size > cluster_policy_.max_size_bytes};
+        bool at_keyframe{video_keyframe && cluster_policy_.cluster_at_keyframes};
+        if (out_of_range || too_long || too_large || at_keyframe)
+            renderCluster();
+    }
 
-    calibration_cluster->Render(io_callback_, cues);
-    calibration_cluster->ReleaseFrames();
+    if (cluster_)
+        return;
 
-    last_timecode_ = calibration_timecode;
+    cluster_ = new KaxCluster;
+    segment_.PushElement(*cluster_);
+    cluster_->InitTimecode(timecode / MATROSKA_TIMESCALE_NS, MATROSKA_TIMESCALE_NS);
+    cluster_->SetParent(segment_);
+    cluster_->EnableChecksum();
+    cluster_timecode_ = timecode / MATROSKA_TIMESCALE_NS * MATROSKA_TIMESCALE_NS;
+    cluster_size_ = 0;
+}
+
+KaxBlockBlob* RecordWriter::addBlock(KaxTrackEntry& track,
+                                     uint64_t timecode,
+                                     span<const uint8_t> bytes,
+                                     const KaxBlockBlob* past_block_blob)
+{
+    auto block_blob{new KaxBlockBlob(BLOCK_BLOB_ALWAYS_SIMPLE)};
+    // The bytes get copied into the DataBuffer since the cluster gets rendered after the bytes
+    // are gone. KaxCluster::ReleaseFrames() frees the copy.
+    // const_cast is okay here since the bytes will not be modified.
+    auto data_buffer{new DataBuffer{const_cast<uint8_t*>(bytes.data()),
+                                    gsl::narrow<uint32_t>(bytes.size()),
+                                    nullptr,
+                                    true}};
+    cluster_->AddBlockBlob(block_blob);
+    block_blob->SetParent(*cluster_);
+    block_blob->AddFrameAuto(track, timecode, *data_buffer, LACING_AUTO, past_block_blob);
+    cluster_size_ += bytes.size();
+    return block_blob;
+}
+
+void RecordWriter::writeIMUBlock()
+{
+    if (pending_imu_samples_.empty())
+        return;
+
+    auto imu_timecode{gsl::narrow<uint64_t>(pending_imu_samples_.time_points_us.front() * 1000)};
+    Bytes imu_bytes(convert_imu_samples_to_bytes(pending_imu_samples_));
+    addBlock(*writer_tracks_.imu_track, imu_timecode, imu_bytes);
+    pending_imu_samples_.clear();
+}
+
+void RecordWriter::renderCluster()
+{
+    if (!cluster_)
+        return;
+
+    writeIMUBlock();
+
+    auto& cues{GetChild<KaxCues>(segment_)};
+    cluster_->Render(io_callback_, cues);
+    cluster_->ReleaseFrames();
+    cluster_ = nullptr;
+    cluster_size_ = 0;
 }
 
 void RecordWriter::flush()
 {
+    renderCluster();
+
     {
         auto duration{gsl::narrow<uint64_t>(last_timecode_ / MATROSKA_TIMESCALE_NS)};
 
@@ -329,6 +329,12 @@ void* rgbd_color_decoder_ctor(rgbdColorCodecType type)
     return new ColorDecoder{static_cast<ColorCodecType>(type)};
 }
 
+void* rgbd_color_decoder_ctor_with_options(rgbdColorCodecType type, void* options_ptr)
+{
+    return new ColorDecoder{static_cast<ColorCodecType>(type),
+                            *static_cast<ColorDecoderOptions*>(options_ptr)};
+}
+
 void rgbd_color_decoder_dtor(void* ptr)
 {
     delete static_cast<ColorDecoder*>(ptr);
@@ -341,12 +347,45 @@ void* rgbd_color_decoder_decode(void* ptr, const uint8_t* vp8_frame_data, size_t
 }
 //////// END COLOR DECODER ////////
 
+//////// START COLOR DECODER OPTIONS ////////
+void* rgbd_color_decoder_options_ctor()
+{
+    return new ColorDecoderOptions;
+}
+
+void rgbd_color_decoder_options_dtor(void* ptr)
+{
+    delete static_cast<ColorDecoderOptions*>(ptr);
+}
+
+int rgbd_color_decoder_options_get_thread_count(void* ptr)
+{
+    return static_cast<ColorDecoderOptions*>(ptr)->thread_count;
+}
+
+void rgbd_color_decoder_options_set_thread_count(void* ptr, int thread_count)
+{
+    static_cast<ColorDecoderOptions*>(ptr)->thread_count = thread_count;
+}
+//////// END COLOR DECODER OPTIONS ////////
+
 //////// START COLOR ENCODER ////////
 void* rgbd_color_encoder_ctor(rgbdColorCodecType type, int width, int height)
 {
     return new ColorEncoder{static_cast<ColorCodecType>(type), width, height};
 }
 
+void* rgbd_color_encoder_ctor_with_options(rgbdColorCodecType type,
+                                           int width,
+                                           int height,
+                                           void* options_ptr)
+{
+    return new ColorEncoder{static_cast<ColorCodecType>(type),
+                            width,
+                            height,
+                            *static_cast<ColorEncoderOptions*>(options_ptr)};
+}
+
 void rgbd_color_encoder_dtor(void* ptr)
 {
     delete static_cast<ColorEncoder*>(ptr);
@@ -358,7 +397,137 @@ void* rgbd_color_encoder_encode(void* ptr, void* yuv_frame_ptr, bool keyframe)
     auto bytes{encoder->encode(*static_cast<YuvFrame*>(yuv_frame_ptr), keyframe)};
     return new NativeByteArray{std::move(bytes)};
 }
-//////// START COLOR ENCODER ////////
+
+// Returns nullptr when time_point_us is not after the time point of the previous frame.
+void* rgbd_color_encoder_encode_with_time_point_us(void* ptr,
+                                                   void* yuv_frame_ptr,
+                                                   bool keyframe,
+                                                   int64_t time_point_us)
+{
+    try {
+        auto encoder{static_cast<ColorEncoder*>(ptr)};
+        auto bytes{
+            encoder->encode(*static_cast<YuvFrame*>(yuv_frame_ptr), keyframe, time_point_us)};
+        return new NativeByteArray{std::move(bytes)};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_color_encoder_encode_with_time_point_us: {}", e.what());
+        return nullptr;
+    }
+}
+
+// y_data should hold height rows of y_stride bytes, and u_data and v_data should each hold
+// height / 2 rows of u_stride and v_stride bytes, where width and height are of the encoder.
+// Only the strides can be checked here: returns nullptr when a stride is shorter than its row.
+void* rgbd_color_encoder_encode_planes(void* ptr,
+                                       const uint8_t* y_data,
+                                       int y_stride,
+                                       const uint8_t* u_data,
+                                       int u_stride,
+                                       const uint8_t* v_data,
+                                       int v_stride,
+                                       bool keyframe)
+{
+    try {
+        auto encoder{static_cast<ColorEncoder*>(ptr)};
+        auto bytes{
+            encoder->encodePlanes(y_data, y_stride, u_data, u_stride, v_data, v_stride, keyframe)};
+        return new NativeByteArray{std::move(bytes)};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_color_encoder_encode_planes: {}", e.what());
+        return nullptr;
+    }
+}
+
+bool rgbd_color_encoder_get_last_keyframe(void* ptr)
+{
+    return static_cast<ColorEncoder*>(ptr)->last_keyframe();
+}
+//////// END COLOR ENCODER ////////
+
+//////// START COLOR ENCODER OPTIONS ////////
+void* rgbd_color_encoder_options_ctor()
+{
+    return new ColorEncoderOptions;
+}
+
+void rgbd_color_encoder_options_dtor(void* ptr)
+{
+    delete static_cast<ColorEncoderOptions*>(ptr);
+}
+
+rgbdColorRateControlMode rgbd_color_encoder_options_get_rate_control_mode(void* ptr)
+{
+    return static_cast<rgbdColorRateControlMode>(
+        static_cast<ColorEncoderOptions*>(ptr)->rate_control_mode);
+}
+
+void rgbd_color_encoder_options_set_rate_control_mode(void* ptr,
+                                                      rgbdColorRateControlMode rate_control_mode)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->rate_control_mode =
+        static_cast<ColorRateControlMode>(rate_control_mode);
+}
+
+int rgbd_color_encoder_options_get_thread_count(void* ptr)
+{
+    return static_cast<ColorEncoderOptions*>(ptr)->thread_count;
+}
+
+void rgbd_color_encoder_options_set_thread_count(void* ptr, int thread_count)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->thread_count = thread_count;
+}
+
+void* rgbd_color_encoder_options_get_deadline(void* ptr)
+{
+    return new NativeString{static_cast<ColorEncoderOptions*>(ptr)->deadline};
+}
+
+void rgbd_color_encoder_options_set_deadline(void* ptr, const char* deadline)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->deadline = deadline;
+}
+
+int rgbd_color_encoder_options_get_cpu_used(void* ptr)
+{
+    return static_cast<ColorEncoderOptions*>(ptr)->cpu_used;
+}
+
+void rgbd_color_encoder_options_set_cpu_used(void* ptr, int cpu_used)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->cpu_used = cpu_used;
+}
+
+int rgbd_color_encoder_options_get_target_bitrate_kbps(void* ptr)
+{
+    return static_cast<ColorEncoderOptions*>(ptr)->target_bitrate_kbps;
+}
+
+void rgbd_color_encoder_options_set_target_bitrate_kbps(void* ptr, int target_bitrate_kbps)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->target_bitrate_kbps = target_bitrate_kbps;
+}
+
+int rgbd_color_encoder_options_get_cq_level(void* ptr)
+{
+    return static_cast<ColorEncoderOptions*>(ptr)->cq_level;
+}
+
+void rgbd_color_encoder_options_set_cq_level(void* ptr, int cq_level)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->cq_level = cq_level;
+}
+
+int rgbd_color_encoder_options_get_keyframe_interval(void* ptr)
+{
+    return static_cast<ColorEncoderOptions*>(ptr)->keyframe_interval;
+}
+
+void rgbd_color_encoder_options_set_keyframe_interval(void* ptr, int keyframe_interval)
+{
+    static_cast<ColorEncoderOptions*>(ptr)->keyframe_interval = keyframe_interval;
+}
+//////// END COLOR ENCODER OPTIONS ////////
 
 //////// START DEPTH DECODER ////////
 void* rgbd_depth_decoder_ctor(rgbdDepthCodecType depth_codec_type)
@@ -371,10 +540,59 @@ void rgbd_depth_decoder_dtor(void* ptr)
     delete static_cast<DepthDecoder*>(ptr);
 }
 
+// Returns nullptr when depth_bytes are invalid.
 void* rgbd_depth_decoder_decode(void* ptr, const uint8_t* depth_bytes_data, size_t depth_bytes_size)
 {
-    auto depth_frame{static_cast<DepthDecoder*>(ptr)->decode({depth_bytes_data, depth_bytes_size})};
-    return depth_frame.release();
+    try {
+        auto depth_frame{
+            static_cast<DepthDecoder*>(ptr)->decode({depth_bytes_data, depth_bytes_size})};
+        return depth_frame.release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_depth_decoder_decode: {}", e.what());
+        return nullptr;
+    }
+}
+
+int rgbd_depth_decoder_decode_into(void* ptr,
+                                   const uint8_t* depth_bytes_data,
+                                   size_t depth_bytes_size,
+                                   int32_t* output,
+                                   size_t output_size)
+{
+    try {
+        static_cast<DepthDecoder*>(ptr)->decodeInto({depth_bytes_data, depth_bytes_size},
+                                                    {output, output_size});
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_depth_decoder_decode_into: {}", e.what());
+        return -1;
+    }
+}
+
+int rgbd_depth_decoder_decode_batch_into(void* ptr,
+                                         const uint8_t* depth_bytes_data,
+                                         const size_t* depth_bytes_sizes,
+                                         size_t frame_count,
+                                         int32_t* output,
+                                         size_t output_size)
+{
+    // The frames are stored back to back in depth_bytes_data,
+    // as rgbd_depth_encoder_encode_batch_into writes them.
+    vector<span<const uint8_t>> bytes_list;
+    bytes_list.reserve(frame_count);
+    size_t cursor{0};
+    for (size_t i{0}; i < frame_count; ++i) {
+        bytes_list.push_back({depth_bytes_data + cursor, depth_bytes_sizes[i]});
+        cursor += depth_bytes_sizes[i];
+    }
+
+    try {
+        static_cast<DepthDecoder*>(ptr)->decodeBatchInto(bytes_list, {output, output_size});
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_depth_decoder_decode_batch_into: {}", e.what());
+        return -1;
+    }
 }
 //////// END DEPTH DECODER ////////
 
@@ -393,9 +611,54 @@ void* rgbd_depth_encoder_encode(void* ptr, const int32_t* depth_values, bool key
 {
     return new NativeByteArray{static_cast<DepthEncoder*>(ptr)->encode(depth_values, keyframe)};
 }
+
+size_t rgbd_depth_encoder_get_max_encoded_size(void* ptr)
+{
+    return static_cast<DepthEncoder*>(ptr)->getMaxEncodedSize();
+}
+
+int64_t rgbd_depth_encoder_encode_into(void* ptr,
+                                       const int32_t* depth_values,
+                                       bool keyframe,
+                                       uint8_t* output,
+                                       size_t output_size)
+{
+    try {
+        return static_cast<DepthEncoder*>(ptr)->encodeInto(
+            depth_values, keyframe, span<uint8_t>{output, output_size});
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_depth_encoder_encode_into: {}", e.what());
+        return -1;
+    }
+}
+
+int64_t rgbd_depth_encoder_encode_batch_into(void* ptr,
+                                             const int32_t* depth_values,
+                                             const bool* keyframes,
+                                             size_t frame_count,
+                                             uint8_t* output,
+                                             size_t output_size,
+                                             size_t* encoded_sizes)
+{
+    try {
+        return static_cast<DepthEncoder*>(ptr)->encodeBatchInto(
+            depth_values,
+            vector<bool>(keyframes, keyframes + frame_count),
+            span<uint8_t>{output, output_size},
+            span<size_t>{encoded_sizes, frame_count});
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_depth_encoder_encode_batch_into: {}", e.what());
+        return -1;
+    }
+}
 //////// END DEPTH DECODER ////////
 
 //////// START DIRECTION TABLE ////////
+void* rgbd_direction_table_ctor(void* calibration_ptr)
+{
+    return new DirectionTable{*static_cast<const CameraCalibration*>(calibration_ptr)};
+}
+
 void rgbd_direction_table_dtor(void* ptr)
 {
     delete static_cast<DirectionTable*>(ptr);
@@ -439,26 +702,134 @@ void* rgbd_frame_mapper_ctor(void* src_calibration, void* dst_calibration)
                            *static_cast<const CameraCalibration*>(dst_calibration)};
 }
 
+void* rgbd_frame_mapper_ctor_with_sampling_mode(void* src_calibration,
+                                                void* dst_calibration,
+                                                rgbdFrameMapperSamplingMode sampling_mode)
+{
+    return new FrameMapper{*static_cast<const CameraCalibration*>(src_calibration),
+                           *static_cast<const CameraCalibration*>(dst_calibration),
+                           static_cast<FrameMapperSamplingMode>(sampling_mode)};
+}
+
 void rgbd_frame_mapper_dtor(void* ptr)
 {
     delete static_cast<FrameMapper*>(ptr);
 }
 
+// Returns nullptr when color_frame is not of the size in the source calibration.
 void* rgbd_frame_mapper_map_color_frame(void* ptr, void* color_frame)
 {
-    auto frame_mapper{static_cast<FrameMapper*>(ptr)};
-    auto mapped_color_frame{frame_mapper->mapColorFrame(*static_cast<YuvFrame*>(color_frame))};
-    return mapped_color_frame.release();
+    try {
+        auto frame_mapper{static_cast<FrameMapper*>(ptr)};
+        auto mapped_color_frame{
+            frame_mapper->mapColorFrame(*static_cast<YuvFrame*>(color_frame))};
+        return mapped_color_frame.release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_frame_mapper_map_color_frame: {}", e.what());
+        return nullptr;
+    }
 }
 
+// Returns nullptr when depth_frame is not of the size in the source calibration.
 void* rgbd_frame_mapper_map_depth_frame(void* ptr, void* depth_frame)
 {
-    auto frame_mapper{static_cast<FrameMapper*>(ptr)};
-    auto mapped_depth_frame{frame_mapper->mapDepthFrame(*static_cast<Int32Frame*>(depth_frame))};
-    return mapped_depth_frame.release();
+    try {
+        auto frame_mapper{static_cast<FrameMapper*>(ptr)};
+        auto mapped_depth_frame{
+            frame_mapper->mapDepthFrame(*static_cast<Int32Frame*>(depth_frame))};
+        return mapped_depth_frame.release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_frame_mapper_map_depth_frame: {}", e.what());
+        return nullptr;
+    }
+}
+
+int rgbd_frame_mapper_map_color_frame_into(void* ptr, void* color_frame, void* mapped_color_frame)
+{
+    try {
+        static_cast<FrameMapper*>(ptr)->mapColorFrameInto(
+            *static_cast<YuvFrame*>(color_frame), *static_cast<YuvFrame*>(mapped_color_frame));
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_frame_mapper_map_color_frame_into: {}", e.what());
+        return -1;
+    }
+}
+
+int rgbd_frame_mapper_map_depth_frame_into(void* ptr, void* depth_frame, void* mapped_depth_frame)
+{
+    try {
+        static_cast<FrameMapper*>(ptr)->mapDepthFrameInto(
+            *static_cast<Int32Frame*>(depth_frame), *static_cast<Int32Frame*>(mapped_depth_frame));
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_frame_mapper_map_depth_frame_into: {}", e.what());
+        return -1;
+    }
 }
 //////// END FRAME MAPPER ////////
 
+//////// START POINT CLOUD BUILDER ////////
+void* rgbd_point_cloud_builder_ctor(void* direction_table_ptr, float depth_unit, int thread_count)
+{
+    return new PointCloudBuilder{
+        *static_cast<const DirectionTable*>(direction_table_ptr), depth_unit, thread_count};
+}
+
+void* rgbd_point_cloud_builder_ctor_with_color_size(void* direction_table_ptr,
+                                                    float depth_unit,
+                                                    int color_width,
+                                                    int color_height,
+                                                    int thread_count)
+{
+    return new PointCloudBuilder{*static_cast<const DirectionTable*>(direction_table_ptr),
+                                 depth_unit,
+                                 color_width,
+                                 color_height,
+                                 thread_count};
+}
+
+void rgbd_point_cloud_builder_dtor(void* ptr)
+{
+    delete static_cast<PointCloudBuilder*>(ptr);
+}
+
+size_t rgbd_point_cloud_builder_get_point_count(void* ptr)
+{
+    return static_cast<PointCloudBuilder*>(ptr)->point_count();
+}
+
+int rgbd_point_cloud_builder_build_positions(void* ptr,
+                                             void* depth_frame_ptr,
+                                             float* positions,
+                                             size_t positions_size)
+{
+    try {
+        static_cast<PointCloudBuilder*>(ptr)->buildPositions(
+            *static_cast<Int32Frame*>(depth_frame_ptr), {positions, positions_size});
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_point_cloud_builder_build_positions: {}", e.what());
+        return -1;
+    }
+}
+
+int rgbd_point_cloud_builder_build_colors(void* ptr,
+                                          void* yuv_frame_ptr,
+                                          uint8_t* colors,
+                                          size_t colors_size)
+{
+    try {
+        static_cast<PointCloudBuilder*>(ptr)->buildColors(*static_cast<YuvFrame*>(yuv_frame_ptr),
+                                                          {colors, colors_size});
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_point_cloud_builder_build_colors: {}", e.what());
+        return -1;
+    }
+}
+//////// END POINT CLOUD BUILDER ////////
+
 //////// START KINECT CAMERA CALIBRATION ////////
 void* rgbd_kinect_camera_calibration_ctor(int color_width,
                                           int color_height,
@@ -880,7 +1251,8 @@ int64_t rgbd_record_audio_frame_get_time_point_us(void* ptr)
 
 void* rgbd_record_audio_frame_get_bytes(void* ptr)
 {
-    return new NativeByteArray{static_cast<RecordAudioFrame*>(ptr)->bytes()};
+    auto bytes{static_cast<RecordAudioFrame*>(ptr)->bytes()};
+    return new NativeByteArray(bytes.begin(), bytes.end());
 }
 //////// END RECORD AUDIO FRAME ////////
 
@@ -901,6 +1273,38 @@ double rgbd_record_audio_track_get_sampling_frequency(void* ptr)
 }
 //////// END RECORD AUDIO TRACK ////////
 
+//////// START PARALLEL VIDEO DECODER ////////
+void* rgbd_parallel_video_decoder_ctor(rgbdColorCodecType color_codec_type,
+                                       rgbdDepthCodecType depth_codec_type,
+                                       void* record_ptr,
+                                       int thread_count,
+                                       int max_buffered_gops)
+{
+    return new ParallelVideoDecoder{static_cast<ColorCodecType>(color_codec_type),
+                                    static_cast<DepthCodecType>(depth_codec_type),
+                                    static_cast<Record*>(record_ptr)->video_frames(),
+                                    thread_count,
+                                    max_buffered_gops};
+}
+
+void rgbd_parallel_video_decoder_dtor(void* ptr)
+{
+    delete static_cast<ParallelVideoDecoder*>(ptr);
+}
+
+// Returns nullptr when there are no more frames or decoding failed.
+// The returned frame should be deleted with rgbd_video_frame_dtor.
+void* rgbd_parallel_video_decoder_next(void* ptr)
+{
+    try {
+        return static_cast<ParallelVideoDecoder*>(ptr)->next().release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_parallel_video_decoder_next: {}", e.what());
+        return nullptr;
+    }
+}
+//////// END PARALLEL VIDEO DECODER ////////
+
 //////// START RECORD BUILDER ////////
 void* rgbd_record_builder_ctor()
 {
@@ -996,6 +1400,32 @@ void rgbd_record_builder_build_to_path(void* ptr, const char* path)
     auto record_builder{static_cast<RecordBuilder*>(ptr)};
     record_builder->buildToPath(path);
 }
+
+int rgbd_record_builder_start_streaming_to_path(void* ptr,
+                                                const char* path,
+                                                int64_t reorder_window_us)
+{
+    auto record_builder{static_cast<RecordBuilder*>(ptr)};
+    try {
+        record_builder->startStreamingToPath(path, reorder_window_us);
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_builder_start_streaming_to_path: {}", e.what());
+        return -1;
+    }
+}
+
+int rgbd_record_builder_finish_streaming(void* ptr)
+{
+    auto record_builder{static_cast<RecordBuilder*>(ptr)};
+    try {
+        record_builder->finishStreaming();
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_builder_finish_streaming: {}", e.what());
+        return -1;
+    }
+}
 //////// END RECORD BYTES BUILDER ////////
 
 //////// START RECORD CALIBRATION FRAME ////////
@@ -1065,6 +1495,90 @@ rgbdRecordFrameType rgbd_record_frame_get_type(void* ptr)
 }
 //////// END RECORD FRAME ////////
 
+//////// START RECORD FRAME READER ////////
+int rgbd_record_frame_reader_ctor_from_data(void** reader_ptr_ref,
+                                            const void* data_ptr,
+                                            size_t data_size)
+{
+    try {
+        *reader_ptr_ref = new RecordFrameReader{data_ptr, data_size};
+        return 0;
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_frame_reader_ctor_from_data: {}", e.what());
+        return -1;
+    }
+}
+
+void* rgbd_record_frame_reader_ctor_from_path(const char* file_path)
+{
+    try {
+        return new RecordFrameReader{file_path};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_frame_reader_ctor_from_path: {}", e.what());
+        return nullptr;
+    }
+}
+
+void* rgbd_record_frame_reader_ctor_from_mmap(const char* file_path)
+{
+    try {
+        return new RecordFrameReader{string{file_path}, RecordFileAccess::MemoryMap};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_frame_reader_ctor_from_mmap: {}", e.what());
+        return nullptr;
+    }
+}
+
+void rgbd_record_frame_reader_dtor(void* ptr)
+{
+    delete static_cast<RecordFrameReader*>(ptr);
+}
+
+void* rgbd_record_frame_reader_get_info(void* ptr)
+{
+    return const_cast<RecordInfo*>(&(static_cast<RecordFrameReader*>(ptr)->info()));
+}
+
+void* rgbd_record_frame_reader_get_tracks(void* ptr)
+{
+    return const_cast<RecordTracks*>(&(static_cast<RecordFrameReader*>(ptr)->tracks()));
+}
+
+void* rgbd_record_frame_reader_get_attachments(void* ptr)
+{
+    return const_cast<RecordAttachments*>(
+        &(static_cast<RecordFrameReader*>(ptr)->attachments()));
+}
+
+// Returns nullptr when there are no more frames.
+// The returned frame should be deleted with rgbd_record_frame_dtor.
+void* rgbd_record_frame_reader_next(void* ptr)
+{
+    try {
+        return static_cast<RecordFrameReader*>(ptr)->next().release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_frame_reader_next: {}", e.what());
+        return nullptr;
+    }
+}
+
+void rgbd_record_frame_reader_reset(void* ptr)
+{
+    static_cast<RecordFrameReader*>(ptr)->reset();
+}
+
+// Returns -1 when the file is truncated or corrupt.
+int64_t rgbd_record_frame_reader_seek_to_time_point(void* ptr, int64_t time_point_us)
+{
+    try {
+        return static_cast<RecordFrameReader*>(ptr)->seekToTimePoint(time_point_us);
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_frame_reader_seek_to_time_point: {}", e.what());
+        return -1;
+    }
+}
+//////// END RECORD FRAME READER ////////
+
 //////// START RECORD IMU FRAME ////////
 void* rgbd_record_imu_frame_ctor(int64_t time_point_us,
                                float acceleration_x,
@@ -1186,6 +1700,83 @@ float rgbd_record_imu_frame_get_gravity_z(void* ptr)
 }
 //////// END RECORD IMU FRAME ////////
 
+//////// START RECORD IMU SAMPLES ////////
+void rgbd_record_imu_samples_dtor(void* ptr)
+{
+    delete static_cast<RecordIMUSamples*>(ptr);
+}
+
+size_t rgbd_record_imu_samples_get_size(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->size();
+}
+
+const int64_t* rgbd_record_imu_samples_get_time_points_us(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->time_points_us.data();
+}
+
+const float* rgbd_record_imu_samples_get_acceleration_xs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->acceleration.x.data();
+}
+
+const float* rgbd_record_imu_samples_get_acceleration_ys(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->acceleration.y.data();
+}
+
+const float* rgbd_record_imu_samples_get_acceleration_zs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->acceleration.z.data();
+}
+
+const float* rgbd_record_imu_samples_get_rotation_rate_xs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->rotation_rate.x.data();
+}
+
+const float* rgbd_record_imu_samples_get_rotation_rate_ys(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->rotation_rate.y.data();
+}
+
+const float* rgbd_record_imu_samples_get_rotation_rate_zs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->rotation_rate.z.data();
+}
+
+const float* rgbd_record_imu_samples_get_magnetic_field_xs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->magnetic_field.x.data();
+}
+
+const float* rgbd_record_imu_samples_get_magnetic_field_ys(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->magnetic_field.y.data();
+}
+
+const float* rgbd_record_imu_samples_get_magnetic_field_zs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->magnetic_field.z.data();
+}
+
+const float* rgbd_record_imu_samples_get_gravity_xs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->gravity.x.data();
+}
+
+const float* rgbd_record_imu_samples_get_gravity_ys(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->gravity.y.data();
+}
+
+const float* rgbd_record_imu_samples_get_gravity_zs(void* ptr)
+{
+    return static_cast<RecordIMUSamples*>(ptr)->gravity.z.data();
+}
+//////// END RECORD IMU SAMPLES ////////
+
 //////// START RECORD INFO ////////
 void rgbd_record_info_dtor(void* ptr)
 {
@@ -1233,6 +1824,16 @@ void* rgbd_record_parser_ctor_from_path(const char* file_path)
     }
 }
 
+void* rgbd_record_parser_ctor_from_mmap(const char* file_path)
+{
+    try {
+        return new RecordParser{string{file_path}, RecordFileAccess::MemoryMap};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_parser_ctor_from_mmap: {}", e.what());
+        return nullptr;
+    }
+}
+
 void rgbd_record_parser_dtor(void* ptr)
 {
     delete static_cast<RecordParser*>(ptr);
@@ -1243,6 +1844,40 @@ void* rgbd_record_parser_parse(void* ptr, bool with_frames)
     auto file_parser{static_cast<RecordParser*>(ptr)};
     return file_parser->parse(with_frames).release();
 }
+
+void* rgbd_record_parser_parse_next_frame(void* ptr)
+{
+    try {
+        return static_cast<RecordParser*>(ptr)->parseNextFrame().release();
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_parser_parse_next_frame: {}", e.what());
+        return nullptr;
+    }
+}
+
+// Returns -1 when the file is truncated or corrupt.
+int64_t rgbd_record_parser_seek_to_time_point(void* ptr, int64_t time_point_us)
+{
+    try {
+        return static_cast<RecordParser*>(ptr)->seekToTimePoint(time_point_us);
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_parser_seek_to_time_point: {}", e.what());
+        return -1;
+    }
+}
+
+// Returns nullptr when an IMU block is invalid.
+// The returned samples should be deleted with rgbd_record_imu_samples_dtor.
+void* rgbd_record_parser_parse_imu_samples(void* ptr)
+{
+    try {
+        auto imu_samples{static_cast<RecordParser*>(ptr)->parseIMUSamples()};
+        return new RecordIMUSamples{std::move(imu_samples)};
+    } catch (std::runtime_error e) {
+        spdlog::error("error from rgbd_record_parser_parse_imu_samples: {}", e.what());
+        return nullptr;
+    }
+}
 //////// END RECORD PARSER ////////
 
 //////// START RECORD POSE FRAME ////////
@@ -1399,12 +2034,14 @@ bool rgbd_record_video_frame_get_keyframe(void* ptr)
 
 void* rgbd_record_video_frame_get_color_bytes(void* ptr)
 {
-    return new NativeByteArray{static_cast<RecordVideoFrame*>(ptr)->color_bytes()};
+    auto color_bytes{static_cast<RecordVideoFrame*>(ptr)->color_bytes()};
+    return new NativeByteArray(color_bytes.begin(), color_bytes.end());
 }
 
 void* rgbd_record_video_frame_get_depth_bytes(void* ptr)
 {
-    return new NativeByteArray{static_cast<RecordVideoFrame*>(ptr)->depth_bytes()};
+    auto depth_bytes{static_cast<RecordVideoFrame*>(ptr)->depth_bytes()};
+    return new NativeByteArray(depth_bytes.begin(), depth_bytes.end());
 }
 //////// END RECORD VIDEO FRAME ////////
 
@@ -1468,6 +2105,33 @@ float rgbd_undistorted_camera_calibration_get_cy(void* ptr)
 }
 //////// END UNDISTORTED CAMERA CALIBRATION ////////
 
+//////// START VIDEO FRAME ////////
+void rgbd_video_frame_dtor(void* ptr)
+{
+    delete static_cast<VideoFrame*>(ptr);
+}
+
+int64_t rgbd_video_frame_get_time_point_us(void* ptr)
+{
+    return static_cast<VideoFrame*>(ptr)->time_point_us();
+}
+
+bool rgbd_video_frame_get_keyframe(void* ptr)
+{
+    return static_cast<VideoFrame*>(ptr)->keyframe();
+}
+
+void* rgbd_video_frame_get_yuv_frame(void* ptr)
+{
+    return static_cast<VideoFrame*>(ptr)->yuv_frame().get();
+}
+
+void* rgbd_video_frame_get_depth_frame(void* ptr)
+{
+    return static_cast<VideoFrame*>(ptr)->depth_frame().get();
+}
+//////// END VIDEO FRAME ////////
+
 //////// START YUV FRAME ////////
 void* rgbd_yuv_frame_ctor(int width,
                           int height,
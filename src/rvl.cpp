@@ -46,4 +46,29 @@ int64_t DecodeVLE(int*& pBuffer, int& word, int& nibblesWritten)
     return value;
 }
 } // namespace wilson
+
+namespace rvl
+{
+namespace
+{
+std::array<uint8_t, 256> create_nibble_pair_to_bits()
+{
+    std::array<uint8_t, 256> table;
+    for (int i{0}; i < 256; ++i)
+        table[i] = gsl::narrow<uint8_t>(((i >> 4) & 0x7) | ((i & 0x7) << 3));
+    return table;
+}
+
+std::array<uint8_t, 64> create_bits_to_nibble_pair()
+{
+    std::array<uint8_t, 64> table;
+    for (int i{0}; i < 64; ++i)
+        table[i] = gsl::narrow<uint8_t>(((i & 0x7) << 4) | ((i >> 3) & 0x7));
+    return table;
+}
+} // namespace
+
+const std::array<uint8_t, 256> NIBBLE_PAIR_TO_BITS{create_nibble_pair_to_bits()};
+const std::array<uint8_t, 64> BITS_TO_NIBBLE_PAIR{create_bits_to_nibble_pair()};
+} // namespace rvl
 } // namespace rgbd
@@ -7,7 +7,7 @@ namespace rgbd
 {
 RVLDecoder::RVLDecoder() noexcept {}
 
-unique_ptr<Int32Frame> RVLDecoder::decode(span<const uint8_t> bytes) noexcept
+unique_ptr<Int32Frame> RVLDecoder::decode(span<const uint8_t> bytes)
 {
     int cursor{0};
     int width{read_from_bytes<int32_t>(bytes, cursor)};
@@ -17,4 +17,20 @@ unique_ptr<Int32Frame> RVLDecoder::decode(span<const uint8_t> bytes) noexcept
     return std::make_unique<Int32Frame>(width, height,
         rvl::decompress<int32_t>(encoded_depth_values, width * height));
 }
+
+void RVLDecoder::decodeInto(span<const uint8_t> bytes, span<int32_t> output)
+{
+    int cursor{0};
+    int width{read_from_bytes<int32_t>(bytes, cursor)};
+    int height{read_from_bytes<int32_t>(bytes, cursor)};
+    span<const uint8_t> encoded_depth_values{bytes.data() + cursor, bytes.size() - cursor};
+
+    if (output.size() != static_cast<size_t>(width) * height) {
+        spdlog::error("RVLDecoder::decodeInto: output size ({}) does not match {}x{}",
+                      output.size(), width, height);
+        throw std::runtime_error("Invalid output size in RVLDecoder::decodeInto");
+    }
+
+    rvl::decompress_into<int32_t>(encoded_depth_values, output);
+}
 } // namespace rgbd
\ No newline at end of file
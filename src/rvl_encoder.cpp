@@ -16,14 +16,21 @@ DepthCodecType RVLEncoder::getCodecType() noexcept
     return DepthCodecType::RVL;
 }
 
-Bytes RVLEncoder::encode(const int32_t* depth_values, bool keyframe) noexcept
+size_t RVLEncoder::getMaxEncodedSize() noexcept
 {
-    Bytes bytes;
-    append_bytes(bytes, convert_to_bytes(width_));
-    append_bytes(bytes, convert_to_bytes(height_));
-    size_t size{static_cast<size_t>(width_ * height_)};
-    append_bytes(bytes, rvl::compress(span<const int32_t>{depth_values, size}));
+    return sizeof(int32_t) * 2 +
+           rvl::compress_bound<int32_t>(static_cast<size_t>(width_) * height_);
+}
 
-    return bytes;
+size_t RVLEncoder::encodeInto(const int32_t* depth_values,
+                              bool keyframe,
+                              span<uint8_t> output) noexcept
+{
+    int cursor{0};
+    write_to_bytes(output, cursor, width_);
+    write_to_bytes(output, cursor, height_);
+    size_t size{static_cast<size_t>(width_) * height_};
+    return cursor + rvl::compress_to(span<const int32_t>{depth_values, size},
+                                     reinterpret_cast<char*>(output.data() + cursor));
 }
-}
\ No newline at end of file
+} // namespace rgbd
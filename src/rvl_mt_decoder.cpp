@@ -0,0 +1,121 @@
+#include "rvl_mt_decoder.hpp"
+
+#include "byte_utils.hpp"
+#include "rvl.hpp"
+#include "rvl_mt.hpp"
+
+namespace rgbd
+{
+namespace
+{
+struct RVLMTHeader
+{
+    int width;
+    int height;
+    int band_count;
+};
+
+// Reads the header of bytes, throwing when it is truncated or inconsistent with the size of bytes,
+// so decoding the bands does not read outside bytes.
+// The offsets and sizes of the bands get written into band_offsets and band_sizes, which only
+// allocate when there are more bands than in earlier frames.
+RVLMTHeader read_header(span<const uint8_t> bytes,
+                        vector<size_t>& band_offsets,
+                        vector<size_t>& band_sizes)
+{
+    if (bytes.size() < rvl_mt::get_header_size(0)) {
+        spdlog::error("RVLMTDecoder: {} bytes are too short for a header", bytes.size());
+        throw std::runtime_error("Truncated header in RVLMTDecoder");
+    }
+
+    RVLMTHeader header;
+    int cursor{0};
+    header.width = read_from_bytes<int32_t>(bytes, cursor);
+    header.height = read_from_bytes<int32_t>(bytes, cursor);
+    header.band_count = read_from_bytes<int32_t>(bytes, cursor);
+    if (header.width < 0 || header.height < 0) {
+        spdlog::error("RVLMTDecoder: invalid resolution {}x{}", header.width, header.height);
+        throw std::runtime_error("Invalid resolution in RVLMTDecoder");
+    }
+    // RVLMTEncoder writes a single band for frames without rows.
+    if (header.band_count < 1 || header.band_count > std::max(header.height, 1)) {
+        spdlog::error("RVLMTDecoder: invalid band count {} for height {}",
+                      header.band_count,
+                      header.height);
+        throw std::runtime_error("Invalid band count in RVLMTDecoder");
+    }
+
+    const size_t header_size{rvl_mt::get_header_size(header.band_count)};
+    if (bytes.size() < header_size) {
+        spdlog::error("RVLMTDecoder: {} bytes are too short for a header of {} bands",
+                      bytes.size(),
+                      header.band_count);
+        throw std::runtime_error("Truncated header in RVLMTDecoder");
+    }
+
+    band_offsets.resize(header.band_count);
+    band_sizes.resize(header.band_count);
+    size_t band_offset{header_size};
+    for (int band_index{0}; band_index < header.band_count; ++band_index) {
+        const int32_t band_size{read_from_bytes<int32_t>(bytes, cursor)};
+        if (band_size < 0 || static_cast<size_t>(band_size) > bytes.size() - band_offset) {
+            spdlog::error("RVLMTDecoder: band {} of {} bytes at {} exceeds {} bytes",
+                          band_index,
+                          band_size,
+                          band_offset,
+                          bytes.size());
+            throw std::runtime_error("Invalid band size in RVLMTDecoder");
+        }
+        band_offsets[band_index] = band_offset;
+        band_sizes[band_index] = band_size;
+        band_offset += band_size;
+    }
+    return header;
+}
+
+void decode_bands(span<const uint8_t> bytes,
+                  const RVLMTHeader& header,
+                  const vector<size_t>& band_offsets,
+                  const vector<size_t>& band_sizes,
+                  span<int32_t> output)
+{
+    rvl_mt::for_each_band(header.band_count, [&](int band_index) {
+        const int begin_row{
+            rvl_mt::get_band_begin_row(header.height, header.band_count, band_index)};
+        const int end_row{
+            rvl_mt::get_band_begin_row(header.height, header.band_count, band_index + 1)};
+        span<int32_t> band_output{output.data() + static_cast<size_t>(header.width) * begin_row,
+                                  static_cast<size_t>(header.width) * (end_row - begin_row)};
+        rvl::decompress_into<int32_t>(
+            bytes.subspan(band_offsets[band_index], band_sizes[band_index]),
+            band_output);
+    });
+}
+} // namespace
+
+RVLMTDecoder::RVLMTDecoder() noexcept
+    : band_offsets_{}
+    , band_sizes_{}
+{
+}
+
+unique_ptr<Int32Frame> RVLMTDecoder::decode(span<const uint8_t> bytes)
+{
+    auto header{read_header(bytes, band_offsets_, band_sizes_)};
+    vector<int32_t> depth_values(static_cast<size_t>(header.width) * header.height);
+    decode_bands(bytes, header, band_offsets_, band_sizes_, depth_values);
+    return std::make_unique<Int32Frame>(header.width, header.height, std::move(depth_values));
+}
+
+void RVLMTDecoder::decodeInto(span<const uint8_t> bytes, span<int32_t> output)
+{
+    auto header{read_header(bytes, band_offsets_, band_sizes_)};
+    if (output.size() != static_cast<size_t>(header.width) * header.height) {
+        spdlog::error("RVLMTDecoder::decodeInto: output size ({}) does not match {}x{}",
+                      output.size(), header.width, header.height);
+        throw std::runtime_error("Invalid output size in RVLMTDecoder::decodeInto");
+    }
+
+    decode_bands(bytes, header, band_offsets_, band_sizes_, output);
+}
+} // namespace rgbd
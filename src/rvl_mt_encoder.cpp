@@ -0,0 +1,78 @@
+#include "rvl_mt_encoder.hpp"
+
+#include "byte_utils.hpp"
+#include "rvl.hpp"
+#include "rvl_mt.hpp"
+
+namespace rgbd
+{
+RVLMTEncoder::RVLMTEncoder(int width, int height, int band_count)
+    : width_{width}
+    , height_{height}
+    , band_count_{std::max(1, std::min(band_count, height))}
+    , band_offsets_(band_count_)
+    , band_sizes_(band_count_)
+{
+    // Each band gets compressed into its own slot of the output, sized by its bound,
+    // so the slots do not depend on the frame.
+    size_t band_offset{rvl_mt::get_header_size(band_count_)};
+    for (int band_index{0}; band_index < band_count_; ++band_index) {
+        band_offsets_[band_index] = band_offset;
+        band_offset += getMaxBandSize(band_index);
+    }
+}
+
+DepthCodecType RVLMTEncoder::getCodecType() noexcept
+{
+    return DepthCodecType::RVL_MT;
+}
+
+size_t RVLMTEncoder::getMaxEncodedSize() noexcept
+{
+    size_t size{rvl_mt::get_header_size(band_count_)};
+    for (int band_index{0}; band_index < band_count_; ++band_index)
+        size += getMaxBandSize(band_index);
+    return size;
+}
+
+size_t RVLMTEncoder::encodeInto(const int32_t* depth_values,
+                                bool keyframe,
+                                span<uint8_t> output) noexcept
+{
+    const size_t header_size{rvl_mt::get_header_size(band_count_)};
+
+    // The bands get compressed into their slots, then packed right after the header.
+    rvl_mt::for_each_band(band_count_, [&](int band_index) {
+        const int begin_row{rvl_mt::get_band_begin_row(height_, band_count_, band_index)};
+        const int end_row{rvl_mt::get_band_begin_row(height_, band_count_, band_index + 1)};
+        span<const int32_t> band_depth_values{
+            depth_values + static_cast<size_t>(width_) * begin_row,
+            static_cast<size_t>(width_) * (end_row - begin_row)};
+        band_sizes_[band_index] = rvl::compress_to(
+            band_depth_values, reinterpret_cast<char*>(output.data() + band_offsets_[band_index]));
+    });
+
+    int cursor{0};
+    write_to_bytes(output, cursor, width_);
+    write_to_bytes(output, cursor, height_);
+    write_to_bytes(output, cursor, band_count_);
+    for (auto band_size : band_sizes_)
+        write_to_bytes(output, cursor, gsl::narrow<int32_t>(band_size));
+
+    size_t size{header_size};
+    for (int band_index{0}; band_index < band_count_; ++band_index) {
+        memmove(output.data() + size,
+                output.data() + band_offsets_[band_index],
+                band_sizes_[band_index]);
+        size += band_sizes_[band_index];
+    }
+    return size;
+}
+
+size_t RVLMTEncoder::getMaxBandSize(int band_index) noexcept
+{
+    const int begin_row{rvl_mt::get_band_begin_row(height_, band_count_, band_index)};
+    const int end_row{rvl_mt::get_band_begin_row(height_, band_count_, band_index + 1)};
+    return rvl::compress_bound<int32_t>(static_cast<size_t>(width_) * (end_row - begin_row));
+}
+} // namespace rgbd
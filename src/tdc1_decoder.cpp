@@ -21,27 +21,50 @@ TDC1Decoder::TDC1Decoder() noexcept
 {
 }
 
-unique_ptr<Int32Frame> TDC1Decoder::decode(span<const uint8_t> bytes) noexcept
+unique_ptr<Int32Frame> TDC1Decoder::decode(span<const uint8_t> bytes)
 {
+    int width{0};
+    int height{0};
+    updatePreviousDepthValues(bytes, width, height);
+    return std::make_unique<Int32Frame>(width, height, previous_depth_values_);
+}
+
+void TDC1Decoder::decodeInto(span<const uint8_t> bytes, span<int32_t> output)
+{
+    // Checking before updating previous_depth_values_,
+    // so a rejected call leaves the decoder ready for the same bytes again.
     int cursor{0};
     int width{read_from_bytes<int32_t>(bytes, cursor)};
     int height{read_from_bytes<int32_t>(bytes, cursor)};
+    if (output.size() != static_cast<size_t>(width) * height) {
+        spdlog::error("TDC1Decoder::decodeInto: output size ({}) does not match {}x{}",
+                      output.size(), width, height);
+        throw std::runtime_error("Invalid output size in TDC1Decoder::decodeInto");
+    }
+
+    updatePreviousDepthValues(bytes, width, height);
+    std::copy(previous_depth_values_.begin(), previous_depth_values_.end(), output.begin());
+}
+
+// Decompresses keyframes and diffs directly into previous_depth_values_,
+// so no memory gets allocated after the first frame.
+void TDC1Decoder::updatePreviousDepthValues(span<const uint8_t> bytes,
+                                            int& width,
+                                            int& height) noexcept
+{
+    int cursor{0};
+    width = read_from_bytes<int32_t>(bytes, cursor);
+    height = read_from_bytes<int32_t>(bytes, cursor);
     bool keyframe{read_from_bytes<int32_t>(bytes, cursor) > 0 ? true : false};
     span<const uint8_t> encoded_depth_values{bytes.data() + cursor, bytes.size() - cursor};
 
     if (previous_depth_values_.size() == 0)
         previous_depth_values_ = vector<int32_t>(static_cast<int64_t>(width) * height, 0);
 
-    const int depth_value_count{gsl::narrow<int>(previous_depth_values_.size())};
     if (keyframe) {
-        previous_depth_values_ = rvl::decompress<int32_t>(encoded_depth_values, depth_value_count);
-        return std::make_unique<Int32Frame>(width, height, previous_depth_values_);
+        rvl::decompress_into<int32_t>(encoded_depth_values, previous_depth_values_);
+    } else {
+        rvl::decompress_and_add<int32_t>(encoded_depth_values, previous_depth_values_);
     }
-
-    const auto depth_value_diffs{rvl::decompress<int32_t>(encoded_depth_values, depth_value_count)};
-    for (gsl::index i{0}; i < depth_value_count; ++i)
-        previous_depth_values_[i] += depth_value_diffs[i];
-
-    return std::make_unique<Int32Frame>(width, height, previous_depth_values_);
 }
 } // namespace rgbd
@@ -17,36 +17,47 @@ DepthCodecType TDC1Encoder::getCodecType() noexcept
     return DepthCodecType::TDC1;
 }
 
-Bytes TDC1Encoder::encode(const int32_t* depth_values, const bool keyframe) noexcept
+size_t TDC1Encoder::getMaxEncodedSize() noexcept
 {
-    Bytes bytes;
-    append_bytes(bytes, convert_to_bytes(width_));
-    append_bytes(bytes, convert_to_bytes(height_));
-    append_bytes(bytes, convert_to_bytes(static_cast<int32_t>(keyframe)));
+    return sizeof(int32_t) * 3 + rvl::compress_bound<int32_t>(previous_depth_values_.size());
+}
 
-    auto depth_value_count{previous_depth_values_.size()};
-    if (keyframe) {
-        for (gsl::index i{0}; i < depth_value_count; ++i) {
-            previous_depth_values_[i] = depth_values[i];
-        }
+size_t TDC1Encoder::encodeInto(const int32_t* depth_values,
+                               const bool keyframe,
+                               span<uint8_t> output) noexcept
+{
+    int cursor{0};
+    write_to_bytes(output, cursor, width_);
+    write_to_bytes(output, cursor, height_);
+    write_to_bytes(output, cursor, static_cast<int32_t>(keyframe));
 
-        append_bytes(
-            bytes, rvl::compress(span<const int32_t>{depth_values, previous_depth_values_.size()}));
-        return bytes;
-    }
+    const size_t depth_value_count{previous_depth_values_.size()};
+    char* rvl_output{reinterpret_cast<char*>(output.data() + cursor)};
 
-    vector<int32_t> depth_value_diffs(depth_value_count);
-    for (size_t i{0}; i < depth_value_count; ++i) {
-        int diff{depth_values[i] - previous_depth_values_[i]};
-        if ((std::abs(diff) * diff_multiplier_) > previous_depth_values_[i]) {
-            previous_depth_values_[i] = depth_values[i];
-            depth_value_diffs[i] = diff;
-        } else {
-            depth_value_diffs[i] = 0;
-        }
+    if (keyframe) {
+        std::copy(depth_values, depth_values + depth_value_count, previous_depth_values_.begin());
+        return cursor + rvl::compress_to(span<const int32_t>{depth_values, depth_value_count},
+                                         rvl_output);
     }
 
-    append_bytes(bytes, rvl::compress<int32_t>(depth_value_diffs));
-    return bytes;
+    // Diffs get computed while compressing, so no intermediate array of diffs is needed.
+    int32_t* previous_depth_values{previous_depth_values_.data()};
+    const int diff_multiplier{diff_multiplier_};
+    auto is_changed{[=](int64_t i, int32_t diff) {
+        return (std::abs(diff) * diff_multiplier) > previous_depth_values[i];
+    }};
+    auto diff_at{[=](int64_t i) {
+        const int32_t diff{depth_values[i] - previous_depth_values[i]};
+        return is_changed(i, diff) ? diff : 0;
+    }};
+    const size_t rvl_size{rvl::compress_generated<int32_t>(
+        gsl::narrow<int64_t>(depth_value_count), diff_at, rvl_output)};
+
+    // Updating in a separate branchless pass lets the compiler vectorize it.
+    for (int64_t i{0}; i < gsl::narrow<int64_t>(depth_value_count); ++i) {
+        const int32_t diff{depth_values[i] - previous_depth_values[i]};
+        previous_depth_values[i] = is_changed(i, diff) ? depth_values[i] : previous_depth_values[i];
+    }
+    return cursor + rvl_size;
 }
 } // namespace rgbd
@@ -0,0 +1,131 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+
+namespace rgbd
+{
+ThreadPool::Batch::Batch(int count, const std::function<void(int)>& function) noexcept
+    : count{count}
+    , function{function}
+    , next_index{0}
+    , finished_count{0}
+    , exception{}
+{
+}
+
+ThreadPool::ThreadPool(int worker_count) noexcept
+    : mutex_{}
+    , work_condition_variable_{}
+    , done_condition_variable_{}
+    , batches_{}
+    , stopping_{false}
+    , workers_{}
+{
+    try {
+        for (int i{0}; i < worker_count; ++i)
+            workers_.emplace_back(&ThreadPool::runWorker, this);
+    } catch (std::exception& e) {
+        // Running with the workers started so far, which may be none.
+        spdlog::warn("ThreadPool started {} of {} workers: {}",
+                     workers_.size(),
+                     worker_count,
+                     e.what());
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+    work_condition_variable_.notify_all();
+    for (auto& worker : workers_)
+        worker.join();
+}
+
+void ThreadPool::forEach(int count, const std::function<void(int)>& function)
+{
+    if (count <= 0)
+        return;
+
+    if (workers_.empty() || count == 1) {
+        for (int index{0}; index < count; ++index)
+            function(index);
+        return;
+    }
+
+    auto batch{std::make_shared<Batch>(count, function)};
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        batches_.push_back(batch);
+    }
+    work_condition_variable_.notify_all();
+
+    runBatch(*batch);
+
+    {
+        std::unique_lock<std::mutex> lock{mutex_};
+        done_condition_variable_.wait(lock,
+                                      [&batch] { return batch->finished_count == batch->count; });
+        // Workers only skip a batch whose indices are all taken, so removing it here
+        // keeps them from holding on to function after this returns.
+        batches_.erase(std::remove(batches_.begin(), batches_.end(), batch), batches_.end());
+    }
+
+    if (batch->exception)
+        std::rethrow_exception(batch->exception);
+}
+
+ThreadPool& ThreadPool::shared() noexcept
+{
+    static ThreadPool pool{
+        std::max(0, gsl::narrow<int>(std::thread::hardware_concurrency()) - 1)};
+    return pool;
+}
+
+void ThreadPool::runWorker() noexcept
+{
+    while (true) {
+        shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            while (true) {
+                while (!batches_.empty() &&
+                       batches_.front()->next_index >= batches_.front()->count) {
+                    batches_.pop_front();
+                }
+                if (stopping_)
+                    return;
+                if (!batches_.empty())
+                    break;
+                work_condition_variable_.wait(lock);
+            }
+            batch = batches_.front();
+        }
+        runBatch(*batch);
+    }
+}
+
+void ThreadPool::runBatch(Batch& batch) noexcept
+{
+    while (true) {
+        const int index{batch.next_index++};
+        if (index >= batch.count)
+            return;
+
+        std::exception_ptr exception;
+        try {
+            batch.function(index);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (exception && !batch.exception)
+            batch.exception = exception;
+        if (++batch.finished_count == batch.count)
+            done_condition_variable_.notify_all();
+    }
+}
+} // namespace rgbd
@@ -16,20 +16,19 @@ extern "C"
 
 namespace rgbd
 {
-// A helper function for YuvFrame::create(VpxImage) that converts a VpxImage
-// into a vector.
-vector<uint8_t> convert_channel_plane_to_bytes(const uint8_t* buffer,
-                                               const int stride,
-                                               const int width,
-                                               const int height) noexcept
+// A helper function for YuvFrame::copyFrom(AVFrameHandle) that copies a plane of an AVFrame
+// into bytes. Resizing bytes does not allocate when it already has the capacity.
+void copy_channel_plane_to_bytes(const uint8_t* buffer,
+                                 const int stride,
+                                 const int width,
+                                 const int height,
+                                 vector<uint8_t>& bytes)
 {
-    vector<uint8_t> bytes(gsl::narrow<size_t>(width * height));
+    bytes.resize(gsl::narrow<size_t>(width * height));
     for (int i{0}; i < height; ++i)
         memcpy(bytes.data() + gsl::narrow<int>(i * width),
                buffer + gsl::narrow<int>(i * stride),
                width);
-
-    return bytes;
 }
 
 YuvFrame::YuvFrame(const int width,
@@ -96,12 +95,19 @@ YuvFrame::YuvFrame(AVFrameHandle& av_frame)
     , u_channel_()
     , v_channel_()
 {
-    y_channel_ =
-        convert_channel_plane_to_bytes(av_frame->data[0], av_frame->linesize[0], width_, height_);
-    u_channel_ = convert_channel_plane_to_bytes(
-        av_frame->data[1], av_frame->linesize[1], width_ / 2, height_ / 2);
-    v_channel_ = convert_channel_plane_to_bytes(
-        av_frame->data[2], av_frame->linesize[2], width_ / 2, height_ / 2);
+    copyFrom(av_frame);
+}
+
+void YuvFrame::copyFrom(const AVFrameHandle& av_frame)
+{
+    width_ = gsl::narrow<int>(av_frame->width);
+    height_ = gsl::narrow<int>(av_frame->height);
+    copy_channel_plane_to_bytes(
+        av_frame->data[0], av_frame->linesize[0], width_, height_, y_channel_);
+    copy_channel_plane_to_bytes(
+        av_frame->data[1], av_frame->linesize[1], width_ / 2, height_ / 2, u_channel_);
+    copy_channel_plane_to_bytes(
+        av_frame->data[2], av_frame->linesize[2], width_ / 2, height_ / 2, v_channel_);
 }
 
 unique_ptr<YuvFrame> YuvFrame::createFromAzureKinectYuy2Buffer(const uint8_t* buffer,
@@ -0,0 +1,47 @@
+#include "yuv_frame_pool.hpp"
+
+namespace rgbd
+{
+YuvFramePool::YuvFramePool(size_t capacity)
+    : mutex_{}
+    , capacity_{capacity}
+    , yuv_frames_{}
+{
+    yuv_frames_.reserve(capacity_);
+}
+
+unique_ptr<YuvFrame> YuvFramePool::acquire(int width, int height)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (!yuv_frames_.empty()) {
+            auto yuv_frame{std::move(yuv_frames_.back())};
+            yuv_frames_.pop_back();
+            return yuv_frame;
+        }
+    }
+
+    const size_t y_size{static_cast<size_t>(width) * height};
+    return std::make_unique<YuvFrame>(width,
+                                      height,
+                                      vector<uint8_t>(y_size),
+                                      vector<uint8_t>(y_size / 4),
+                                      vector<uint8_t>(y_size / 4));
+}
+
+void YuvFramePool::release(unique_ptr<YuvFrame> yuv_frame)
+{
+    if (!yuv_frame)
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (yuv_frames_.size() < capacity_)
+        yuv_frames_.push_back(std::move(yuv_frame));
+}
+
+size_t YuvFramePool::size()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return yuv_frames_.size();
+}
+} // namespace rgbd
@@ -3,7 +3,12 @@
 #pragma warning(disable : 4201)
 #include <glm/gtx/string_cast.hpp>
 #pragma warning(pop)
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
 #include <rgbd/rgbd.hpp>
+#include <rgbd/rgbd_capi.h>
 
 using namespace rgbd;
 
@@ -33,6 +38,16 @@ KinectCameraCalibration random_calibration()
         random_float()};
 }
 
+// A frame of y_value with neutral chroma.
+YuvFrame create_gray_yuv_frame(int width, int height, uint8_t y_value)
+{
+    return YuvFrame{width,
+                    height,
+                    vector<uint8_t>(width * height, y_value),
+                    vector<uint8_t>(width * height / 4, 128),
+                    vector<uint8_t>(width * height / 4, 128)};
+}
+
 TEST_CASE("KinectCameraCalibration Serialization")
 {
     KinectCameraCalibration calibration{random_calibration()};
@@ -57,6 +72,35 @@ TEST_CASE("RVL Encoding")
         REQUIRE(depth_values[i] == values[i]);
 }
 
+TEST_CASE("RVL is Bit-Exact with the Reference Implementation")
+{
+    std::uniform_int_distribution<int> size_distr(1, 2000);
+    std::uniform_int_distribution<int> percent_distr(0, 99);
+    std::uniform_int_distribution<int> bit_distr(0, 31);
+    for (int i{0}; i < 200; ++i) {
+        const int size{size_distr(eng)};
+        const int zero_percent{percent_distr(eng)};
+        // Covers from single-nibble values to deltas that wrap around int32_t.
+        const int64_t max_value{int64_t{1} << bit_distr(eng)};
+        std::uniform_int_distribution<int64_t> value_distr(-max_value, max_value - 1);
+        vector<int32_t> values(size);
+        for (auto& value : values)
+            value = percent_distr(eng) < zero_percent ? 0 : gsl::narrow<int32_t>(value_distr(eng));
+
+        Bytes reference_bytes(rvl::compress_bound<int32_t>(values.size()));
+        reference_bytes.resize(wilson::CompressRVL(
+            values.data(), reinterpret_cast<char*>(reference_bytes.data()), size));
+        auto bytes{rvl::compress(span<const int32_t>{values})};
+        REQUIRE(bytes == reference_bytes);
+
+        vector<int32_t> reference_values(size);
+        wilson::DecompressRVL(
+            reinterpret_cast<char*>(reference_bytes.data()), reference_values.data(), size);
+        REQUIRE(reference_values == values);
+        REQUIRE(rvl::decompress<int32_t>(bytes, size) == values);
+    }
+}
+
 TEST_CASE("Check Euler Angles <-> Quaternion")
 {
     for (int i{0}; i < 1000; ++i) {
@@ -71,3 +115,1308 @@ TEST_CASE("Check Euler Angles <-> Quaternion")
         REQUIRE(glm::all(glm::epsilonEqual(quat1, quat2, 0.0001f)));
     }
 }
+
+// The calibration of the records built in the tests, matching their 64x48 frames.
+UndistortedCameraCalibration create_test_calibration()
+{
+    return UndistortedCameraCalibration{64, 48, 64, 48, 0.5f, 0.5f, 0.5f, 0.5f};
+}
+
+Bytes build_test_record_bytes(int video_frame_count,
+                              const RecordWriterClusterPolicy& cluster_policy = {})
+{
+    RecordBuilder record_builder;
+    record_builder.setClusterPolicy(cluster_policy);
+    record_builder.setDepthCodecType(DepthCodecType::RVL);
+    record_builder.setCalibration(create_test_calibration());
+    for (int i{0}; i < video_frame_count; ++i) {
+        int64_t time_point_us{i * ONE_SECOND_NS / ONE_MICROSECOND_NS / VIDEO_FRAME_RATE};
+        Bytes color_bytes(16, gsl::narrow<uint8_t>(i));
+        Bytes depth_bytes(16, gsl::narrow<uint8_t>(i));
+        record_builder.addVideoFrame(
+            RecordVideoFrame{time_point_us, i % 10 == 0, color_bytes, depth_bytes});
+        record_builder.addPoseFrame(
+            RecordPoseFrame{time_point_us, glm::vec3{0.0f}, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}});
+    }
+    return record_builder.buildToBytes();
+}
+
+TEST_CASE("RecordFrameReader matches RecordParser")
+{
+    Bytes bytes{build_test_record_bytes(30)};
+    RecordParser parser{bytes.data(), bytes.size()};
+    auto record{parser.parse(true)};
+
+    RecordFrameReader reader{bytes.data(), bytes.size()};
+    size_t video_frame_index{0};
+    size_t pose_frame_index{0};
+    while (auto frame{reader.next()}) {
+        if (frame->getType() == RecordFrameType::Video) {
+            auto video_frame{dynamic_cast<RecordVideoFrame*>(frame.get())};
+            auto& expected_frame{record->video_frames()[video_frame_index++]};
+            REQUIRE(video_frame->time_point_us() == expected_frame.time_point_us());
+            REQUIRE(video_frame->keyframe() == expected_frame.keyframe());
+            auto color_bytes{video_frame->color_bytes()};
+            auto expected_color_bytes{expected_frame.color_bytes()};
+            REQUIRE(std::equal(color_bytes.begin(),
+                               color_bytes.end(),
+                               expected_color_bytes.begin(),
+                               expected_color_bytes.end()));
+            auto depth_bytes{video_frame->depth_bytes()};
+            auto expected_depth_bytes{expected_frame.depth_bytes()};
+            REQUIRE(std::equal(depth_bytes.begin(),
+                               depth_bytes.end(),
+                               expected_depth_bytes.begin(),
+                               expected_depth_bytes.end()));
+        } else if (frame->getType() == RecordFrameType::Pose) {
+            ++pose_frame_index;
+        }
+    }
+    REQUIRE(video_frame_index == record->video_frames().size());
+    REQUIRE(pose_frame_index == record->pose_frames().size());
+}
+
+TEST_CASE("RecordParser Seek to Keyframe")
+{
+    Bytes bytes{build_test_record_bytes(30)};
+    RecordParser parser{bytes.data(), bytes.size()};
+    auto record{parser.parse(true)};
+    auto& video_frames{record->video_frames()};
+
+    for (size_t i{0}; i < video_frames.size(); ++i) {
+        size_t keyframe_index{i - i % 10};
+        int64_t keyframe_time_point_us{video_frames[keyframe_index].time_point_us()};
+        REQUIRE(parser.seekToTimePoint(video_frames[i].time_point_us()) == keyframe_time_point_us);
+
+        unique_ptr<RecordFrame> frame{parser.parseNextFrame()};
+        while (frame && frame->getType() != RecordFrameType::Video)
+            frame = parser.parseNextFrame();
+        REQUIRE(frame);
+        auto video_frame{dynamic_cast<RecordVideoFrame*>(frame.get())};
+        REQUIRE(video_frame->keyframe());
+        REQUIRE(video_frame->time_point_us() == keyframe_time_point_us);
+    }
+
+    // Before the first cue point, the time point of the first frame comes back.
+    int64_t first_time_point_us{parser.seekToTimePoint(video_frames[0].time_point_us() - 1)};
+    unique_ptr<RecordFrame> first_frame{parser.parseNextFrame()};
+    REQUIRE(first_frame);
+    if (first_frame->getType() == RecordFrameType::Video) {
+        auto video_frame{dynamic_cast<RecordVideoFrame*>(first_frame.get())};
+        REQUIRE(video_frame->time_point_us() == first_time_point_us);
+    } else {
+        REQUIRE(first_frame->getType() == RecordFrameType::Pose);
+        auto pose_frame{dynamic_cast<RecordPoseFrame*>(first_frame.get())};
+        REQUIRE(pose_frame->time_point_us() == first_time_point_us);
+    }
+}
+
+TEST_CASE("RecordParser Zero-Copy Payloads")
+{
+    auto bytes{std::make_shared<const Bytes>(build_test_record_bytes(30))};
+    unique_ptr<Record> record;
+    {
+        RecordParser parser{bytes->data(), bytes->size(), bytes};
+        record = parser.parse(true);
+    }
+    RecordParser copying_parser{bytes->data(), bytes->size()};
+    auto copied_record{copying_parser.parse(true)};
+
+    REQUIRE(record->video_frames().size() == copied_record->video_frames().size());
+    for (size_t i{0}; i < record->video_frames().size(); ++i) {
+        auto color_bytes{record->video_frames()[i].color_bytes()};
+        auto copied_color_bytes{copied_record->video_frames()[i].color_bytes()};
+        REQUIRE(color_bytes.data() >= bytes->data());
+        REQUIRE(color_bytes.data() + color_bytes.size() <= bytes->data() + bytes->size());
+        REQUIRE(std::equal(color_bytes.begin(),
+                           color_bytes.end(),
+                           copied_color_bytes.begin(),
+                           copied_color_bytes.end()));
+    }
+}
+
+TEST_CASE("RecordWriter Cluster Policy")
+{
+    RecordWriterClusterPolicy frame_per_cluster_policy;
+    frame_per_cluster_policy.max_duration_us = 0;
+    Bytes frame_per_cluster_bytes{build_test_record_bytes(30, frame_per_cluster_policy)};
+    Bytes bytes{build_test_record_bytes(30)};
+    // Fewer clusters, fewer cluster headers and CRCs.
+    REQUIRE(bytes.size() < frame_per_cluster_bytes.size());
+
+    RecordParser frame_per_cluster_parser{frame_per_cluster_bytes.data(),
+                                          frame_per_cluster_bytes.size()};
+    auto frame_per_cluster_record{frame_per_cluster_parser.parse(true)};
+    RecordParser parser{bytes.data(), bytes.size()};
+    auto record{parser.parse(true)};
+
+    auto& video_frames{record->video_frames()};
+    auto& frame_per_cluster_video_frames{frame_per_cluster_record->video_frames()};
+    REQUIRE(video_frames.size() == frame_per_cluster_video_frames.size());
+    for (size_t i{0}; i < video_frames.size(); ++i) {
+        REQUIRE(video_frames[i].time_point_us() ==
+                frame_per_cluster_video_frames[i].time_point_us());
+        REQUIRE(video_frames[i].keyframe() == frame_per_cluster_video_frames[i].keyframe());
+        auto color_bytes{video_frames[i].color_bytes()};
+        auto frame_per_cluster_color_bytes{frame_per_cluster_video_frames[i].color_bytes()};
+        REQUIRE(std::equal(color_bytes.begin(),
+                           color_bytes.end(),
+                           frame_per_cluster_color_bytes.begin(),
+                           frame_per_cluster_color_bytes.end()));
+    }
+    REQUIRE(record->pose_frames().size() == frame_per_cluster_record->pose_frames().size());
+    REQUIRE(parser.getCuePoints().size() == frame_per_cluster_parser.getCuePoints().size());
+}
+
+Bytes build_test_imu_record_bytes(int imu_frame_count,
+                                  const RecordWriterClusterPolicy& cluster_policy)
+{
+    RecordBuilder record_builder;
+    record_builder.setClusterPolicy(cluster_policy);
+    record_builder.setDepthCodecType(DepthCodecType::RVL);
+    record_builder.setCalibration(create_test_calibration());
+    for (int i{0}; i < VIDEO_FRAME_RATE; ++i) {
+        int64_t time_point_us{i * ONE_SECOND_NS / ONE_MICROSECOND_NS / VIDEO_FRAME_RATE};
+        record_builder.addVideoFrame(RecordVideoFrame{time_point_us,
+                                                      i % 10 == 0,
+                                                      Bytes(16, gsl::narrow<uint8_t>(i)),
+                                                      Bytes(16, gsl::narrow<uint8_t>(i))});
+    }
+    // 200 Hz
+    for (int i{0}; i < imu_frame_count; ++i) {
+        float value{static_cast<float>(i)};
+        record_builder.addIMUFrame(RecordIMUFrame{i * 5000,
+                                                  glm::vec3{value, value + 0.25f, value + 0.5f},
+                                                  glm::vec3{-value, 1.0f, 2.0f},
+                                                  glm::vec3{value * 2.0f, 3.0f, 4.0f},
+                                                  glm::vec3{0.0f, -1.0f, value}});
+    }
+    return record_builder.buildToBytes();
+}
+
+TEST_CASE("Packed IMU Track")
+{
+    // Keeps the samples before the last video frame, which RecordBuilder would drop.
+    constexpr int IMU_FRAME_COUNT{190};
+    RecordWriterClusterPolicy legacy_policy;
+    legacy_policy.imu_samples_per_block = 0;
+    Bytes legacy_bytes{build_test_imu_record_bytes(IMU_FRAME_COUNT, legacy_policy)};
+    Bytes bytes{build_test_imu_record_bytes(IMU_FRAME_COUNT, {})};
+    // A block for several samples instead of four blocks for each sample.
+    REQUIRE(bytes.size() < legacy_bytes.size());
+
+    RecordParser legacy_parser{legacy_bytes.data(), legacy_bytes.size()};
+    auto legacy_record{legacy_parser.parse(true)};
+    RecordParser parser{bytes.data(), bytes.size()};
+    auto record{parser.parse(true)};
+    REQUIRE(record->tracks().imu_track_number);
+
+    auto& imu_frames{record->imu_frames()};
+    auto& legacy_imu_frames{legacy_record->imu_frames()};
+    REQUIRE(imu_frames.size() == gsl::narrow<size_t>(IMU_FRAME_COUNT));
+    REQUIRE(imu_frames.size() == legacy_imu_frames.size());
+    for (size_t i{0}; i < imu_frames.size(); ++i) {
+        REQUIRE(imu_frames[i].time_point_us() == legacy_imu_frames[i].time_point_us());
+        REQUIRE(imu_frames[i].acceleration() == legacy_imu_frames[i].acceleration());
+        REQUIRE(imu_frames[i].rotation_rate() == legacy_imu_frames[i].rotation_rate());
+        REQUIRE(imu_frames[i].magnetic_field() == legacy_imu_frames[i].magnetic_field());
+        REQUIRE(imu_frames[i].gravity() == legacy_imu_frames[i].gravity());
+    }
+
+    auto imu_samples{parser.parseIMUSamples()};
+    auto legacy_imu_samples{legacy_parser.parseIMUSamples()};
+    REQUIRE(imu_samples.size() == imu_frames.size());
+    REQUIRE(imu_samples.time_points_us == legacy_imu_samples.time_points_us);
+    REQUIRE(imu_samples.acceleration.x == legacy_imu_samples.acceleration.x);
+    REQUIRE(imu_samples.rotation_rate.x == legacy_imu_samples.rotation_rate.x);
+    REQUIRE(imu_samples.magnetic_field.x == legacy_imu_samples.magnetic_field.x);
+    REQUIRE(imu_samples.gravity.z == legacy_imu_samples.gravity.z);
+    for (size_t i{0}; i < imu_samples.size(); ++i) {
+        auto imu_frame{imu_samples.getFrame(i)};
+        REQUIRE(imu_frame.time_point_us() == imu_frames[i].time_point_us());
+        REQUIRE(imu_frame.acceleration() == imu_frames[i].acceleration());
+        REQUIRE(imu_frame.gravity() == imu_frames[i].gravity());
+    }
+
+    // Samples come out in between video frames by their time points,
+    // although their blocks get written at the end of clusters.
+    RecordFrameReader reader{bytes.data(), bytes.size()};
+    int64_t last_time_point_us{0};
+    size_t imu_frame_count{0};
+    while (auto frame{reader.next()}) {
+        int64_t time_point_us{0};
+        if (frame->getType() == RecordFrameType::Video) {
+            time_point_us = dynamic_cast<RecordVideoFrame*>(frame.get())->time_point_us();
+        } else if (frame->getType() == RecordFrameType::IMU) {
+            time_point_us = dynamic_cast<RecordIMUFrame*>(frame.get())->time_point_us();
+            ++imu_frame_count;
+        } else {
+            continue;
+        }
+        REQUIRE(time_point_us >= last_time_point_us);
+        last_time_point_us = time_point_us;
+    }
+    REQUIRE(imu_frame_count == imu_frames.size());
+}
+
+// Leaves only the sample count in the IMU block whose count is at count_offset, setting the count
+// to 0 and turning the samples into an EBML Void element so that other offsets stay the same.
+Bytes empty_imu_block(const Bytes& bytes, int count_offset, uint32_t sample_count)
+{
+    constexpr size_t IMU_SAMPLE_SIZE{sizeof(int32_t) + 12 * sizeof(float)};
+    const size_t samples_size{sample_count * IMU_SAMPLE_SIZE};
+    // A SimpleBlock (ID 0xA3) has its size, then a track number, a timecode, and flags in four
+    // bytes before its data.
+    const int block_header_offset{count_offset - 4};
+    for (int size_length{1}; size_length <= 8; ++size_length) {
+        const int size_offset{block_header_offset - size_length};
+        const uint8_t size_marker{gsl::narrow<uint8_t>(0x80 >> (size_length - 1))};
+        if (bytes[size_offset - 1] != 0xA3 ||
+            (bytes[size_offset] & ~(size_marker - 1)) != size_marker) {
+            continue;
+        }
+        uint64_t block_size{bytes[size_offset] & (size_marker - 1u)};
+        for (int i{1}; i < size_length; ++i)
+            block_size = (block_size << 8) | bytes[size_offset + i];
+        if (block_size != 4 + sizeof(uint32_t) + samples_size)
+            continue;
+
+        Bytes empty_bytes{bytes};
+        const uint64_t empty_block_size{4 + sizeof(uint32_t)};
+        for (int i{0}; i < size_length; ++i) {
+            empty_bytes[size_offset + i] =
+                gsl::narrow_cast<uint8_t>(empty_block_size >> (8 * (size_length - 1 - i)));
+        }
+        empty_bytes[size_offset] |= size_marker;
+        int cursor{count_offset};
+        write_to_bytes(empty_bytes, cursor, uint32_t{0});
+        // An EBML Void element (ID 0xEC) with an 8-byte size.
+        const uint64_t void_size{samples_size - 9};
+        empty_bytes[cursor] = 0xEC;
+        empty_bytes[cursor + 1] = 0x01;
+        for (int i{0}; i < 7; ++i)
+            empty_bytes[cursor + 2 + i] = gsl::narrow_cast<uint8_t>(void_size >> (8 * (6 - i)));
+        return empty_bytes;
+    }
+    throw std::runtime_error{"No IMU block found at count_offset"};
+}
+
+TEST_CASE("Packed IMU Track with Invalid Blocks")
+{
+    constexpr int IMU_FRAME_COUNT{190};
+    Bytes bytes{build_test_imu_record_bytes(IMU_FRAME_COUNT, {})};
+
+    // A block starts with its sample count, followed by the time offsets of its samples,
+    // which are 5000 us apart at 200 Hz.
+    Bytes offsets(sizeof(int32_t) * 2);
+    int cursor{0};
+    write_to_bytes(offsets, cursor, int32_t{0});
+    write_to_bytes(offsets, cursor, int32_t{5000});
+    auto offsets_it{std::search(bytes.begin(), bytes.end(), offsets.begin(), offsets.end())};
+    REQUIRE(offsets_it != bytes.end());
+    const int count_offset{gsl::narrow<int>(offsets_it - bytes.begin() - sizeof(uint32_t))};
+    int count_cursor{count_offset};
+    const uint32_t sample_count{read_from_bytes<uint32_t>(bytes, count_cursor)};
+    REQUIRE(sample_count >= 2);
+
+    // Counts claiming more samples than the block holds (as if truncated) or fewer.
+    for (uint32_t invalid_sample_count : {sample_count + 1, sample_count - 1, 0xFFFFFFFFu}) {
+        Bytes invalid_bytes{bytes};
+        int invalid_cursor{count_offset};
+        write_to_bytes(invalid_bytes, invalid_cursor, invalid_sample_count);
+        RecordParser parser{invalid_bytes.data(), invalid_bytes.size()};
+        REQUIRE_THROWS(parser.parseIMUSamples());
+        RecordParser frame_parser{invalid_bytes.data(), invalid_bytes.size()};
+        REQUIRE_THROWS(frame_parser.parse(true));
+    }
+
+    // A block without samples is valid, only holding its count.
+    Bytes empty_block_bytes{empty_imu_block(bytes, count_offset, sample_count)};
+    RecordParser parser{empty_block_bytes.data(), empty_block_bytes.size()};
+    REQUIRE(parser.parseIMUSamples().size() == IMU_FRAME_COUNT - sample_count);
+    RecordParser frame_parser{empty_block_bytes.data(), empty_block_bytes.size()};
+    REQUIRE(frame_parser.parse(true)->imu_frames().size() == IMU_FRAME_COUNT - sample_count);
+}
+
+TEST_CASE("RecordBuilder Streaming")
+{
+    constexpr int VIDEO_FRAME_COUNT{30};
+    Bytes expected_bytes{build_test_record_bytes(VIDEO_FRAME_COUNT)};
+    RecordParser expected_parser{expected_bytes.data(), expected_bytes.size()};
+    auto expected_record{expected_parser.parse(true)};
+
+    MemIOCallback io_callback;
+    RecordBuilder record_builder;
+    record_builder.setDepthCodecType(DepthCodecType::RVL);
+    record_builder.setCalibration(create_test_calibration());
+    int64_t frame_interval_us{ONE_SECOND_NS / ONE_MICROSECOND_NS / VIDEO_FRAME_RATE};
+    record_builder.startStreaming(io_callback, frame_interval_us * 3);
+    // Pose frames arrive two video frames late.
+    for (int i{0}; i < VIDEO_FRAME_COUNT + 2; ++i) {
+        if (i < VIDEO_FRAME_COUNT) {
+            int64_t time_point_us{i * frame_interval_us};
+            record_builder.addVideoFrame(RecordVideoFrame{time_point_us,
+                                                          i % 10 == 0,
+                                                          Bytes(16, gsl::narrow<uint8_t>(i)),
+                                                          Bytes(16, gsl::narrow<uint8_t>(i))});
+        }
+        if (i >= 2) {
+            int64_t time_point_us{(i - 2) * frame_interval_us};
+            record_builder.addPoseFrame(RecordPoseFrame{
+                time_point_us, glm::vec3{0.0f}, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}});
+        }
+    }
+    // Later than the reordering window.
+    record_builder.addPoseFrame(
+        RecordPoseFrame{0, glm::vec3{0.0f}, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}});
+    record_builder.finishStreaming();
+
+    auto data{io_callback.GetDataBuffer()};
+    Bytes bytes(data, data + io_callback.GetDataBufferSize());
+    RecordParser parser{bytes.data(), bytes.size()};
+    auto record{parser.parse(true)};
+
+    auto& video_frames{record->video_frames()};
+    auto& expected_video_frames{expected_record->video_frames()};
+    REQUIRE(video_frames.size() == expected_video_frames.size());
+    for (size_t i{0}; i < video_frames.size(); ++i) {
+        REQUIRE(video_frames[i].time_point_us() == expected_video_frames[i].time_point_us());
+        REQUIRE(video_frames[i].keyframe() == expected_video_frames[i].keyframe());
+        REQUIRE(video_frames[i].color_bytes()[0] == expected_video_frames[i].color_bytes()[0]);
+    }
+    auto& pose_frames{record->pose_frames()};
+    auto& expected_pose_frames{expected_record->pose_frames()};
+    REQUIRE(pose_frames.size() == expected_pose_frames.size());
+    for (size_t i{0}; i < pose_frames.size(); ++i)
+        REQUIRE(pose_frames[i].time_point_us() == expected_pose_frames[i].time_point_us());
+}
+
+TEST_CASE("RecordBuilder Streaming to Path without Calibration")
+{
+    auto file_path{
+        (std::filesystem::temp_directory_path() / "rgbd_tests_streaming.mkv").string()};
+    {
+        std::ofstream file{file_path, std::ios::binary};
+        file << "existing";
+    }
+
+    // A failed start should leave the existing file as it was.
+    RecordBuilder record_builder;
+    REQUIRE_THROWS(record_builder.startStreamingToPath(file_path, 0));
+    REQUIRE(std::filesystem::file_size(file_path) == 8);
+
+    std::filesystem::remove(file_path);
+}
+
+// MemIOCallback whose writes wait while it is closed, like a stalled disk.
+class GatedMemIOCallback : public MemIOCallback
+{
+public:
+    using MemIOCallback::write;
+    size_t write(const void* buffer, size_t size) override
+    {
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            condition_variable_.wait(lock, [this] { return open_; });
+        }
+        return MemIOCallback::write(buffer, size);
+    }
+    void setOpen(bool open)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+            open_ = open;
+        }
+        condition_variable_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_variable_;
+    bool open_{true};
+};
+
+Bytes write_test_record_bytes_async(int video_frame_count,
+                                    AsyncRecordWriterOverflowPolicy overflow_policy,
+                                    AsyncRecordWriterStats& stats)
+{
+    MemIOCallback io_callback;
+    {
+        AsyncRecordWriter writer{io_callback,
+                                 AUDIO_SAMPLE_RATE,
+                                 DepthCodecType::RVL,
+                                 DEFAULT_DEPTH_UNIT,
+                                 create_test_calibration(),
+                                 std::nullopt,
+                                 4,
+                                 overflow_policy};
+        for (int i{0}; i < video_frame_count; ++i) {
+            int64_t time_point_us{i * ONE_SECOND_NS / ONE_MICROSECOND_NS / VIDEO_FRAME_RATE};
+            writer.writePoseFrame(RecordPoseFrame{
+                time_point_us, glm::vec3{0.0f}, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}});
+            // Payloads made from rvalue Bytes move the bytes instead of copying them.
+            RecordPayload color_payload{Bytes(16, gsl::narrow<uint8_t>(i))};
+            RecordPayload depth_payload{Bytes(16, gsl::narrow<uint8_t>(i))};
+            writer.writeVideoFrame(
+                RecordVideoFrame{time_point_us, i % 10 == 0, color_payload, depth_payload});
+        }
+        writer.flush();
+        stats = writer.getStats();
+    }
+    auto data{io_callback.GetDataBuffer()};
+    return Bytes(data, data + io_callback.GetDataBufferSize());
+}
+
+TEST_CASE("AsyncRecordWriter")
+{
+    SECTION("Block keeps every frame")
+    {
+        AsyncRecordWriterStats stats;
+        Bytes bytes{
+            write_test_record_bytes_async(30, AsyncRecordWriterOverflowPolicy::Block, stats)};
+        REQUIRE(stats.written_frame_count == 60);
+        REQUIRE(stats.dropped_frame_count == 0);
+        REQUIRE(stats.queue_size == 0);
+        REQUIRE(stats.peak_queue_size <= 4);
+
+        RecordParser parser{bytes.data(), bytes.size()};
+        auto record{parser.parse(true)};
+        auto& video_frames{record->video_frames()};
+        REQUIRE(video_frames.size() == 30);
+        for (size_t i{0}; i < video_frames.size(); ++i) {
+            REQUIRE(video_frames[i].keyframe() == (i % 10 == 0));
+            REQUIRE(video_frames[i].color_bytes()[0] == gsl::narrow<uint8_t>(i));
+        }
+        REQUIRE(record->pose_frames().size() == 30);
+    }
+    SECTION("DropOldest keeps decodable video frames")
+    {
+        // Stalls the writer thread at its first write, so the queue overflows.
+        GatedMemIOCallback io_callback;
+        AsyncRecordWriterStats stats;
+        {
+            AsyncRecordWriter writer{io_callback,
+                                     AUDIO_SAMPLE_RATE,
+                                     DepthCodecType::RVL,
+                                     DEFAULT_DEPTH_UNIT,
+                                     create_test_calibration(),
+                                     std::nullopt,
+                                     4,
+                                     AsyncRecordWriterOverflowPolicy::DropOldest};
+            auto write_frames{[&writer](int video_frame_index) {
+                int64_t time_point_us{video_frame_index * ONE_SECOND_NS / ONE_MICROSECOND_NS /
+                                      VIDEO_FRAME_RATE};
+                writer.writePoseFrame(RecordPoseFrame{
+                    time_point_us, glm::vec3{0.0f}, glm::quat{1.0f, 0.0f, 0.0f, 0.0f}});
+                writer.writeVideoFrame(
+                    RecordVideoFrame{time_point_us,
+                                     video_frame_index % 10 == 0,
+                                     Bytes(16, gsl::narrow<uint8_t>(video_frame_index)),
+                                     Bytes(16, gsl::narrow<uint8_t>(video_frame_index))});
+            }};
+
+            io_callback.setOpen(false);
+            for (int i{0}; i < 15; ++i)
+                write_frames(i);
+
+            // Lets the writer catch up before each frame, so no more frames get dropped.
+            io_callback.setOpen(true);
+            for (int i{15}; i < 30; ++i) {
+                while (writer.getStats().queue_size > 0)
+                    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                write_frames(i);
+            }
+            writer.flush();
+            stats = writer.getStats();
+        }
+        REQUIRE(stats.dropped_frame_count > 0);
+        REQUIRE(stats.written_frame_count + stats.dropped_frame_count == 60);
+        REQUIRE(stats.peak_queue_size <= 4);
+
+        auto data{io_callback.GetDataBuffer()};
+        Bytes bytes(data, data + io_callback.GetDataBufferSize());
+        RecordParser parser{bytes.data(), bytes.size()};
+        auto record{parser.parse(true)};
+        auto& video_frames{record->video_frames()};
+        REQUIRE(video_frames.size() < 30);
+        // Frames 20 to 29 are written after the writer caught up.
+        REQUIRE(video_frames.size() >= 10);
+        REQUIRE(video_frames[video_frames.size() - 10].color_bytes()[0] == 20);
+
+        // The first video frame after dropped ones is a keyframe.
+        REQUIRE(video_frames.front().keyframe());
+        for (size_t i{1}; i < video_frames.size(); ++i) {
+            if (video_frames[i].color_bytes()[0] != video_frames[i - 1].color_bytes()[0] + 1)
+                REQUIRE(video_frames[i].keyframe());
+        }
+    }
+}
+
+TEST_CASE("Buffered and Chunked IOCallbacks")
+{
+    // Writes with a seek back to overwrite, as RecordWriter does for the header.
+    auto write_test_bytes{[](libebml::IOCallback& io_callback) {
+        Bytes bytes(10000);
+        for (size_t i{0}; i < bytes.size(); ++i)
+            bytes[i] = gsl::narrow<uint8_t>(i % 251);
+        for (size_t offset{0}; offset < bytes.size(); offset += 100)
+            io_callback.write(bytes.data() + offset, 100);
+        io_callback.setFilePointer(5000);
+        Bytes overwrite_bytes(3000, 7);
+        io_callback.write(overwrite_bytes.data(), overwrite_bytes.size());
+        io_callback.setFilePointer(0, libebml::seek_end);
+        REQUIRE(io_callback.getFilePointer() == bytes.size());
+        io_callback.write(bytes.data(), bytes.size());
+
+        Bytes expected_bytes{bytes};
+        memcpy(expected_bytes.data() + 5000, overwrite_bytes.data(), overwrite_bytes.size());
+        expected_bytes.insert(expected_bytes.end(), bytes.begin(), bytes.end());
+        return expected_bytes;
+    }};
+
+    SECTION("ChunkedMemIOCallback")
+    {
+        ChunkedMemIOCallback io_callback{1024};
+        auto expected_bytes{write_test_bytes(io_callback)};
+        REQUIRE(io_callback.toBytes() == expected_bytes);
+    }
+    SECTION("BufferedFileIOCallback")
+    {
+        auto file_path{
+            (std::filesystem::temp_directory_path() / "rgbd_tests_buffered.bin").string()};
+        Bytes expected_bytes;
+        {
+            BufferedFileIOCallback io_callback{file_path, 8192};
+            expected_bytes = write_test_bytes(io_callback);
+            io_callback.close();
+            // 200 writes of 100 bytes become a few writes of the buffer.
+            REQUIRE(io_callback.file_write_count() < 10);
+        }
+        std::ifstream file{file_path, std::ios::binary};
+        Bytes bytes{std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+        REQUIRE(bytes == expected_bytes);
+        file.close();
+        std::filesystem::remove(file_path);
+    }
+}
+
+TEST_CASE("RecordParser with Memory Map")
+{
+    Bytes bytes{build_test_record_bytes(30)};
+    auto file_path{(std::filesystem::temp_directory_path() / "rgbd_tests_mmap.mkv").string()};
+    {
+        std::ofstream file{file_path, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    RecordParser memory_parser{bytes.data(), bytes.size()};
+    auto memory_record{memory_parser.parse(true)};
+
+    unique_ptr<Record> record;
+    unique_ptr<RecordFrame> seeked_frame;
+    {
+        RecordParser parser{file_path, RecordFileAccess::MemoryMap};
+        record = parser.parse(true);
+        parser.seekToTimePoint(memory_record->video_frames()[15].time_point_us());
+        seeked_frame = parser.parseNextFrame();
+        while (seeked_frame && seeked_frame->getType() != RecordFrameType::Video)
+            seeked_frame = parser.parseNextFrame();
+    }
+    // Frames keep the mapping alive after the parser is gone.
+    REQUIRE(record->video_frames().size() == memory_record->video_frames().size());
+    REQUIRE(record->pose_frames().size() == memory_record->pose_frames().size());
+    for (size_t i{0}; i < record->video_frames().size(); ++i) {
+        auto depth_bytes{record->video_frames()[i].depth_bytes()};
+        auto memory_depth_bytes{memory_record->video_frames()[i].depth_bytes()};
+        REQUIRE(std::equal(depth_bytes.begin(),
+                           depth_bytes.end(),
+                           memory_depth_bytes.begin(),
+                           memory_depth_bytes.end()));
+    }
+    REQUIRE(seeked_frame);
+    auto seeked_video_frame{dynamic_cast<RecordVideoFrame*>(seeked_frame.get())};
+    auto& expected_video_frame{memory_record->video_frames()[10]};
+    REQUIRE(seeked_video_frame->time_point_us() == expected_video_frame.time_point_us());
+    REQUIRE(seeked_video_frame->color_bytes()[0] == expected_video_frame.color_bytes()[0]);
+
+    record.reset();
+    seeked_frame.reset();
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("C API with Memory Map")
+{
+    constexpr size_t VIDEO_FRAME_COUNT{30};
+    Bytes bytes{build_test_record_bytes(gsl::narrow<int>(VIDEO_FRAME_COUNT))};
+    auto file_path{(std::filesystem::temp_directory_path() / "rgbd_tests_capi_mmap.mkv").string()};
+    {
+        std::ofstream file{file_path, std::ios::binary};
+        file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    void* parser{rgbd_record_parser_ctor_from_mmap(file_path.c_str())};
+    REQUIRE(parser);
+    void* record{rgbd_record_parser_parse(parser, true)};
+    REQUIRE(record);
+    REQUIRE(rgbd_record_get_video_frame_count(record) == VIDEO_FRAME_COUNT);
+    void* video_frame{rgbd_record_get_video_frame(record, VIDEO_FRAME_COUNT - 1)};
+    int64_t last_time_point_us{gsl::narrow<int64_t>(VIDEO_FRAME_COUNT - 1) * ONE_SECOND_NS /
+                               ONE_MICROSECOND_NS / VIDEO_FRAME_RATE};
+    REQUIRE(rgbd_record_video_frame_get_time_point_us(video_frame) == last_time_point_us);
+    rgbd_record_dtor(record);
+    rgbd_record_parser_dtor(parser);
+
+    void* reader{rgbd_record_frame_reader_ctor_from_mmap(file_path.c_str())};
+    REQUIRE(reader);
+    size_t video_frame_count{0};
+    while (void* frame{rgbd_record_frame_reader_next(reader)}) {
+        if (rgbd_record_frame_get_type(frame) == RGBD_RECORD_FRAME_TYPE_VIDEO)
+            ++video_frame_count;
+        rgbd_record_frame_dtor(frame);
+    }
+    REQUIRE(video_frame_count == VIDEO_FRAME_COUNT);
+    rgbd_record_frame_reader_dtor(reader);
+
+    std::filesystem::remove(file_path);
+}
+
+TEST_CASE("ParallelVideoDecoder matches Sequential Decoding")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT};
+    DepthEncoder depth_encoder{DepthCodecType::TDC1, WIDTH, HEIGHT};
+    std::uniform_int_distribution<int> distr(0, 255);
+    vector<RecordVideoFrame> video_frames;
+    for (int i{0}; i < 40; ++i) {
+        auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, gsl::narrow<uint8_t>(distr(eng)))};
+        vector<int32_t> depth_values(WIDTH * HEIGHT);
+        for (auto& depth_value : depth_values)
+            depth_value = distr(eng) * 8;
+
+        bool keyframe{i % 10 == 0};
+        video_frames.push_back(
+            RecordVideoFrame{i * 33333LL,
+                             keyframe,
+                             color_encoder.encode(yuv_frame, keyframe),
+                             depth_encoder.encode(depth_values.data(), keyframe)});
+    }
+
+    ColorDecoder color_decoder{ColorCodecType::VP8};
+    DepthDecoder depth_decoder{DepthCodecType::TDC1};
+    ParallelVideoDecoder parallel_decoder{
+        ColorCodecType::VP8, DepthCodecType::TDC1, video_frames, 3, 2};
+    for (auto& video_frame : video_frames) {
+        auto yuv_frame{color_decoder.decode(video_frame.color_bytes())};
+        auto depth_frame{depth_decoder.decode(video_frame.depth_bytes())};
+        auto decoded_frame{parallel_decoder.next()};
+        REQUIRE(decoded_frame);
+        REQUIRE(decoded_frame->time_point_us() == video_frame.time_point_us());
+        REQUIRE(decoded_frame->yuv_frame()->y_channel() == yuv_frame->y_channel());
+        REQUIRE(decoded_frame->depth_frame()->values() == depth_frame->values());
+    }
+    REQUIRE(!parallel_decoder.next());
+}
+
+TEST_CASE("DepthDecoder decodeInto matches decode")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    std::uniform_int_distribution<int> distr(0, 255);
+    for (auto depth_codec_type :
+         {DepthCodecType::RVL, DepthCodecType::TDC1, DepthCodecType::RVL_MT}) {
+        DepthEncoder depth_encoder{depth_codec_type, WIDTH, HEIGHT};
+        DepthDecoder depth_decoder{depth_codec_type};
+        DepthDecoder depth_decoder_into{depth_codec_type};
+        vector<int32_t> output(WIDTH * HEIGHT);
+        vector<int32_t> wrong_size_output(WIDTH);
+        for (int i{0}; i < 20; ++i) {
+            vector<int32_t> depth_values(WIDTH * HEIGHT);
+            for (auto& depth_value : depth_values)
+                depth_value = distr(eng) < 64 ? 0 : distr(eng) * 8;
+
+            auto bytes{depth_encoder.encode(depth_values.data(), i % 10 == 0)};
+            auto depth_frame{depth_decoder.decode(bytes)};
+            // A rejected call should leave the decoder as it was, even for diffs of TDC1.
+            if (i == 5)
+                REQUIRE_THROWS(depth_decoder_into.decodeInto(bytes, wrong_size_output));
+            depth_decoder_into.decodeInto(bytes, output);
+            REQUIRE(output == depth_frame->values());
+        }
+        REQUIRE_THROWS(depth_decoder_into.decodeInto(
+            depth_encoder.encode(output.data(), true), wrong_size_output));
+    }
+}
+
+TEST_CASE("DepthEncoder encodeInto matches encode")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    std::uniform_int_distribution<int> distr(0, 255);
+    for (auto depth_codec_type :
+         {DepthCodecType::RVL, DepthCodecType::TDC1, DepthCodecType::RVL_MT}) {
+        DepthEncoder depth_encoder{depth_codec_type, WIDTH, HEIGHT};
+        DepthEncoder depth_encoder_into{depth_codec_type, WIDTH, HEIGHT};
+        Bytes output;
+        for (int i{0}; i < 20; ++i) {
+            vector<int32_t> depth_values(WIDTH * HEIGHT);
+            for (auto& depth_value : depth_values)
+                depth_value = distr(eng) < 64 ? 0 : distr(eng) * 8;
+
+            bool keyframe{i % 10 == 0};
+            auto bytes{depth_encoder.encode(depth_values.data(), keyframe)};
+            auto size{depth_encoder_into.encodeInto(depth_values.data(), keyframe, output)};
+            REQUIRE(output.size() == depth_encoder_into.getMaxEncodedSize());
+            REQUIRE(Bytes(output.begin(), output.begin() + size) == bytes);
+        }
+        Bytes small_output(depth_encoder_into.getMaxEncodedSize() - 1);
+        REQUIRE_THROWS(depth_encoder_into.encodeInto(
+            vector<int32_t>(WIDTH * HEIGHT).data(), true, span<uint8_t>{small_output}));
+    }
+}
+
+TEST_CASE("Depth Codec Batches")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    constexpr int FRAME_COUNT{12};
+    std::uniform_int_distribution<int> distr(0, 255);
+    for (auto depth_codec_type :
+         {DepthCodecType::RVL, DepthCodecType::TDC1, DepthCodecType::RVL_MT}) {
+        vector<int32_t> depth_values(WIDTH * HEIGHT * FRAME_COUNT);
+        for (auto& depth_value : depth_values)
+            depth_value = distr(eng) < 64 ? 0 : distr(eng) * 8;
+        vector<bool> keyframes(FRAME_COUNT);
+        for (int i{0}; i < FRAME_COUNT; ++i)
+            keyframes[i] = i % 5 == 0;
+
+        DepthEncoder depth_encoder{depth_codec_type, WIDTH, HEIGHT};
+        DepthEncoder depth_encoder_batch{depth_codec_type, WIDTH, HEIGHT};
+        DepthEncoder depth_encoder_batch_into{depth_codec_type, WIDTH, HEIGHT};
+        auto bytes_list{depth_encoder_batch.encodeBatch(depth_values.data(), keyframes)};
+        Bytes output(FRAME_COUNT * depth_encoder_batch_into.getMaxEncodedSize());
+        vector<size_t> encoded_sizes(FRAME_COUNT);
+        depth_encoder_batch_into.encodeBatchInto(
+            depth_values.data(), keyframes, output, encoded_sizes);
+
+        REQUIRE(bytes_list.size() == FRAME_COUNT);
+        vector<span<const uint8_t>> byte_spans;
+        size_t cursor{0};
+        for (int i{0}; i < FRAME_COUNT; ++i) {
+            auto bytes{depth_encoder.encode(&depth_values[i * WIDTH * HEIGHT], keyframes[i])};
+            REQUIRE(bytes_list[i] == bytes);
+            REQUIRE(Bytes(output.begin() + cursor, output.begin() + cursor + encoded_sizes[i]) ==
+                    bytes);
+            cursor += encoded_sizes[i];
+            byte_spans.push_back({bytes_list[i].data(), bytes_list[i].size()});
+        }
+
+        DepthDecoder depth_decoder{depth_codec_type};
+        DepthDecoder depth_decoder_batch{depth_codec_type};
+        vector<int32_t> decoded_values(WIDTH * HEIGHT * FRAME_COUNT);
+        depth_decoder_batch.decodeBatchInto(byte_spans, decoded_values);
+        for (int i{0}; i < FRAME_COUNT; ++i) {
+            auto depth_frame{depth_decoder.decode(byte_spans[i])};
+            REQUIRE(vector<int32_t>(decoded_values.begin() + i * WIDTH * HEIGHT,
+                                    decoded_values.begin() + (i + 1) * WIDTH * HEIGHT) ==
+                    depth_frame->values());
+        }
+    }
+}
+
+TEST_CASE("RVL-MT Bands")
+{
+    constexpr int WIDTH{64};
+    std::uniform_int_distribution<int> distr(0, 255);
+    // Covers one band, more bands than rows, and heights not divisible by the band count.
+    for (auto [height, band_count] :
+         vector<pair<int, int>>{{48, 1}, {3, 8}, {1, 4}, {7, 4}, {33, 4}, {47, 5}}) {
+        vector<int32_t> depth_values(static_cast<size_t>(WIDTH) * height);
+        for (auto& depth_value : depth_values)
+            depth_value = distr(eng) < 64 ? 0 : distr(eng) * 8;
+
+        RVLMTEncoder encoder{WIDTH, height, band_count};
+        Bytes bytes(encoder.getMaxEncodedSize());
+        bytes.resize(encoder.encodeInto(depth_values.data(), true, bytes));
+
+        int cursor{8};
+        REQUIRE(read_from_bytes<int32_t>(bytes, cursor) == std::min(band_count, height));
+        RVLMTDecoder decoder;
+        REQUIRE(decoder.decode(bytes)->values() == depth_values);
+        vector<int32_t> output(depth_values.size());
+        decoder.decodeInto(bytes, output);
+        REQUIRE(output == depth_values);
+    }
+}
+
+TEST_CASE("RVL-MT Invalid Headers")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    constexpr int BAND_COUNT{4};
+    constexpr int HEADER_SIZE{sizeof(int32_t) * (3 + BAND_COUNT)};
+    vector<int32_t> depth_values(WIDTH * HEIGHT, 1000);
+    RVLMTEncoder encoder{WIDTH, HEIGHT, BAND_COUNT};
+    Bytes bytes(encoder.getMaxEncodedSize());
+    bytes.resize(encoder.encodeInto(depth_values.data(), true, bytes));
+
+    RVLMTDecoder decoder;
+    vector<int32_t> output(depth_values.size());
+    auto require_invalid{[&](const Bytes& invalid_bytes) {
+        REQUIRE_THROWS(decoder.decode(invalid_bytes));
+        REQUIRE_THROWS(decoder.decodeInto(invalid_bytes, output));
+    }};
+    auto with_int32{[&](int offset, int32_t value) {
+        Bytes corrupt_bytes{bytes};
+        write_to_bytes(corrupt_bytes, offset, value);
+        return corrupt_bytes;
+    }};
+
+    require_invalid(Bytes(bytes.begin(), bytes.begin() + 8));
+    require_invalid(Bytes(bytes.begin(), bytes.begin() + HEADER_SIZE - 1));
+    require_invalid(Bytes(bytes.begin(), bytes.end() - 1));
+    require_invalid(with_int32(8, 0));
+    require_invalid(with_int32(8, HEIGHT + 1));
+    require_invalid(with_int32(4, -1));
+    require_invalid(with_int32(12, -1));
+    require_invalid(with_int32(12, gsl::narrow<int32_t>(bytes.size())));
+    REQUIRE(decoder.decode(bytes)->values() == depth_values);
+}
+
+TEST_CASE("ColorEncoder encodePlanes matches encode")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    constexpr int PADDING{16};
+    std::uniform_int_distribution<int> distr(0, 255);
+    ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT};
+    ColorEncoder color_encoder_planes{ColorCodecType::VP8, WIDTH, HEIGHT};
+    for (int i{0}; i < 10; ++i) {
+        // Planes with rows padded as in frames from cameras or slices of larger images.
+        const int y_stride{WIDTH + PADDING};
+        const int uv_stride{WIDTH / 2 + PADDING};
+        vector<uint8_t> y_plane(y_stride * HEIGHT);
+        vector<uint8_t> u_plane(uv_stride * HEIGHT / 2);
+        vector<uint8_t> v_plane(uv_stride * HEIGHT / 2);
+        for (auto plane : {&y_plane, &u_plane, &v_plane}) {
+            for (auto& value : *plane)
+                value = gsl::narrow<uint8_t>(distr(eng));
+        }
+
+        vector<uint8_t> y_channel;
+        vector<uint8_t> u_channel;
+        vector<uint8_t> v_channel;
+        for (int row{0}; row < HEIGHT; ++row)
+            y_channel.insert(y_channel.end(),
+                             y_plane.begin() + row * y_stride,
+                             y_plane.begin() + row * y_stride + WIDTH);
+        for (int row{0}; row < HEIGHT / 2; ++row) {
+            u_channel.insert(u_channel.end(),
+                             u_plane.begin() + row * uv_stride,
+                             u_plane.begin() + row * uv_stride + WIDTH / 2);
+            v_channel.insert(v_channel.end(),
+                             v_plane.begin() + row * uv_stride,
+                             v_plane.begin() + row * uv_stride + WIDTH / 2);
+        }
+
+        bool keyframe{i == 0};
+        YuvFrame yuv_frame{WIDTH, HEIGHT, y_channel, u_channel, v_channel};
+        auto bytes{color_encoder.encode(yuv_frame, keyframe)};
+        auto plane_bytes{color_encoder_planes.encodePlanes(y_plane.data(),
+                                                           y_stride,
+                                                           u_plane.data(),
+                                                           uv_stride,
+                                                           v_plane.data(),
+                                                           uv_stride,
+                                                           keyframe)};
+        REQUIRE(bytes == plane_bytes);
+    }
+
+    vector<uint8_t> y_plane(WIDTH * HEIGHT);
+    vector<uint8_t> uv_plane(WIDTH * HEIGHT / 4);
+    REQUIRE_THROWS(color_encoder_planes.encodePlanes(
+        y_plane.data(), WIDTH - 1, uv_plane.data(), WIDTH / 2, uv_plane.data(), WIDTH / 2, false));
+    REQUIRE_THROWS(color_encoder_planes.encodePlanes(
+        y_plane.data(), WIDTH, uv_plane.data(), WIDTH / 2, uv_plane.data(), WIDTH / 2 - 1, false));
+}
+
+TEST_CASE("ColorDecoder with YuvFramePool")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    std::uniform_int_distribution<int> distr(0, 255);
+    ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT};
+    ColorDecoder color_decoder{ColorCodecType::VP8};
+    ColorDecoder pool_color_decoder{ColorCodecType::VP8};
+    YuvFramePool pool{1};
+    const YuvFrame* previous_yuv_frame{nullptr};
+    for (int i{0}; i < 10; ++i) {
+        auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, gsl::narrow<uint8_t>(distr(eng)))};
+        auto bytes{color_encoder.encode(yuv_frame, i == 0)};
+
+        auto decoded_yuv_frame{color_decoder.decode(bytes)};
+        auto pool_yuv_frame{pool_color_decoder.decode(bytes, pool)};
+        REQUIRE(pool_yuv_frame->width() == WIDTH);
+        REQUIRE(pool_yuv_frame->height() == HEIGHT);
+        REQUIRE(pool_yuv_frame->y_channel() == decoded_yuv_frame->y_channel());
+        REQUIRE(pool_yuv_frame->u_channel() == decoded_yuv_frame->u_channel());
+        REQUIRE(pool_yuv_frame->v_channel() == decoded_yuv_frame->v_channel());
+        // Released frames get recycled.
+        if (previous_yuv_frame)
+            REQUIRE(pool_yuv_frame.get() == previous_yuv_frame);
+        previous_yuv_frame = pool_yuv_frame.get();
+        pool.release(std::move(pool_yuv_frame));
+        REQUIRE(pool.size() == 1);
+    }
+}
+
+TEST_CASE("Color Codec Options")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    std::uniform_int_distribution<int> distr(0, 255);
+    ColorEncoderOptions encoder_options;
+    encoder_options.thread_count = 1;
+    encoder_options.cpu_used = 8;
+    encoder_options.target_bitrate_kbps = 100;
+    ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT, encoder_options};
+    ColorDecoder color_decoder{ColorCodecType::VP8};
+    ColorDecoderOptions decoder_options;
+    decoder_options.thread_count = 2;
+    ColorDecoder threaded_color_decoder{ColorCodecType::VP8, decoder_options};
+    for (int i{0}; i < 10; ++i) {
+        auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, gsl::narrow<uint8_t>(distr(eng)))};
+        auto bytes{color_encoder.encode(yuv_frame, i == 0)};
+        auto decoded_yuv_frame{color_decoder.decode(bytes)};
+        auto threaded_yuv_frame{threaded_color_decoder.decode(bytes)};
+        REQUIRE(threaded_yuv_frame->y_channel() == decoded_yuv_frame->y_channel());
+    }
+}
+
+TEST_CASE("ColorEncoder Keyframe Interval")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    constexpr int KEYFRAME_INTERVAL{5};
+    for (int keyframe_interval : {0, KEYFRAME_INTERVAL}) {
+        ColorEncoderOptions encoder_options;
+        encoder_options.thread_count = 1;
+        encoder_options.keyframe_interval = keyframe_interval;
+        ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT, encoder_options};
+        int keyframe_count{0};
+        for (int i{0}; i < KEYFRAME_INTERVAL * 3; ++i) {
+            // Slowly changing frames, so libvpx has no scene cut to place keyframes at.
+            auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, gsl::narrow<uint8_t>(100 + i))};
+            auto bytes{color_encoder.encode(yuv_frame, i == 0)};
+            // The lowest bit of the first byte of a VP8 frame is 0 for keyframes.
+            REQUIRE(color_encoder.last_keyframe() == ((bytes[0] & 1) == 0));
+            if (color_encoder.last_keyframe())
+                ++keyframe_count;
+        }
+        // Only the requested keyframe without keyframe_interval,
+        // and also ones libvpx placed on its own with it.
+        if (keyframe_interval == 0)
+            REQUIRE(keyframe_count == 1);
+        else
+            REQUIRE(keyframe_count > 1);
+    }
+}
+
+TEST_CASE("Color Rate Control Modes")
+{
+    constexpr int WIDTH{64};
+    constexpr int HEIGHT{48};
+    SECTION("Irregular Time Points")
+    {
+        for (auto mode :
+             {ColorRateControlMode::CBR, ColorRateControlMode::VBR, ColorRateControlMode::CQ}) {
+            ColorEncoderOptions encoder_options;
+            encoder_options.rate_control_mode = mode;
+            encoder_options.thread_count = 1;
+            encoder_options.cpu_used = 8;
+            ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT, encoder_options};
+            ColorDecoder color_decoder{ColorCodecType::VP8};
+            for (int i{0}; i < 10; ++i) {
+                auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, gsl::narrow<uint8_t>(i * 20))};
+                // Irregular timestamps, as from a variable frame rate capture.
+                auto bytes{color_encoder.encode(yuv_frame, i == 0, i * 40000 + (i % 3) * 5000)};
+                REQUIRE(!bytes.empty());
+                auto decoded_yuv_frame{color_decoder.decode(bytes)};
+                REQUIRE(decoded_yuv_frame->width() == WIDTH);
+                REQUIRE(decoded_yuv_frame->height() == HEIGHT);
+            }
+        }
+    }
+
+    SECTION("Bitrate Follows Target")
+    {
+        // Noise does not compress, so the size of the frames is up to the rate control.
+        std::uniform_int_distribution<int> distr(0, 255);
+        vector<YuvFrame> yuv_frames;
+        for (int i{0}; i < 30; ++i) {
+            vector<uint8_t> y_channel(WIDTH * HEIGHT);
+            vector<uint8_t> u_channel(WIDTH * HEIGHT / 4);
+            vector<uint8_t> v_channel(WIDTH * HEIGHT / 4);
+            for (auto& y : y_channel)
+                y = gsl::narrow<uint8_t>(distr(eng));
+            for (auto& u : u_channel)
+                u = gsl::narrow<uint8_t>(distr(eng));
+            for (auto& v : v_channel)
+                v = gsl::narrow<uint8_t>(distr(eng));
+            yuv_frames.emplace_back(WIDTH, HEIGHT, y_channel, u_channel, v_channel);
+        }
+
+        auto encode_size{[&](ColorRateControlMode mode, int target_bitrate_kbps) {
+            ColorEncoderOptions encoder_options;
+            encoder_options.rate_control_mode = mode;
+            encoder_options.target_bitrate_kbps = target_bitrate_kbps;
+            encoder_options.thread_count = 1;
+            encoder_options.cpu_used = 8;
+            ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT, encoder_options};
+            size_t size{0};
+            for (size_t i{0}; i < yuv_frames.size(); ++i)
+                size += color_encoder.encode(yuv_frames[i], i == 0).size();
+            return size;
+        }};
+
+        for (auto mode : {ColorRateControlMode::CBR, ColorRateControlMode::VBR})
+            REQUIRE(encode_size(mode, 50) < encode_size(mode, 2000));
+    }
+
+    SECTION("Non-increasing Time Points")
+    {
+        ColorEncoder color_encoder{ColorCodecType::VP8, WIDTH, HEIGHT};
+        auto yuv_frame{create_gray_yuv_frame(WIDTH, HEIGHT, 0)};
+        REQUIRE(!color_encoder.encode(yuv_frame, true, 100000).empty());
+        REQUIRE_THROWS(color_encoder.encode(yuv_frame, false, 100000));
+        REQUIRE_THROWS(color_encoder.encode(yuv_frame, false, 50000));
+        REQUIRE(!color_encoder.encode(yuv_frame, false, 150000).empty());
+    }
+}
+
+TEST_CASE("PointCloudBuilder")
+{
+    constexpr int COLOR_WIDTH{64};
+    constexpr int COLOR_HEIGHT{48};
+    constexpr int DEPTH_WIDTH{32};
+    constexpr int DEPTH_HEIGHT{24};
+    constexpr float DEPTH_UNIT{0.001f};
+    UndistortedCameraCalibration calibration{
+        COLOR_WIDTH, COLOR_HEIGHT, DEPTH_WIDTH, DEPTH_HEIGHT, 0.5f, 0.5f, 0.5f, 0.5f};
+    DirectionTable direction_table{calibration};
+    std::uniform_int_distribution<int> distr(0, 4000);
+    vector<int32_t> depth_values(DEPTH_WIDTH * DEPTH_HEIGHT);
+    for (auto& depth_value : depth_values)
+        depth_value = distr(eng);
+    Int32Frame depth_frame{DEPTH_WIDTH, DEPTH_HEIGHT, depth_values};
+
+    PointCloudBuilder point_cloud_builder{direction_table, DEPTH_UNIT, 1};
+    PointCloudBuilder threaded_point_cloud_builder{
+        direction_table, DEPTH_UNIT, COLOR_WIDTH, COLOR_HEIGHT, 3};
+    const size_t point_count{point_cloud_builder.point_count()};
+    REQUIRE(point_count == DEPTH_WIDTH * DEPTH_HEIGHT);
+
+    vector<float> positions(point_count * 3);
+    vector<float> threaded_positions(point_count * 3);
+    point_cloud_builder.buildPositions(depth_frame, positions);
+    threaded_point_cloud_builder.buildPositions(depth_frame, threaded_positions);
+    REQUIRE(positions == threaded_positions);
+    for (size_t i{0}; i < point_count; ++i) {
+        glm::vec3 position{direction_table.directions()[i] * DEPTH_UNIT *
+                           static_cast<float>(depth_values[i])};
+        REQUIRE(positions[i] == Catch::Approx(position.x).margin(1e-5f));
+        REQUIRE(positions[i + point_count] == Catch::Approx(position.y).margin(1e-5f));
+        REQUIRE(positions[i + point_count * 2] == Catch::Approx(position.z).margin(1e-5f));
+    }
+
+    // Planes coding the position of each pixel, so a wrong sample or channel shows up.
+    vector<uint8_t> y_channel(COLOR_WIDTH * COLOR_HEIGHT);
+    vector<uint8_t> u_channel(COLOR_WIDTH * COLOR_HEIGHT / 4);
+    vector<uint8_t> v_channel(COLOR_WIDTH * COLOR_HEIGHT / 4);
+    for (int row{0}; row < COLOR_HEIGHT; ++row) {
+        for (int col{0}; col < COLOR_WIDTH; ++col)
+            y_channel[col + row * COLOR_WIDTH] = gsl::narrow<uint8_t>(100 + col + row);
+    }
+    for (int row{0}; row < COLOR_HEIGHT / 2; ++row) {
+        for (int col{0}; col < COLOR_WIDTH / 2; ++col) {
+            u_channel[col + row * COLOR_WIDTH / 2] = gsl::narrow<uint8_t>(112 + col);
+            v_channel[col + row * COLOR_WIDTH / 2] = gsl::narrow<uint8_t>(116 + row);
+        }
+    }
+    YuvFrame yuv_frame{COLOR_WIDTH, COLOR_HEIGHT, y_channel, u_channel, v_channel};
+    vector<uint8_t> colors(point_count * 3);
+    threaded_point_cloud_builder.buildColors(yuv_frame, colors);
+
+    // Same conversion as YuvFrame::getPNGBytes().
+    auto get_rgb{[&](int color_col, int color_row) {
+        const int y{y_channel[color_col + color_row * COLOR_WIDTH]};
+        const int u{u_channel[color_col / 2 + (color_row / 2) * COLOR_WIDTH / 2] - 128};
+        const int v{v_channel[color_col / 2 + (color_row / 2) * COLOR_WIDTH / 2] - 128};
+        return std::array<int, 3>{std::clamp(y + ((351 * v) >> 8), 0, 255),
+                                  std::clamp(y - ((179 * v + 86 * u) >> 8), 0, 255),
+                                  std::clamp(y + ((443 * u) >> 8), 0, 255)};
+    }};
+    auto get_color{[](const vector<uint8_t>& colors, size_t count, size_t i) {
+        return std::array<int, 3>{colors[i], colors[i + count], colors[i + count * 2]};
+    }};
+
+    // Depth pixel (col, row) samples color pixel (color_col, color_row).
+    for (auto [col, row, color_col, color_row] : vector<std::array<int, 4>>{
+             {0, 0, 0, 0}, {31, 23, 63, 47}, {10, 5, 20, 10}, {1, 22, 2, 45}}) {
+        const size_t i{static_cast<size_t>(col + row * DEPTH_WIDTH)};
+        REQUIRE(get_color(colors, point_count, i) == get_rgb(color_col, color_row));
+    }
+    REQUIRE_THROWS(point_cloud_builder.buildColors(yuv_frame, colors));
+
+    // A single row of depth samples the first row of color instead of dividing by zero.
+    UndistortedCameraCalibration row_calibration{
+        COLOR_WIDTH, COLOR_HEIGHT, DEPTH_WIDTH, 1, 0.5f, 0.5f, 0.5f, 0.5f};
+    PointCloudBuilder row_point_cloud_builder{
+        DirectionTable{row_calibration}, DEPTH_UNIT, COLOR_WIDTH, COLOR_HEIGHT, 2};
+    vector<uint8_t> row_colors(DEPTH_WIDTH * 3);
+    row_point_cloud_builder.buildColors(yuv_frame, row_colors);
+    REQUIRE(get_color(row_colors, DEPTH_WIDTH, 0) == get_rgb(0, 0));
+    REQUIRE(get_color(row_colors, DEPTH_WIDTH, DEPTH_WIDTH - 1) == get_rgb(COLOR_WIDTH - 1, 0));
+}
+
+TEST_CASE("FrameMapper")
+{
+    constexpr int SRC_WIDTH{64};
+    constexpr int SRC_HEIGHT{48};
+    constexpr int DST_WIDTH{32};
+    constexpr int DST_HEIGHT{32};
+    UndistortedCameraCalibration src_calibration{
+        SRC_WIDTH, SRC_HEIGHT, SRC_WIDTH / 2, SRC_HEIGHT / 2, 0.5f, 0.5f, 0.5f, 0.5f};
+    UndistortedCameraCalibration dst_calibration{
+        DST_WIDTH, DST_HEIGHT, DST_WIDTH / 2, DST_HEIGHT / 2, 0.6f, 0.6f, 0.5f, 0.5f};
+    std::uniform_int_distribution<int> distr(0, 255);
+    vector<uint8_t> y_channel(SRC_WIDTH * SRC_HEIGHT);
+    for (auto& y : y_channel)
+        y = gsl::narrow<uint8_t>(distr(eng));
+    YuvFrame yuv_frame{SRC_WIDTH,
+                       SRC_HEIGHT,
+                       y_channel,
+                       vector<uint8_t>(SRC_WIDTH * SRC_HEIGHT / 4, 100),
+                       vector<uint8_t>(SRC_WIDTH * SRC_HEIGHT / 4, 200)};
+    vector<int32_t> depth_values(SRC_WIDTH * SRC_HEIGHT / 4);
+    for (auto& depth_value : depth_values)
+        depth_value = distr(eng) * 8;
+    Int32Frame depth_frame{SRC_WIDTH / 2, SRC_HEIGHT / 2, depth_values};
+
+    SECTION("Identity")
+    {
+        for (auto sampling_mode :
+             {FrameMapperSamplingMode::Nearest, FrameMapperSamplingMode::Bilinear}) {
+            FrameMapper frame_mapper{src_calibration, src_calibration, sampling_mode};
+            auto mapped_yuv_frame{frame_mapper.mapColorFrame(yuv_frame)};
+            auto mapped_depth_frame{frame_mapper.mapDepthFrame(depth_frame)};
+            REQUIRE(mapped_yuv_frame->y_channel() == yuv_frame.y_channel());
+            REQUIRE(mapped_yuv_frame->u_channel() == yuv_frame.u_channel());
+            REQUIRE(mapped_depth_frame->values() == depth_frame.values());
+        }
+    }
+
+    SECTION("Into matches allocating")
+    {
+        for (auto sampling_mode :
+             {FrameMapperSamplingMode::Nearest, FrameMapperSamplingMode::Bilinear}) {
+            FrameMapper frame_mapper{src_calibration, dst_calibration, sampling_mode};
+            auto mapped_yuv_frame{frame_mapper.mapColorFrame(yuv_frame)};
+            auto mapped_depth_frame{frame_mapper.mapDepthFrame(depth_frame)};
+            YuvFrame mapped_yuv_frame_into{DST_WIDTH,
+                                           DST_HEIGHT,
+                                           vector<uint8_t>(DST_WIDTH * DST_HEIGHT),
+                                           vector<uint8_t>(DST_WIDTH * DST_HEIGHT / 4),
+                                           vector<uint8_t>(DST_WIDTH * DST_HEIGHT / 4)};
+            Int32Frame mapped_depth_frame_into{
+                DST_WIDTH / 2, DST_HEIGHT / 2, vector<int32_t>(DST_WIDTH * DST_HEIGHT / 4)};
+            frame_mapper.mapColorFrameInto(yuv_frame, mapped_yuv_frame_into);
+            frame_mapper.mapDepthFrameInto(depth_frame, mapped_depth_frame_into);
+            REQUIRE(mapped_yuv_frame_into.y_channel() == mapped_yuv_frame->y_channel());
+            REQUIRE(mapped_yuv_frame_into.v_channel() == mapped_yuv_frame->v_channel());
+            REQUIRE(mapped_depth_frame_into.values() == mapped_depth_frame->values());
+            // Blending a constant channel should keep it constant.
+            for (auto u : mapped_yuv_frame->u_channel())
+                REQUIRE((u == 100 || u == 128));
+            REQUIRE_THROWS(frame_mapper.mapDepthFrameInto(depth_frame, depth_frame));
+        }
+    }
+
+    SECTION("Source Frame Size")
+    {
+        FrameMapper frame_mapper{src_calibration, dst_calibration};
+        YuvFrame small_yuv_frame{DST_WIDTH,
+                                 DST_HEIGHT,
+                                 vector<uint8_t>(DST_WIDTH * DST_HEIGHT),
+                                 vector<uint8_t>(DST_WIDTH * DST_HEIGHT / 4),
+                                 vector<uint8_t>(DST_WIDTH * DST_HEIGHT / 4)};
+        Int32Frame small_depth_frame{
+            DST_WIDTH / 2, DST_HEIGHT / 2, vector<int32_t>(DST_WIDTH * DST_HEIGHT / 4)};
+        REQUIRE_THROWS(frame_mapper.mapColorFrame(small_yuv_frame));
+        REQUIRE_THROWS(frame_mapper.mapDepthFrame(small_depth_frame));
+    }
+
+    SECTION("Single Column and Row Source")
+    {
+        // The u and v channels of a 2x2 color frame are a single pixel.
+        UndistortedCameraCalibration tiny_calibration{2, 2, 1, 1, 0.5f, 0.5f, 0.5f, 0.5f};
+        YuvFrame tiny_yuv_frame{
+            2, 2, vector<uint8_t>(4, 50), vector<uint8_t>(1, 100), vector<uint8_t>(1, 200)};
+        Int32Frame tiny_depth_frame{1, 1, vector<int32_t>{1000}};
+        for (auto sampling_mode :
+             {FrameMapperSamplingMode::Nearest, FrameMapperSamplingMode::Bilinear}) {
+            FrameMapper frame_mapper{tiny_calibration, dst_calibration, sampling_mode};
+            auto mapped_yuv_frame{frame_mapper.mapColorFrame(tiny_yuv_frame)};
+            auto mapped_depth_frame{frame_mapper.mapDepthFrame(tiny_depth_frame)};
+            for (auto y : mapped_yuv_frame->y_channel())
+                REQUIRE((y == 50 || y == 0));
+            for (auto u : mapped_yuv_frame->u_channel())
+                REQUIRE((u == 100 || u == 128));
+            for (auto v : mapped_yuv_frame->v_channel())
+                REQUIRE((v == 200 || v == 128));
+            for (auto depth_value : mapped_depth_frame->values())
+                REQUIRE((depth_value == 1000 || depth_value == 0));
+        }
+    }
+}
+
+TEST_CASE("Calibration Cache")
+{
+    UndistortedCameraCalibration calibration{64, 48, 32, 24, 0.5f, 0.5f, 0.5f, 0.5f};
+    UndistortedCameraCalibration other_calibration{64, 48, 32, 24, 0.6f, 0.5f, 0.5f, 0.5f};
+    calibration_cache::clear();
+
+    DirectionTable direction_table{calibration};
+    DirectionTable same_direction_table{UndistortedCameraCalibration{calibration}};
+    DirectionTable other_direction_table{other_calibration};
+    REQUIRE(&direction_table.directions() == &same_direction_table.directions());
+    REQUIRE(&direction_table.directions() != &other_direction_table.directions());
+    for (int row{0}; row < 24; ++row) {
+        for (int col{0}; col < 32; ++col) {
+            glm::vec2 uv{col / 31.0f, row / 23.0f};
+            REQUIRE(direction_table.directions()[col + row * 32] == calibration.getDirection(uv));
+        }
+    }
+
+    // A single column or row is at the left or top.
+    REQUIRE((*calibration_cache::get_directions(calibration, 1, 1))[0] ==
+            calibration.getDirection(glm::vec2{0.0f, 0.0f}));
+
+    auto uvs{calibration_cache::get_uvs(calibration, 32, 24, other_calibration)};
+    REQUIRE(uvs == calibration_cache::get_uvs(calibration, 32, 24, other_calibration));
+    REQUIRE(uvs != calibration_cache::get_uvs(calibration, 16, 12, other_calibration));
+
+    calibration_cache::clear();
+    DirectionTable recomputed_direction_table{calibration};
+    REQUIRE(&recomputed_direction_table.directions() != &direction_table.directions());
+    REQUIRE(recomputed_direction_table.directions() == direction_table.directions());
+
+    // The least recently used tables get evicted, while recently used ones stay.
+    auto directions{calibration_cache::get_directions(calibration, 32, 24)};
+    for (int i{0}; i < 7; ++i)
+        calibration_cache::get_directions(calibration, 16 + i, 12);
+    REQUIRE(calibration_cache::get_directions(calibration, 32, 24) == directions);
+    for (int i{0}; i < 8; ++i)
+        calibration_cache::get_directions(calibration, 8 + i, 6);
+    REQUIRE(calibration_cache::get_directions(calibration, 32, 24) != directions);
+}
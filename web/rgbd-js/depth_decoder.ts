@@ -4,7 +4,8 @@ import { NativeObject } from './native_object';
 
 export enum DepthCodecType {
   RVL = 0,
-  TDC1 = 1
+  TDC1 = 1,
+  RVL_MT = 2
 }
 
 export class NativeDepthDecoder extends NativeObject {